@@ -21,6 +21,7 @@
 #include "json.hpp"
 #include "networking_client.hpp"
 #include "networking_sender.hpp"
+#include "relay_table.hpp"
 
 namespace COGNA{
 
@@ -59,13 +60,28 @@ public:
     std::vector<NeuralNetwork*> get_network_list();
     std::vector<utils::networking_client*> get_client_list();
     std::vector<utils::networking_sender*> get_sender_list();
+    utils::relay_table* get_relay_table();
     int get_frequency();
+    int get_io_threads();
+    int get_tick_mode();
+    int get_min_tick_interval();
+    int get_ticks_per_request();
 
 private:
     std::vector<NeuralNetwork*> _network_list;
     std::vector<utils::networking_client*> _client_list;
     std::vector<utils::networking_sender*> _sender_list;
+    utils::relay_table *_relay_table;   // Links from input nodes to output nodes
     int _frequency;
+    int _neuron_ordering;
+    int _receive_policy;
+    int _io_threads;                    // 0 follows the receive_queues of the nodes
+    bool _is_tracing_latency;
+    int _tick_mode;
+    int _min_tick_interval;             // In microseconds
+    int _ticks_per_request;
+    int _max_datagram_size;             // In bytes, 0 for the largest UDP payload
+    int _receive_buffer_size;           // In bytes
 
     nlohmann::json _neuron_types;
     std::vector<nlohmann::json> _presynaptic_connections;
@@ -279,6 +295,17 @@ private:
      */
     int connect_subnetworks();
 
+    /**
+     * @brief Parses a number which the config can give as number or as string.
+     *
+     * @param json      The json object holding the number.
+     * @param key       The name of the number in the json object.
+     * @param invalid   Stored if the key is missing or its value is no number.
+     * @param number    Receives the parsed number.
+     */
+    template<typename T>
+    static void parse_number(const nlohmann::json &json, const std::string &key, T invalid, T *number);
+
     /**
      * @brief Loads a certain parameter used by neurons from a json.
      *
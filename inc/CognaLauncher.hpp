@@ -14,6 +14,11 @@
 #include "NeuralNetwork.hpp"
 #include "networking_client.hpp"
 #include "networking_sender.hpp"
+#include "io_reactor.hpp"
+#include "batch_sender.hpp"
+#include "relay_table.hpp"
+#include "input_signal.hpp"
+#include "Constants.hpp"
 #include <vector>
 #include <thread>
 #include <condition_variable>
@@ -24,11 +29,27 @@ class CognaLauncher{
 public:
     /**
      * Constructor. Initializes the compiled COGNA cluster.
+     *
+     * @param io_threads            The number of threads receiving the messages of all networking clients.
+     * @param tick_mode             TICK_MODE_PERIODIC ticks with the frequency. TICK_MODE_INPUT additionally ticks
+     *                              as soon as a new input message arrives. TICK_MODE_REQUEST only ticks when a new
+     *                              input message arrives.
+     * @param min_tick_interval     The shortest time between the starts of two ticks in microseconds, for input
+     *                              triggered ticks.
+     * @param relay_table           The links from input nodes to output nodes. Freed by the launcher. nullptr if none.
+     * @param ticks_per_request     The number of ticks run back to back for every request in TICK_MODE_REQUEST,
+     *                              at least the number of networks or hops between its input and the outputs.
+     *                              The outputs of these ticks echo the sequence number of the request as "reply".
      */
     CognaLauncher(std::vector<NeuralNetwork*> network_list,
                   std::vector<utils::networking_client*> client_list,
                   std::vector<utils::networking_sender*> sender_list,
-                  int frequency);
+                  int frequency,
+                  int io_threads=1,
+                  int tick_mode=TICK_MODE_PERIODIC,
+                  int min_tick_interval=0,
+                  utils::relay_table *relay_table=nullptr,
+                  int ticks_per_request=1);
 
     /**
      * Destructor. Frees all memory used by the networks in the cluster.
@@ -53,18 +74,47 @@ private:
     std::vector<NeuralNetwork*> _network_list;
     std::vector<utils::networking_client*> _client_list;
     std::vector<utils::networking_sender*> _sender_list;
-    std::vector<std::thread*> _client_worker_list;
+    utils::relay_table *_relay_table;
+    utils::io_reactor *_reactor;
+    utils::batch_sender *_batch_sender;
     std::vector<std::thread*> _cogna_worker_list;
     int _frequency;
+    int _io_threads;
+    int _tick_mode;
+    int _min_tick_interval;
+    int _ticks_per_request;
+    int _request_ticks;         // Ticks left to run for the current request
+    utils::input_signal _input_signal;
+    uint32_t _seen_input;
     unsigned long long *_curr_cluster_step;
 
     /**
-     * @brief Creates all threads working on UDP networking.
+     * @brief Starts the io reactor receiving the messages of all networking clients
+     *        and opens the sockets sending the payloads of all networking senders.
      *
      * @return  Error code.
      */
     int create_networking_workers();
 
+    /**
+     * @brief Lets all outputs echo the sequence number of the request stored in this tick.
+     *
+     * Outputs stop echoing if the request has no sequence number.
+     */
+    void echo_request_sequence();
+
+    /**
+     * @brief Waits until the next tick is due according to the tick mode.
+     *
+     * @param tick_start    The start of the finished tick in microseconds.
+     */
+    void wait_for_next_tick(long tick_start);
+
+    /**
+     * @brief Prints the input to output latencies recorded for every output channel.
+     */
+    void print_latencies();
+
     /**
      * @brief Creates all threads working on different COGNA networks.
      *
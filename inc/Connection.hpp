@@ -24,10 +24,26 @@
 #include <cstdint>
 #include <cstdlib>
 
+#include "WeightStorage.hpp"
+
 namespace COGNA{
     class Neuron;
     class NeuronParameterHandler;
     class ConnectionParameterHandler;
+    class Connection;
+
+    /**
+     * @brief A learning step of a connection recorded while firing and applied later in the plasticity phase.
+     *
+     * Stores everything learning needs from the moment of firing, because the activation of the
+     * firing neuron is already cleared when the plasticity phase runs.
+     *
+     */
+    struct PlasticityEvent{
+        COGNA::Connection *connection;    /**< The connection which learns */
+        float activation;                 /**< Activation of the firing neuron or of the conditioning neuron */
+        int conditioning_type;            /**< Activation type of the conditioning connection. NONDIRECTIONAL if not conditioned */
+    };
 
     /**
      * @brief Class for connections between entities in the network.
@@ -35,12 +51,23 @@ namespace COGNA{
      */
     class Connection{
     public:
-        int _id;
-        int _json_id;
-        static int s_max_id;
+        /*
+         * Fields read while firing come first, so the firing loop mostly touches the first cache line
+         * of a connection. Everything below them is only used while learning or building the network.
+         */
         COGNA::Neuron* next_neuron;
-        COGNA::Connection* next_connection;
         COGNA::Neuron* prev_neuron;
+        COGNA::Connection* next_connection;
+
+        COGNA::weight_t short_weight;       /**< Weight of this connection changing for short term learning. This one is directly used */
+        COGNA::weight_t presynaptic_potential;   /**< Defines the additional activation by presynaptic connection */
+
+        int8_t activation_type;        /**< Copy of _parameter->activation_type for firing. Set by cache_parameter() */
+        int8_t activation_function;    /**< Copy of _parameter->activation_function for firing. Set by cache_parameter() */
+        int16_t transmitter_type;      /**< Copy of _parameter->transmitter_type for firing. Set by cache_parameter() */
+        float fire_threshold;          /**< Copy of the activation threshold of prev_neuron for firing. Set by cache_parameter() */
+
+        int64_t last_presynaptic_activated_step;  /**< Stores the global network step when this connection was last presynaptic activated */
 
         /**
          * @brief Contains the parameters specifiying connection behavior.
@@ -48,13 +75,14 @@ namespace COGNA{
          */
         COGNA::ConnectionParameterHandler *_parameter;
 
-        float base_weight;        /**< Base weight where learning processes always slowly return to */
-        float short_weight;       /**< Weight of this connection changing for short term learning. This one is directly used */
-        float long_weight;        /**< Weight of this connection changing for long term learning */
-        float long_learning_weight; /**< Factor that controls the learning processes of long_weight */
+        int _id;
+        int _json_id;
+        static int s_max_id;
 
-        float presynaptic_potential;   /**< Defines the additional activation by presynaptic connection */
-        int64_t last_presynaptic_activated_step;  /**< Stores the global network step when this connection was last presynaptic activated */
+        COGNA::weight_t base_weight;        /**< Base weight where learning processes always slowly return to */
+        COGNA::weight_t long_weight;        /**< Weight of this connection changing for long term learning */
+        COGNA::weight_t long_learning_weight; /**< Factor that controls the learning processes of long_weight */
+        uint16_t plasticity_events;   /**< Learning steps recorded for this connection in the current step. Used by the plasticity phase of the network */
 
         int64_t last_activated_step;  /**< Stores the global network step when this connection was last activated */
 
@@ -75,6 +103,15 @@ namespace COGNA{
          */
         ~Connection();
 
+        /**
+         * @brief Copies the parameters used while firing from @c #_parameter into the connection itself.
+         *
+         * Also copies the activation threshold of @c #prev_neuron. Must be called again whenever one of
+         * those parameters is changed.
+         *
+         */
+        void cache_parameter();
+
         /**
          * @brief A wrapper including all learning functions of a connection
          *
@@ -87,6 +124,34 @@ namespace COGNA{
          */
         void basic_learning(int64_t network_step, Connection *conditioning_con=NULL);
 
+        /**
+         * @brief Applies all learning functions based on a recorded activation.
+         *
+         * Does the same as basic_learning(), but does not read the activation from the
+         * neurons. Used by the deferred plasticity phase of the network.
+         *
+         * @param network_step         The current step/tick count of the network.
+         * @param activation           The activation of the firing neuron or of the conditioning neuron.
+         * @param conditioning_type    The activation type of the conditioning connection. NONDIRECTIONAL if not conditioned.
+         *
+         */
+        void apply_learning(int64_t network_step, float activation, int conditioning_type);
+
+        /**
+         * @brief Applies all learning steps of this connection recorded in the same step at once.
+         *
+         * The decays depending on the steps since the last activation are calculated once, followed by
+         * the habituation and sensitization of every event in the recorded order. Applying the events one
+         * by one with apply_learning() gives the same weights, as their decays cover zero steps after the first
+         * and do not change anything for curvatures above 0.
+         *
+         * @param network_step    The current step/tick count of the network.
+         * @param events          The learning steps of this connection.
+         * @param event_number    The number of learning steps.
+         *
+         */
+        void apply_learning_batch(int64_t network_step, const PlasticityEvent *events, unsigned int event_number);
+
         /**
          * @brief Calculates the activation of a neuron fired at in this step.
          *
@@ -94,15 +159,20 @@ namespace COGNA{
          * @param transmitter_weights    A vector containing the weights all neurotransmitters in the network
          *
          */
-        void activate_next_neuron(int64_t network_step, std::vector<float> transmitter_weights);
+        void activate_next_neuron(int64_t network_step, const std::vector<float> &transmitter_weights);
 
         /**
          * @brief Calculates the presynaptic activation of a certain connection fired at.
          *
+         * Does not let the connection fired at learn directly. The caller records the conditioned
+         * learning step for the plasticity phase instead.
+         *
          * @param network_step    The current step/tick count of the network.
          *
+         * @return                true if the connection fired at should learn conditioned by this connection.
+         *
          */
-        void activate_next_connection(int64_t network_step);
+        bool activate_next_connection(int64_t network_step);
 
         private:
             /**
@@ -135,11 +205,12 @@ namespace COGNA{
              * Can happen directly by weak activation of this connection, or by
              * a presynaptic connection, which acts as a conditioning input.
              *
-             * @param network_step        The current step/tick count of the network.
-             * @param conditioning_con    Another connection which is connected to this one.
+             * @param network_step         The current step/tick count of the network.
+             * @param activation           The activation of the firing neuron or of the conditioning neuron.
+             * @param conditioning_type    The activation type of the conditioning connection. NONDIRECTIONAL if not conditioned.
              *
              */
-            void habituate(int64_t network_step, Connection *conditioning_con=NULL);
+            void habituate(int64_t network_step, float activation, int conditioning_type);
 
             /**
              * @brief Calculates sansitization of connection if strongly activated.
@@ -147,11 +218,12 @@ namespace COGNA{
              * Can happen directly by strong activation of this connection, or by
              * a presynaptic connection, which acts as a conditioning input.
              *
-             * @param network_step        The current step/tick count of the network.
-             * @param conditioning_con    Another connection which is connected to this one.
+             * @param network_step         The current step/tick count of the network.
+             * @param activation           The activation of the firing neuron or of the conditioning neuron.
+             * @param conditioning_type    The activation type of the conditioning connection. NONDIRECTIONAL if not conditioned.
              *
              */
-            void sensitize(int64_t network_step, Connection *conditioning_con=NULL);
+            void sensitize(int64_t network_step, float activation, int conditioning_type);
 
             /**
              * @brief Calculates dehabituation of connection after time.
@@ -61,6 +61,7 @@ namespace COGNA{
     const int LEARNING_HABITUATION = 2;
     const int LEARNING_SENSITIZATION = 3;
     const int LEARNING_HABISENS = 4;
+    const int LEARNING_TYPE_NUMBER = 4;
 
     const int POSITIVE_INFLUENCE = 1;
     const int NEGATIVE_INFLUENCE = -1;
@@ -73,6 +74,20 @@ namespace COGNA{
 
     const int NODE_TARGET_NEURON = 1;
     const int NODE_TARGET_NODE = 2;
+
+    const int NEURON_ORDERING_NONE = 0;
+    const int NEURON_ORDERING_BFS = 1;
+    const int NEURON_ORDERING_RCM = 2;
+    const int NEURON_ORDERING_DEGREE = 3;
+
+    const int TICK_MODE_PERIODIC = 0;
+    const int TICK_MODE_INPUT = 1;
+    const int TICK_MODE_REQUEST = 2;
+
+    const int RECEIVE_BUFFER_MIN_SIZE = 1024;
+    const int RECEIVE_BUFFER_MAX_SIZE = 65536;
+
+    const int RECEIVE_QUEUES_MAX = 64;
 }
 
 #endif /* INCLUDE_CONSTANTS_HPP */
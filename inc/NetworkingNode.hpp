@@ -6,6 +6,10 @@
  *
  * A node can either be listening on a UDP port or send to a UDP ip/port.
  * What it does is determined by one of two function calls.
+ * An input node with a width above 1 receives a vector channel and activates a population
+ * of neurons, one per element, instead of its targets.
+ * Links from an input node to output nodes are not executed by the node, but compiled into
+ * the routes of a relay_table.
  *
  * @date 2021-05-31
  *
@@ -17,8 +21,12 @@
 #include "Neuron.hpp"
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include "networking_client.hpp"
 #include "networking_sender.hpp"
+#include "binary_protocol.hpp"
+#include "channel_aggregator.hpp"
+#include "relay_table.hpp"
 
 namespace COGNA{
 
@@ -30,10 +38,16 @@ public:
     /**
      * @brief Constructor. Initializes a networking input/output node.
      *
-     * @param id        The ID of the networking node.
-     * @param channel   The channel the node listens to or sends on.
+     * @param id             The ID of the networking node.
+     * @param channel        The channel the node listens to or sends on.
+     * @param format         The format the channel is sent in. FORMAT_JSON or one of the binary formats.
+     * @param channel_index  The index of the channel in binary messages.
+     * @param aggregation    How an input node combines the values received during one tick. AGGREGATE_LAST
+     *                       keeps the newest one.
+     * @param width          The number of values of the channel of an input node. 1 for a scalar channel.
      */
-    NetworkingNode(int id, std::string channel);
+    NetworkingNode(int id, std::string channel, int format=utils::FORMAT_JSON, int channel_index=0,
+                   int aggregation=utils::AGGREGATE_LAST, int width=1);
 
     /**
      * @brief Destructor. Empty.
@@ -50,17 +64,26 @@ public:
     int add_target(Neuron *target);
 
     /**
-     * @brief Adds a target node the node either listens to or sends to.
+     * @brief Sets the neurons activated by the elements of the vector channel of this (input) node.
      *
-     * @param target    The target node of the node.
+     * @param population    One neuron per element of the channel.
      *
-     * @return          Error code.
+     * @return              Error code.
      */
-    int add_target(NetworkingNode *target);
+    int set_population(const std::vector<Neuron*> &population);
+
+    /**
+     * @brief Replaces target neurons which have been moved to another place in memory.
+     *
+     * @param relocated    Maps the old address of every moved neuron to its new address.
+     */
+    void relink_targets(const std::unordered_map<Neuron*, Neuron*> &relocated);
 
     /**
      * @brief Sets up a client for the node. Turns the node into an input node listens to a port.
      *
+     * Registers the channel of the node at the client.
+     *
      * @param client    A pointer to the UDP client of the node.
      *
      * @return          Error code.
@@ -70,6 +93,8 @@ public:
     /**
      * @brief Sets up a sender for the node. Turns the node into an output node sendint to an ip/port.
      *
+     * Registers the channel of the node at the sender.
+     *
      * @param sender    A pointer to the UDP sender of the node.
      *
      * @return          Error code.
@@ -77,11 +102,48 @@ public:
     int setup_sender(utils::networking_sender *sender);
 
     /**
-     * @brief Directly forwards the information of this (input) node to another output node if connected.
+     * @brief Sets when the channel of this (input) node is forwarded to linked output nodes.
+     *
+     * @param relay_mode    RELAY_TICK or RELAY_IMMEDIATE.
+     */
+    void set_relay_mode(int relay_mode);
+
+    /**
+     * @brief Reads the value of the channel of this (input) node from the last stored message.
+     *
+     * @return  The received value. 0 if the channel was not part of the message.
+     */
+    float received_value();
+
+    /**
+     * @brief Returns when the message containing the received value arrived.
+     *
+     * @return  The arrival in nanoseconds since epoch. 0 if the channel was not part of the message.
+     */
+    int64_t received_arrival();
+
+    /**
+     * @brief Reads the values of the vector channel of this (input) node from the last stored message.
+     *
+     * @return  One value per element. 0 for elements not part of the message.
+     */
+    const float* received_values();
+
+    /**
+     * @brief Returns when the messages containing the received values arrived, one arrival per element.
+     */
+    const int64_t* received_arrivals();
+
+    /**
+     * @brief Adds a value to the channel of this (output) node in the payload of its sender.
+     *
+     * Writes into a buffer of the sender owned by this node, so it needs no lock.
      *
-     * @param injected_activation   The activation which should be forwarded.
+     * @param value     The value to add.
+     * @param arrival   The arrival of the newest input influencing the value in nanoseconds since epoch.
+     *                  0 if not traced.
      */
-    void remote_activate_senders(float injected_activation);
+    void add_sent_data(float value, int64_t arrival=0);
 
     /**
      * @brief Getters for certain private member variables.
@@ -89,14 +151,28 @@ public:
     int id();
     int role();
     std::string channel();
-    std::vector<Neuron*> targets();
+    int format();
+    int channel_index();
+    int aggregation();
+    int width();
+    int slot();
+    int relay_mode();
+    const std::vector<Neuron*>& targets();
+    const std::vector<Neuron*>& population();
 
 private:
     int _id;
     int _role;
     std::string _channel;
+    int _format;
+    int _channel_index;
+    int _aggregation;
+    int _width;
+    int _relay_mode;
+    int _slot;
+    int _writer;    // Output nodes add their values through an own buffer of the sender, which needs no lock
     std::vector<Neuron*> _target_list;
-    std::vector<NetworkingNode*> _output_target_list;
+    std::vector<Neuron*> _population;
 };
 
 } //namespace COGNA
@@ -19,9 +19,14 @@
 #include "NetworkingNode.hpp"
 #include "networking_client.hpp"
 #include "networking_sender.hpp"
+#include "RandomGenerator.hpp"
+#include "Constants.hpp"
 #include "json.hpp"
 #include <string>
+#include <queue>
+#include <functional>
 #include <condition_variable>
+#include <atomic>
 
 namespace COGNA{
 
@@ -35,7 +40,7 @@ class NeuralNetwork{
 public:
     int _id;
     std::string _network_name;
-    bool _is_finished;
+    std::atomic<bool> _is_finished;                         // Set by the worker after a step. Publishes its sent data to the launcher.
     std::vector<COGNA::Neuron*> _neurons;                   // All neurons contained in the network
     std::vector<COGNA::Connection*> _connections;
     std::vector<COGNA::Connection*> _curr_connections;      // All connections which will be activated in this step
@@ -71,8 +76,19 @@ public:
      */
     int add_neuron(float threshold);
 
-    int add_extern_input_node(int node_id, utils::networking_client *client, std::string channel);
-    int add_extern_output_node(int node_id, utils::networking_sender *sender, std::string channel);
+    /**
+     * @brief Adds a node receiving a channel from a client.
+     *
+     * A node with a width above 1 receives a vector channel. Its elements activate the neurons
+     * from population_start on, one neuron per element.
+     *
+     * @return    Error code. SUCCESS_CODE if everything went right, ERROR_CODE if something went wrong.
+     */
+    int add_extern_input_node(int node_id, utils::networking_client *client, std::string channel,
+                              int format=utils::FORMAT_JSON, int channel_index=0,
+                              int aggregation=utils::AGGREGATE_LAST, int width=1, int population_start=0);
+    int add_extern_output_node(int node_id, utils::networking_sender *sender, std::string channel,
+                               int format=utils::FORMAT_JSON, int channel_index=0);
 
     /**
      * @brief Sets a neuron to have an influence on a certain neurotransmitter if it fires.
@@ -102,7 +118,7 @@ public:
      * @brief Sets a neuron to autonomously fire at random intervals.
      *
      * @param neuron_id           The ID of the neuron which should fire randomly
-     * @param chance              The chance of firing in each step. 1 = 1/100000000.
+     * @param chance              The chance of firing in each step. 1 = 1/MAX_CHANCE.
      * @param activation_value    The activation with which the neuron randomly fires
      *
      * @return                    Error code. SUCCESS_CODE if everything went right, ERROR_CODE if something went wrong.
@@ -221,10 +237,32 @@ public:
     int init_activation(int target_neuron,
                         float activation);
 
+    /**
+     * @brief Initializes a certain activation niveau into a neuron without looking it up.
+     *
+     * @param target_neuron    The neuron to initialize activation in.
+     * @param activation       The value of activation to initialize into the neuron.
+     */
+    void init_activation(Neuron *target_neuron,
+                         float activation);
+
+    /**
+     * @brief Initializes the activations of a population of neurons at once.
+     *
+     * Like init_activation() for every neuron with a positive value, but without looking up the neurons.
+     *
+     * @param population    The neurons to activate.
+     * @param values        One activation per neuron.
+     * @param arrivals      One input arrival per neuron. nullptr if not traced.
+     */
+    void init_population_activation(const std::vector<Neuron*> &population,
+                                    const float *values,
+                                    const int64_t *arrivals);
+
     /**
      * @brief Must be called before the network loop starts to clean some things up.
      *
-     * Sets random number seed and connects al loose neurons to the Null-Neuron.
+     * Schedules the first firing of all random neurons and connects al loose neurons to the Null-Neuron.
      * Otherwise those could never be called by the network.
      *
      * @return    Error code. SUCCESS_CODE if everything went right, ERROR_CODE if something went wrong.
@@ -232,6 +270,24 @@ public:
      */
     int setup_network();
 
+    /**
+     * @brief Renumbers the neurons of the network so that connected neurons get neighbouring IDs.
+     *
+     * The neurons and their connections are also moved in memory in the new order, so that
+     * neurons activated after each other are close to each other while propagating activation.
+     * Must be called after all connections of the cluster are built and before setup_network().
+     * The IDs of the network file are kept in Neuron::_json_id. All functions taking a neuron ID keep
+     * taking the IDs of the network file and translate them into the new IDs.
+     *
+     * @param ordering        NEURON_ORDERING_NONE, NEURON_ORDERING_BFS, NEURON_ORDERING_RCM (reverse Cuthill-McKee)
+     *                        or NEURON_ORDERING_DEGREE (descending number of connections).
+     * @param network_list    All networks of the cluster. Their pointers to the moved neurons are updated.
+     *
+     * @return                Error code. SUCCESS_CODE if everything went right, ERROR_CODE if something went wrong.
+     *
+     */
+    int reorder_neurons(int ordering, std::vector<NeuralNetwork*> network_list=std::vector<NeuralNetwork*>());
+
     /**
      * @brief This function calls every necessary function to do one step of the network.
      *
@@ -299,12 +355,56 @@ public:
      */
     float get_transmitter_weight(int transmitter_id);
 
+    /**
+     * @brief Reseeds the random generator of the network.
+     *
+     * Must be called before setup_network() to have an effect on the random neuron schedule.
+     * Networks are seeded from the clock and their ID by default.
+     *
+     * @param seed    The new seed.
+     */
+    void set_random_seed(uint64_t seed);
+
+    /**
+     * @brief Enables tracing the arrival of inputs through the network to the outputs they influence.
+     *
+     * Every neuron remembers the arrival of the newest input its activation stems from and hands it on
+     * when firing. Output nodes pass it to their sender, which records the input to output latency.
+     *
+     * @param is_enabled    True to trace the latency.
+     */
+    void set_latency_tracing(bool is_enabled);
+
+    /**
+     * @brief Decides if connections learn in the plasticity phase after the outputs are stored, which is the default.
+     *
+     * Otherwise every learning step is applied while firing, so a weight change already influences the
+     * activation the connection sends in the same step.
+     *
+     * @param is_enabled    True to defer learning to the plasticity phase.
+     */
+    void set_deferred_plasticity(bool is_enabled);
+
     void receive_data();
 
     private:
-        std::vector<COGNA::Neuron*> _random_neurons;            // All neurons in the network which can activate randomly
+        // Step of the next random firing and the ID of the neuron firing, ordered by the earliest step.
+        std::priority_queue<std::pair<int64_t, int>,
+                            std::vector<std::pair<int64_t, int>>,
+                            std::greater<std::pair<int64_t, int>>> _random_schedule;
+        COGNA::RandomGenerator _random_generator;
+        // Learning steps recorded while firing and the connections they belong to in the order of their first step,
+        // both indexed by learning type. Applied per connection in the plasticity phase.
+        std::vector<COGNA::PlasticityEvent> _plasticity_events[COGNA::LEARNING_TYPE_NUMBER];
+        std::vector<COGNA::Connection*> _plasticity_connections[COGNA::LEARNING_TYPE_NUMBER];
+        // Events of one learning type regrouped by connection while processing them.
+        std::vector<COGNA::PlasticityEvent> _plasticity_batches;
         std::vector<float> _transmitter_weights;
         int64_t _network_step_counter;
+        bool _is_tracing_latency;
+        bool _is_deferring_plasticity;
+        // Current ID of every neuron, indexed by its ID in the network file. Changes when neurons are reordered.
+        std::vector<int> _neuron_ids;
         static int m_max_id;
 
         /**
@@ -338,17 +438,85 @@ public:
         void transmitter_backfall();
 
         /**
-         * @brief Decides for each neuron which can activate randomly if it should fire.
+         * @brief Translates the ID of a neuron in the network file into its current ID.
+         *
+         * @param json_id    The ID of the neuron in the network file.
+         *
+         * @return           The current ID of the neuron, -1 if there is no neuron with this ID.
+         *
+         */
+        int find_neuron_id(int json_id);
+
+        /**
+         * @brief Calculates the new order of the neurons for reorder_neurons().
+         *
+         * Only connections between neurons of this network are taken into account. The Null-Neuron is left out.
+         *
+         * @param ordering    The ordering to calculate.
+         *
+         * @return            The old IDs of all neurons except the Null-Neuron in their new order.
+         *
+         */
+        std::vector<int> find_neuron_order(int ordering);
+
+        /**
+         * @brief Moves the neurons and their connections in memory into a new order and updates all pointers to them.
+         *
+         * @param order           The old IDs of all neurons except the Null-Neuron in their new order.
+         * @param network_list    All networks of the cluster.
+         *
+         */
+        void relocate_neurons(const std::vector<int> &order, std::vector<NeuralNetwork*> network_list);
+
+        /**
+         * @brief Fires every random neuron scheduled for the current step.
+         *
+         * The steps between two firings of a neuron are geometrically distributed, so instead of
+         * testing every random neuron in every step, the next firing step is drawn directly.
+         * The cost per step therefore only depends on the number of firings.
          *
          */
         void activate_random_neurons();
 
         /**
-         * @brief Contains the basic learning of the connections and the logic if a neuron or a connection is activated.
+         * @brief Draws the next firing step of a random neuron and stores it in the schedule.
+         *
+         * @param n    The random neuron to schedule.
+         *
+         */
+        void schedule_random_neuron(COGNA::Neuron *n);
+
+        /**
+         * @brief Contains the logic if a neuron or a connection is activated.
+         *
+         * Unless learning is not deferred, connections do not learn directly. Every learning step is recorded
+         * as a plasticity event together with the activation it is based on and is applied in process_plasticity().
          *
          */
         void activate_next_entities();
 
+        /**
+         * @brief Records a learning step for the plasticity phase, or applies it at once if learning is not deferred.
+         *
+         * @param connection           The connection which learns.
+         * @param activation           The activation of the firing neuron or of the conditioning neuron.
+         * @param conditioning_type    The activation type of the conditioning connection. NONDIRECTIONAL if not conditioned.
+         *
+         */
+        void add_plasticity_event(COGNA::Connection *connection, float activation, int conditioning_type);
+
+        /**
+         * @brief Applies all learning steps recorded in the current step.
+         *
+         * Runs after the outputs of the step are stored, so learning is kept off the path between
+         * input and output. The events are processed one learning type after the other. Within a type,
+         * the events are regrouped by connection in linear time, keeping their recorded order, and all
+         * events of a connection are applied in one batch, which loads its parameters once and calculates
+         * its decays once. Weight changes therefore become visible with the next firing of a connection.
+         *
+         */
+        void process_plasticity();
+
         /**
          * @brief Stores the connections of all activated neurons, if their activation is higher than their threshold in a vector.
          *
@@ -26,6 +26,7 @@ namespace COGNA{
 	class Neuron{
 		public:
 	        int _id;
+			int _json_id;                          /**< ID of the neuron in the network file. Stays the same when neurons are reordered */
 			int _network_id;
 	        static int s_max_id;
 			float _next_activation;				   /**< New activation level the neuron got in this step */
@@ -33,6 +34,7 @@ namespace COGNA{
 	        int64_t _last_activated_step;          /**< Network step count, when neuron was last activated */
 	        bool _was_activated;                   /**< Indicates if neuron was activated last time or this time */
 	        int _last_fired_step;                  /**< Step when neuron last fired */
+	        int64_t _input_arrival;                /**< Arrival of the newest traced input the activation stems from, 0 if none */
 
 	        COGNA::NeuronParameterHandler *_parameter;
 
@@ -121,7 +123,7 @@ namespace COGNA{
 			/**
 			 * @brief Sets the neuron to autonomously fire at random intervals.
 			 *
-			 * @param chance              The chance of firing in each step. 1 = 1/100000000.
+			 * @param chance              The chance of firing in each step. 1 = 1/MAX_CHANCE.
 			 * @param activation_value    The activation with which the neuron randomly fires
 			 *
 			 */
@@ -131,7 +133,8 @@ namespace COGNA{
 			 * @brief Calculates the backfall of neuron activation when neuron does not fire.
 			 *
 			 * Only calculates a backfall, if the activation level of the neuron
-			 * is lower than its threshold, but larger than 0.
+			 * is lower than its threshold, but larger than 0. Drops the input arrival
+			 * once the activation has fallen back to its minimum.
 			 *
 			 * @param network_step    The current step/tick count of the network
 			 *
@@ -141,6 +144,8 @@ namespace COGNA{
 			/**
 			 * @param Sets the activation level of the neuron to 0, if it did fire
 			 *
+			 * Drops the input arrival whenever the activation ends at its minimum.
+			 *
 			 * @param network_step    The current step/tick count of the network
 			 *
 			 */
@@ -0,0 +1,74 @@
+/**
+ * @file RandomGenerator.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief A small and fast pseudo random number generator owned by every network.
+ *
+ * Implements xoshiro256** seeded by splitmix64. Every network owns its own
+ * instance, so network workers never share generator state and the global
+ * random() state of the process is left untouched.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef INCLUDE_RANDOMGENERATOR_HPP
+#define INCLUDE_RANDOMGENERATOR_HPP
+
+#include <cstdint>
+
+namespace COGNA{
+
+/**
+ * @brief Seedable xoshiro256** generator with helpers for uniform and geometric sampling.
+ *
+ */
+class RandomGenerator{
+public:
+    /**
+     * @brief Initializes the generator with a certain seed.
+     *
+     * @param seed    The seed of the generator. Equal seeds produce equal sequences.
+     */
+    RandomGenerator(uint64_t seed=0);
+
+    /**
+     * @brief Resets the internal state based on a new seed.
+     *
+     * @param seed    The new seed of the generator.
+     */
+    void seed(uint64_t seed);
+
+    /**
+     * @brief Returns the next 64 bit random number.
+     *
+     * @return    A uniformly distributed 64 bit number.
+     */
+    uint64_t next();
+
+    /**
+     * @brief Returns a uniformly distributed number in the interval [0;1[.
+     *
+     * @return    The random number.
+     */
+    double next_double();
+
+    /**
+     * @brief Draws the number of trials until the first success of a bernoulli experiment.
+     *
+     * Used to skip directly to the next step a random neuron fires in, instead of
+     * rolling a dice for every neuron in every step.
+     *
+     * @param probability    The chance of success of a single trial. Must be larger than 0.
+     *
+     * @return               The number of trials until the first success. Always at least 1.
+     */
+    int64_t next_geometric(double probability);
+
+private:
+    uint64_t _state[4];
+};
+
+} //namespace COGNA
+
+#endif //INCLUDE_RANDOMGENERATOR_HPP
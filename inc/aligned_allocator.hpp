@@ -0,0 +1,65 @@
+/**
+ * @file aligned_allocator.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Allocates containers of over-aligned types.
+ *
+ * Until C++17, std::allocator only guarantees the alignment of fundamental types, so the elements
+ * of a std::vector of a type declared with alignas(64) may still share cache lines. This allocator
+ * honors the alignment of the element type.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef ALIGNED_ALLOCATOR_HPP
+#define ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace utils{
+
+template<typename T>
+class aligned_allocator{
+public:
+	typedef T value_type;
+
+	template<typename U>
+	struct rebind{
+		typedef aligned_allocator<U> other;
+	};
+
+	aligned_allocator(){}
+
+	template<typename U>
+	aligned_allocator(const aligned_allocator<U>&){}
+
+	T* allocate(size_t number){
+		size_t alignment = alignof(T) < sizeof(void*) ? sizeof(void*) : alignof(T);
+		void *memory = nullptr;
+		if(posix_memalign(&memory, alignment, number * sizeof(T)) != 0){
+			throw std::bad_alloc();
+		}
+		return (T*)memory;
+	}
+
+	void deallocate(T *memory, size_t){
+		free(memory);
+	}
+};
+
+template<typename T, typename U>
+bool operator==(const aligned_allocator<T>&, const aligned_allocator<U>&){
+	return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const aligned_allocator<T>&, const aligned_allocator<U>&){
+	return false;
+}
+
+} //namespace utils
+
+#endif //ALIGNED_ALLOCATOR_HPP
@@ -0,0 +1,140 @@
+/**
+ * @file batch_sender.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Sends the payloads of many networking senders with a single system call.
+ *
+ * Every sender serializes its payload into its own reusable buffer, all with the same
+ * timestamp. The datagrams are then handed to the kernel with one sendmmsg() per address
+ * family through non-blocking sockets owned by the batch sender. If the socket buffer is
+ * full, the remaining datagrams are dropped instead of stalling the tick, and counted.
+ * Senders in delta mode without changes send nothing. A sender with several destinations adds one
+ * entry per destination, all pointing to its one serialized buffer.
+ * Senders writing into a shared memory ring need no socket and write their payloads directly.
+ * Payloads larger than the maximum datagram size of their sender are split into frames. If the
+ * kernel supports UDP segmentation offload (UDP_SEGMENT), consecutive frames are handed over as
+ * one large buffer, which the kernel splits into datagrams.
+ * Senders towards Unix domain sockets are sent through a third socket, without segmentation offload.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef BATCH_SENDER_HPP
+#define BATCH_SENDER_HPP
+
+#include <vector>
+#include <sys/socket.h>
+#include "networking_sender.hpp"
+
+namespace utils{
+
+class batch_sender{
+public:
+	/**
+	 * @brief Creates the batch sender. No socket is opened yet.
+	 *
+	 * @param senders	The senders whose payloads are sent.
+	 */
+	batch_sender(std::vector<networking_sender*> senders);
+
+	/**
+	 * @brief Closes the sockets.
+	 */
+	~batch_sender();
+
+	/**
+	 * @brief Opens one non-blocking socket for every address family used by the senders.
+	 *
+	 * @return	0 on success, -1 if a socket could not be opened.
+	 */
+	int open_sockets();
+
+	/**
+	 * @brief Serializes and sends the payloads of all senders. Their payloads are cleared afterwards.
+	 *
+	 * @return	The number of datagrams handed to the kernel.
+	 */
+	int flush();
+
+	/**
+	 * @brief Returns true if frames are sent with UDP segmentation offload through the socket of the address family.
+	 */
+	bool is_segmenting(int family);
+
+	/**
+	 * @brief Returns the number of datagrams handed to the kernel or written into shared memory so far.
+	 */
+	unsigned long long get_sent();
+
+	/**
+	 * @brief Returns the number of datagrams which could not be sent so far.
+	 */
+	unsigned long long get_dropped();
+
+	/**
+	 * @brief Returns the number of dropped datagrams, which were dropped because the socket buffer was full.
+	 */
+	unsigned long long get_would_block();
+
+private:
+	std::vector<networking_sender*> _senders;	// IPv4 destinations first, followed by IPv6 and Unix destinations
+	unsigned int _ipv4_number;
+	unsigned int _ip_number;				// The number of IPv4 and IPv6 senders
+	std::vector<networking_sender*> _local_senders;
+	std::vector<struct mmsghdr> _batch;		// The headers of the entries sent by the current flush, IPv4 first
+	unsigned int _batch_ipv4;				// End of the IPv4 entries in _batch
+	unsigned int _batch_ipv6;				// End of the IPv6 entries in _batch
+	std::vector<struct iovec> _vectors;
+	std::vector<char> _controls;			// The segment size of every entry sent with segmentation offload
+	std::vector<unsigned int> _entry_senders;
+	std::vector<unsigned int> _entry_destinations;
+	std::vector<size_t> _entry_segments;	// 0 for entries holding a single datagram
+	std::vector<unsigned int> _entry_datagrams;
+	std::vector<struct mmsghdr> _segment_batch;		// The datagrams of one entry, if it is sent without segmentation offload
+	std::vector<struct iovec> _segment_vectors;
+	int _socket_ipv4;
+	int _socket_ipv6;
+	int _socket_unix;
+	bool _is_segmenting_ipv4;
+	bool _is_segmenting_ipv6;
+	bool _is_segmenting_unix;				// Always false
+	unsigned long long _sent;
+	unsigned long long _dropped;
+	unsigned long long _would_block;
+
+	/**
+	 * @brief Adds an entry of one or more datagrams of a sender to the current flush.
+	 *
+	 * @param destination	The index of the destination of the sender.
+	 * @param segment_size	The size the kernel splits the entry into datagrams with. 0 for a single datagram.
+	 */
+	void add_entry(unsigned int sender, unsigned int destination, const char *data, size_t size, size_t segment_size,
+				   unsigned int datagrams);
+
+	/**
+	 * @brief Adds the frames of a payload larger than the maximum datagram size of its sender for all of its destinations.
+	 */
+	void add_frames(unsigned int sender, const std::string &payload);
+
+	/**
+	 * @brief Points the headers of all entries of the current flush to their buffers.
+	 */
+	void prepare_batch();
+
+	/**
+	 * @brief Sends the prepared entries between begin and end through one socket.
+	 */
+	void send_range(int socket, unsigned int begin, unsigned int end, bool *is_segmenting);
+
+	/**
+	 * @brief Sends the datagrams of an entry one by one, without segmentation offload.
+	 *
+	 * @return	false if the socket would block, so the remaining entries must be dropped.
+	 */
+	bool send_segments(int socket, unsigned int entry);
+};
+
+} //namespace utils
+
+#endif //BATCH_SENDER_HPP
@@ -0,0 +1,145 @@
+/**
+ * @file binary_protocol.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Functions to encode and decode the compact binary channel format.
+ *
+ * Interface nodes can exchange their values as binary datagrams instead of json.
+ * All numbers are little endian. A datagram starts with a 20 byte header:
+ *
+ *   offset  size  content
+ *   0       4     magic "CGNA"
+ *   4       1     version (1)
+ *   5       1     layout (1 = pairs, 2 = dense), bit 6 set for delta datagrams
+ *   6       2     count of values
+ *   8       4     sequence number, counted up by the sender
+ *   12      8     timestamp in milliseconds since epoch
+ *
+ * It is followed by count entries. With the pairs layout every entry consists of a
+ * uint16 channel index and a float32 value (6 bytes). With the dense layout every
+ * entry is a float32 value, whose channel index is its position.
+ *
+ * A delta datagram only contains the channels which changed since the previous datagram.
+ * Receivers keep the previous value of every channel missing from it.
+ *
+ * Json messages never start with the magic, so both formats can be received on the same port.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef BINARY_PROTOCOL_HPP
+#define BINARY_PROTOCOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace utils{
+
+const int FORMAT_JSON = 0;
+const int FORMAT_BINARY_PAIRS = 1;
+const int FORMAT_BINARY_DENSE = 2;
+
+const uint8_t BINARY_VERSION = 1;
+const uint8_t BINARY_LAYOUT_PAIRS = 1;
+const uint8_t BINARY_LAYOUT_DENSE = 2;
+const uint8_t BINARY_FLAG_DELTA = 0x40;
+const uint8_t BINARY_LAYOUT_MASK = 0x3F;
+const size_t BINARY_HEADER_SIZE = 20;
+const size_t BINARY_PAIR_SIZE = 6;
+const size_t BINARY_MAX_CHANNELS = 65535;
+
+/**
+ * @brief The decoded header of a binary datagram.
+ */
+struct binary_header{
+	uint8_t version;
+	uint8_t layout;		/**< Without flags */
+	bool is_delta;
+	uint16_t count;
+	uint32_t sequence;
+	int64_t timestamp;
+};
+
+/**
+ * @brief Converts the name of a format used in the network files to its constant.
+ *
+ * @param name	"json", "binary" (pairs layout) or "binary_dense".
+ *
+ * @return		FORMAT_JSON, FORMAT_BINARY_PAIRS, FORMAT_BINARY_DENSE or -1 if the name is unknown.
+ */
+int parse_format(const std::string &name);
+
+/**
+ * @brief Checks if a received message starts with the magic of the binary format.
+ *
+ * @param data	The received message.
+ * @param size	The size of the message in bytes.
+ *
+ * @return		true if the message is a binary datagram.
+ */
+bool is_binary_message(const char *data, size_t size);
+
+/**
+ * @brief Checks if a binary message is a delta datagram without decoding it.
+ *
+ * @param data	The received message, checked by is_binary_message() before.
+ * @param size	The size of the message in bytes.
+ *
+ * @return		true if the delta flag of the layout is set.
+ */
+bool is_binary_delta(const char *data, size_t size);
+
+/**
+ * @brief Reads the sequence number of a binary message without decoding it.
+ *
+ * @param data	The received message, checked by is_binary_message() before.
+ * @param size	The size of the message in bytes.
+ *
+ * @return		The sequence number of the header.
+ */
+uint32_t get_binary_sequence(const char *data, size_t size);
+
+/**
+ * @brief Encodes values in the pairs layout. Only channels marked as set are written.
+ *
+ * @param out		The buffer the datagram is written to. Its previous content is replaced.
+ * @param sequence	The sequence number of the datagram.
+ * @param timestamp	The timestamp of the datagram in milliseconds.
+ * @param values	The values indexed by their channel index.
+ * @param is_set	Marks which channels are part of the datagram. Same size as values.
+ * @param is_delta	Marks the datagram as delta, which only contains changed channels.
+ */
+void encode_binary_pairs(std::string &out, uint32_t sequence, int64_t timestamp,
+						 const std::vector<float> &values, const std::vector<bool> &is_set, bool is_delta=false);
+
+/**
+ * @brief Encodes values in the dense layout.
+ *
+ * @param out		The buffer the datagram is written to. Its previous content is replaced.
+ * @param sequence	The sequence number of the datagram.
+ * @param timestamp	The timestamp of the datagram in milliseconds.
+ * @param values	The values indexed by their channel index.
+ */
+void encode_binary_dense(std::string &out, uint32_t sequence, int64_t timestamp,
+						 const std::vector<float> &values);
+
+/**
+ * @brief Decodes a binary datagram.
+ *
+ * @param data		The received datagram.
+ * @param size		The size of the datagram in bytes.
+ * @param header	Filled with the header of the datagram.
+ * @param values	Filled with the values indexed by their channel index. Channels not contained are 0.
+ * @param contained	Optional. Filled with true for every channel contained in the datagram. Same size as values.
+ *
+ * @return			0 if the datagram could be decoded, -1 if it is malformed.
+ */
+int decode_binary_message(const char *data, size_t size, binary_header *header, std::vector<float> &values,
+						  std::vector<bool> *contained=nullptr);
+
+} //namespace utils
+
+#endif //BINARY_PROTOCOL_HPP
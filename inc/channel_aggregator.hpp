@@ -0,0 +1,144 @@
+/**
+ * @file channel_aggregator.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Aggregates the values of channels received between two ticks into one value per channel.
+ *
+ * The receiving thread adds every sample of a channel as it arrives. The consuming thread
+ * collects one value per channel per tick, depending on the aggregation of the channel:
+ *  - AGGREGATE_LAST: The value of the newest sample.
+ *  - AGGREGATE_SUM:  The sum of all samples.
+ *  - AGGREGATE_MEAN: The mean of all samples.
+ *  - AGGREGATE_MAX:  The largest sample.
+ *
+ * Two sets of fixed slots are used. The receiving thread adds into the active set, the
+ * consuming thread swaps the sets and reads the inactive one. The swap only waits if the
+ * receiving thread is adding a batch into that set in this very moment.
+ * Several receiving threads can add at the same time, each as its own producer with its own
+ * sets. Collecting merges the sets of all producers.
+ * Only one thread per producer may add and only one thread may collect. No memory is allocated
+ * after all channels are added.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef CHANNEL_AGGREGATOR_HPP
+#define CHANNEL_AGGREGATOR_HPP
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace utils{
+
+const int AGGREGATE_LAST = 0;
+const int AGGREGATE_SUM = 1;
+const int AGGREGATE_MEAN = 2;
+const int AGGREGATE_MAX = 3;
+
+/**
+ * @brief Converts the name of an aggregation used in the network files to its constant.
+ *
+ * @param name	"last", "sum", "mean" or "max".
+ *
+ * @return		AGGREGATE_LAST, AGGREGATE_SUM, AGGREGATE_MEAN, AGGREGATE_MAX or -1 if the name is unknown.
+ */
+int parse_aggregation(const std::string &name);
+
+class channel_aggregator{
+public:
+	/**
+	 * @param producer_number	The number of threads adding samples at the same time.
+	 */
+	channel_aggregator(int producer_number=1);
+
+	/**
+	 * @brief Frees the sets of all producers.
+	 */
+	~channel_aggregator();
+
+	/**
+	 * @brief Adds a channel. Must not be called while samples are added or collected.
+	 *
+	 * @param aggregation	The aggregation of the channel.
+	 *
+	 * @return				The index of the channel.
+	 */
+	int add_channel(int aggregation);
+
+	/**
+	 * @brief Changes the number of producers. Must not be called while samples are added or collected.
+	 */
+	void set_producer_number(int producer_number);
+
+	/**
+	 * @brief Starts adding a batch of samples. Called by the receiving thread of the producer only.
+	 *
+	 * @param producer	The index of the producer, below the number of producers.
+	 */
+	void begin_batch(int producer=0);
+
+	/**
+	 * @brief Adds a sample to a channel. Only allowed between begin_batch() and end_batch() of the same producer.
+	 *
+	 * @param channel	The index returned by add_channel().
+	 * @param value		The sample.
+	 * @param arrival	The arrival of the sample in nanoseconds since epoch.
+	 * @param producer	The index of the producer.
+	 */
+	void add_sample(int channel, float value, int64_t arrival, int producer=0);
+
+	/**
+	 * @brief Finishes adding a batch of samples.
+	 */
+	void end_batch(int producer=0);
+
+	/**
+	 * @brief Collects the aggregated values of all samples added since the last call. Called by the consuming thread only.
+	 *
+	 * If no sample was added, nothing is written. Otherwise every channel is written, channels
+	 * without samples with 0. The samples of all producers are aggregated together, the newest
+	 * sample of any producer is the last one.
+	 *
+	 * @param values	Filled with the aggregated value of every channel. Must hold all channels.
+	 * @param arrivals	Filled with the arrival of the newest sample of every channel. Must hold all channels.
+	 *
+	 * @return			The number of samples collected.
+	 */
+	unsigned long long collect(std::vector<float> &values, std::vector<int64_t> &arrivals);
+
+	/**
+	 * @brief Returns the number of channels.
+	 */
+	int get_channel_number();
+
+	/**
+	 * @brief Returns the number of producers.
+	 */
+	int get_producer_number();
+
+private:
+	struct channel_state{
+		double value;		// Double, so that sums of many samples stay exact
+		unsigned int count;
+		int64_t arrival;
+	};
+
+	struct producer_state{
+		std::vector<channel_state> sets[2];
+		unsigned long long sample_numbers[2];
+		std::atomic<int> adding;	// The set the producer is adding to right now, -1 if none
+		int batch_set;				// Owned by the receiving thread of the producer
+		char padding[64];			// Keeps producers from sharing a cache line
+	};
+
+	std::vector<int> _aggregations;
+	std::vector<producer_state*> _producers;
+	std::atomic<int> _active;		// The set samples are added to
+};
+
+} //namespace utils
+
+#endif //CHANNEL_AGGREGATOR_HPP
@@ -19,8 +19,10 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netdb.h>
 #include <stdexcept>
+#include <string>
 
 namespace udp_client_server
 {
@@ -32,6 +34,37 @@ public:
 };
 
 
+// Addresses starting with this prefix name a Unix domain datagram socket,
+// e.g. "unix:/tmp/cogna.sock", or "unix:@cogna" in the abstract namespace
+#define UNIX_ADDRESS_PREFIX "unix:"
+
+bool                    is_unix_address(const std::string& addr);
+bool                    autobind_unix_socket(int socket);
+
+
+class udp_address
+{
+public:
+                        udp_address(const std::string& addr, int port);
+                        ~udp_address();
+
+    int                 get_port() const;
+    std::string         get_addr() const;
+    const struct addrinfo * get_addrinfo() const;
+    bool                is_multicast() const;
+
+private:
+                        udp_address(const udp_address&);
+    udp_address&        operator=(const udp_address&);
+
+    int                 f_port;
+    std::string         f_addr;
+    struct addrinfo *   f_addrinfo;
+    struct addrinfo     f_unix_addrinfo;
+    struct sockaddr_un  f_unix_address;
+};
+
+
 class udp_client
 {
 public:
@@ -41,21 +74,25 @@ public:
     int                 get_socket() const;
     int                 get_port() const;
     std::string         get_addr() const;
+    const struct addrinfo * get_addrinfo() const;
 
     int                 send(const char *msg, size_t size);
+    int                 send(const char *msg, size_t size, const udp_address& destination);
 
 private:
     int                 f_socket;
     int                 f_port;
     std::string         f_addr;
     struct addrinfo *   f_addrinfo;
+    struct addrinfo     f_unix_addrinfo;
+    struct sockaddr_un  f_unix_address;
 };
 
 
 class udp_server
 {
 public:
-                        udp_server(const std::string& addr, int port);
+                        udp_server(const std::string& addr, int port, bool reuse_port = false);
                         ~udp_server();
 
     int                 get_socket() const;
@@ -63,6 +100,7 @@ public:
     std::string         get_addr() const;
 
     int                 recv(char *msg, size_t max_size);
+    int                 recv_batch(struct mmsghdr *msgs, unsigned int max_msgs, int flags = MSG_WAITFORONE);
     int                 timed_recv(char *msg, size_t max_size, int max_wait_ms);
 
 private:
@@ -70,6 +108,8 @@ private:
     int                 f_port;
     std::string         f_addr;
     struct addrinfo *   f_addrinfo;
+    struct addrinfo     f_unix_addrinfo;
+    struct sockaddr_un  f_unix_address;
 };
 
 } // namespace udp_client_server
@@ -0,0 +1,138 @@
+/**
+ * @file frame_protocol.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Splits messages larger than a datagram into frames and reassembles them.
+ *
+ * Instead of relying on IP fragmentation, a sender splits a large json or binary message into
+ * frames, which are sent as separate datagrams. All numbers are little endian. Every frame starts
+ * with a 16 byte header:
+ *
+ *   offset  size  content
+ *   0       4     magic "CGNF"
+ *   4       4     message id, counted up by the sender
+ *   8       2     index of the frame
+ *   10      2     count of frames of the message
+ *   12      4     size of the whole message in bytes
+ *
+ * It is followed by a part of the message. Every frame but the last one has the same size, so a
+ * frame starts at index * part size in the message and the frames of a message can be sent with
+ * UDP segmentation offload in one system call. The last frame holds the end of the message.
+ *
+ * Json messages and binary datagrams never start with the magic, so all of them can be
+ * received on the same port.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef FRAME_PROTOCOL_HPP
+#define FRAME_PROTOCOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifndef FRAME_MAX_MESSAGE_SIZE
+#define FRAME_MAX_MESSAGE_SIZE 16777216		// Larger messages are dropped by receivers
+#endif //FRAME_MAX_MESSAGE_SIZE
+
+#ifndef FRAME_MAX_PENDING
+#define FRAME_MAX_PENDING 8					// Messages reassembled at the same time by one receiver
+#endif //FRAME_MAX_PENDING
+
+namespace utils{
+
+const size_t FRAME_HEADER_SIZE = 16;
+const size_t FRAME_MAX_COUNT = 65535;
+const size_t UDP_MAX_PAYLOAD = 65507;		// The largest payload of an IPv4 UDP datagram
+
+/**
+ * @brief Checks if a received datagram starts with the magic of a frame.
+ *
+ * @param data	The received datagram.
+ * @param size	The size of the datagram in bytes.
+ *
+ * @return		true if the datagram is a frame.
+ */
+bool is_frame(const char *data, size_t size);
+
+/**
+ * @brief Splits a message into frames, written back to back into one buffer.
+ *
+ * @param out			The buffer the frames are written to. Its previous content is replaced.
+ * @param message_id	The id of the message.
+ * @param data			The message.
+ * @param size			The size of the message in bytes.
+ * @param datagram_size	The size of every frame but the last one, including its header.
+ *
+ * @return				The number of frames, -1 if the datagram size is too small for the message.
+ */
+int encode_frames(std::string &out, uint32_t message_id, const char *data, size_t size, size_t datagram_size);
+
+class frame_assembler{
+public:
+	frame_assembler();
+
+	/**
+	 * @brief Adds a received frame to the message it belongs to.
+	 *
+	 * A message is identified by its source and message id, so the frames of messages from several
+	 * senders, or of several messages of one sender, may arrive interleaved. Up to FRAME_MAX_PENDING
+	 * messages are reassembled at a time. A frame of a further message discards the incomplete
+	 * message which received no frame for the longest time.
+	 *
+	 * @param data		The received frame.
+	 * @param size		The size of the frame in bytes.
+	 * @param source	Identifies the sender of the frame, e.g. a hash of its address.
+	 *
+	 * @return			true if the frame completed its message, which is then returned by get_message().
+	 */
+	bool add(const char *data, size_t size, uint64_t source=0);
+
+	/**
+	 * @brief Returns the last completed message. Valid until the next call of add().
+	 */
+	const std::string& get_message();
+
+	/**
+	 * @brief Returns the number of messages discarded, because not all of their frames were received.
+	 */
+	unsigned long long get_incomplete();
+
+	/**
+	 * @brief Returns the number of frames discarded, because their header was malformed.
+	 */
+	unsigned long long get_malformed();
+
+private:
+	/**
+	 * @brief A message being reassembled, or the last one completed in its place.
+	 */
+	struct pending_message{
+		uint64_t source;
+		uint32_t message_id;
+		std::string message;
+		std::vector<bool> received;
+		unsigned int received_number;
+		bool is_assembling;
+		bool has_completed;			// message_id is a completed message, whose late duplicates are ignored
+		unsigned long long last_use;	// The frame counter when the message last received a frame
+	};
+
+	std::vector<pending_message> _pending;
+	int _completed;					// The pending message returned by get_message()
+	unsigned long long _frame_counter;
+	unsigned long long _incomplete;
+	unsigned long long _malformed;
+
+	/**
+	 * @brief Returns the pending message of a frame. Starts a new one in the least recently used place if none exists.
+	 */
+	pending_message& find_pending(uint64_t source, uint32_t message_id);
+};
+
+} //namespace utils
+
+#endif //FRAME_PROTOCOL_HPP
@@ -0,0 +1,55 @@
+/**
+ * @file input_signal.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Wakes up a thread waiting for new input messages.
+ *
+ * Receiving threads call notify() after publishing a message. It only counts up an atomic
+ * counter, unless a thread is waiting, which is then woken up through a futex. The waiting
+ * thread remembers the last counter it has seen, so messages arriving while it was busy
+ * are never missed.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef INPUT_SIGNAL_HPP
+#define INPUT_SIGNAL_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace utils{
+
+class input_signal{
+public:
+	input_signal();
+
+	/**
+	 * @brief Signals that a new input message was published. Called by any number of threads.
+	 */
+	void notify();
+
+	/**
+	 * @brief Waits until a message was published after the one last seen. Called by one thread only.
+	 *
+	 * @param seen			The counter seen last. Updated to the current counter.
+	 * @param timeout_us	The longest time to wait in microseconds. Negative waits without limit.
+	 *
+	 * @return				true if a message was published, false on timeout.
+	 */
+	bool wait(uint32_t *seen, int64_t timeout_us);
+
+	/**
+	 * @brief Returns the current counter, to initialize the counter seen by a waiting thread.
+	 */
+	uint32_t get_counter();
+
+private:
+	std::atomic<uint32_t> _counter;		// Futex word
+	std::atomic<uint32_t> _waiters;
+};
+
+} //namespace utils
+
+#endif //INPUT_SIGNAL_HPP
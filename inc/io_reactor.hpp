@@ -0,0 +1,97 @@
+/**
+ * @file io_reactor.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Receives the messages of many networking clients with a small number of threads.
+ *
+ * The clients are distributed over the threads. Every thread waits with its own epoll
+ * instance for any of its sockets to become readable and then drains it with
+ * networking_client::receive_pending(). Every receive queue of a client is a socket of its own,
+ * the queues of one client are spread over the threads. An eventfd registered in every epoll instance
+ * wakes all threads up when the reactor is stopped, so they can be joined.
+ *
+ * Clients reading a shared memory ring are not received by the reactor. If such a client
+ * has an input signal, a watching thread notifies it about new messages in the ring.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef IO_REACTOR_HPP
+#define IO_REACTOR_HPP
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "networking_client.hpp"
+
+namespace utils{
+
+class io_reactor{
+public:
+	/**
+	 * @brief Creates the reactor. No thread is started yet.
+	 *
+	 * @param clients		The clients whose sockets are watched. Clients reading a shared memory ring are only
+	 *						watched if they have an input signal.
+	 * @param thread_number	The number of receiving threads. Never more than one per receive queue are started.
+	 */
+	io_reactor(std::vector<networking_client*> clients, int thread_number);
+
+	/**
+	 * @brief Stops the reactor if it is still running.
+	 */
+	~io_reactor();
+
+	/**
+	 * @brief Registers all sockets and starts the receiving threads.
+	 *
+	 * @return	0 on success, -1 if an epoll instance or the eventfd could not be set up.
+	 */
+	int start();
+
+	/**
+	 * @brief Wakes up all receiving and watching threads and waits for them to finish.
+	 */
+	void stop();
+
+	/**
+	 * @brief Returns the number of started receiving threads.
+	 */
+	int get_thread_number();
+
+private:
+	struct receive_target{
+		networking_client *client;
+		int queue;
+	};
+
+	std::vector<networking_client*> _clients;
+	std::vector<receive_target> _targets;		// Every receive queue of every client
+	std::vector<std::thread*> _threads;
+	std::vector<networking_client*> _local_clients;
+	std::vector<std::thread*> _watchers;
+	std::vector<int> _epoll_fds;
+	int _requested_thread_number;
+	int _stop_fd;
+	std::atomic<bool> _is_stopping;
+
+	/**
+	 * @brief Waits for readable sockets until the eventfd is signalled. Runs in every receiving thread.
+	 */
+	void run(int epoll_fd);
+
+	/**
+	 * @brief Notifies the input signal of a client about new messages in its ring until stopped. Runs in every watching thread.
+	 */
+	void watch(networking_client *client);
+
+	/**
+	 * @brief Closes all file descriptors.
+	 */
+	void close_fds();
+};
+
+} //namespace utils
+
+#endif //IO_REACTOR_HPP
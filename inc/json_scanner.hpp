@@ -0,0 +1,100 @@
+/**
+ * @file json_scanner.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Extracts the values of a few registered keys from a json message without building a DOM.
+ *
+ * Only the top level object is looked at. Values of unregistered keys, including nested objects
+ * and arrays, are skipped without being parsed. Registered keys are read if their value is a number
+ * or a boolean. Keys registered with a width of more than 1 are vectors, which also read a flat array
+ * of numbers and booleans into consecutive values. No memory is allocated while scanning, except for
+ * keys containing escape sequences longer than any such key before and for numbers longer than 63 characters.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef JSON_SCANNER_HPP
+#define JSON_SCANNER_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace utils{
+
+class json_scanner{
+public:
+	/**
+	 * @brief Registers a key, whose value is extracted by scan().
+	 *
+	 * Registering a key again returns the same index. Its width grows to the largest one registered.
+	 *
+	 * @param key	The unescaped key.
+	 * @param width	The number of values read from an array. 1 for a scalar key, which skips arrays.
+	 *
+	 * @return		The index of the key, used to access its value.
+	 */
+	int add_key(const std::string &key, int width=1);
+
+	/**
+	 * @brief Scans a message for the registered keys.
+	 *
+	 * @param data	The message.
+	 * @param size	The size of the message in bytes.
+	 *
+	 * @return		true if the message is a well formed json object. Otherwise no key is marked as contained.
+	 */
+	bool scan(const char *data, size_t size);
+
+	/**
+	 * @brief Returns if the key was contained in the last scanned message with a number or boolean value.
+	 */
+	bool is_contained(int index);
+
+	/**
+	 * @brief Returns the value of the key in the last scanned message. Booleans are 1 or 0.
+	 *
+	 * The first element for an array.
+	 */
+	float get_value(int index);
+
+	/**
+	 * @brief Returns the values of a vector key in the last scanned message. A scalar value is the only element.
+	 */
+	const float* get_values(int index);
+
+	/**
+	 * @brief Returns the number of values read for the key in the last scanned message. At most its width.
+	 */
+	int get_length(int index);
+
+	/**
+	 * @brief Returns the number of registered keys.
+	 */
+	int get_key_number();
+
+private:
+	std::vector<std::string> _keys;
+	std::vector<float> _values;			// The values of all keys, each starting at its offset
+	std::vector<int> _offsets;
+	std::vector<int> _widths;
+	std::vector<int> _lengths;
+	std::vector<bool> _contained;
+	std::string _key_buffer;
+	const char *_curr;
+	const char *_end;
+
+	void skip_whitespace();
+	bool read_string(const char **begin, size_t *length, bool *is_escaped);
+	bool unescape(const char *begin, size_t length);
+	bool read_literal(const char *literal);
+	bool read_number(float *value);
+	bool skip_value();
+	bool read_array(int index);
+	int find_key(const char *key, size_t length);
+};
+
+} //namespace utils
+
+#endif //JSON_SCANNER_HPP
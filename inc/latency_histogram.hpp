@@ -0,0 +1,73 @@
+/**
+ * @file latency_histogram.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Collects the distribution of latencies in logarithmic buckets.
+ *
+ * Bucket b counts latencies below 2^b nanoseconds, which were not counted in a lower bucket.
+ * Recording is a few integer operations and never allocates, so it can be done every tick.
+ * Percentiles are reported as the upper bound of their bucket, so they are exact within a factor of two.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <cstdint>
+
+namespace utils{
+
+class latency_histogram{
+public:
+	latency_histogram();
+
+	/**
+	 * @brief Counts a latency. Negative latencies, caused by clock adjustments, are counted as 0.
+	 *
+	 * @param latency_ns	The latency in nanoseconds.
+	 */
+	void record(int64_t latency_ns);
+
+	/**
+	 * @brief Returns the number of recorded latencies.
+	 */
+	unsigned long long get_count() const;
+
+	/**
+	 * @brief Returns the latency in nanoseconds below which the given share of latencies lies.
+	 *
+	 * @param percentile	The share between 0 and 1, e.g. 0.99.
+	 *
+	 * @return				The upper bound of the bucket containing the percentile, at most the maximum latency.
+	 */
+	int64_t get_percentile(double percentile) const;
+
+	/**
+	 * @brief Returns the mean latency in nanoseconds.
+	 */
+	int64_t get_mean() const;
+
+	/**
+	 * @brief Returns the highest recorded latency in nanoseconds.
+	 */
+	int64_t get_max() const;
+
+	/**
+	 * @brief Removes all recorded latencies.
+	 */
+	void clear();
+
+private:
+	static const int BUCKET_NUMBER = 48;	// The last bucket also counts everything above 2^47 ns (~39 hours)
+
+	unsigned long long _buckets[BUCKET_NUMBER];
+	unsigned long long _count;
+	int64_t _sum;
+	int64_t _max;
+};
+
+} //namespace utils
+
+#endif //LATENCY_HISTOGRAM_HPP
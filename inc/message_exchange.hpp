@@ -0,0 +1,116 @@
+/**
+ * @file message_exchange.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Hands received messages from one receiving thread to one consuming thread without locks.
+ *
+ * Two policies exist:
+ *  - EXCHANGE_LATEST: A triple buffer. The consumer always gets the newest complete message,
+ *                     older ones are overwritten. Neither side ever waits.
+ *  - EXCHANGE_QUEUE:  A single producer single consumer ring. The consumer gets every message
+ *                     published since it last consumed, in order. If the ring is full, new
+ *                     messages are dropped and counted.
+ *
+ * Only one thread may call publish() and only one thread may call consume().
+ * Message buffers are reused, so after their first growth no memory is allocated.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef MESSAGE_EXCHANGE_HPP
+#define MESSAGE_EXCHANGE_HPP
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace utils{
+
+const int EXCHANGE_LATEST = 0;
+const int EXCHANGE_QUEUE = 1;
+
+/**
+ * @brief A message handed over by the exchange.
+ */
+struct exchange_message{
+	std::string data;
+	int64_t arrival;	/**< Time the message arrived in nanoseconds since epoch */
+};
+
+class message_exchange{
+public:
+	/**
+	 * @brief Creates the message buffers.
+	 *
+	 * @param policy	EXCHANGE_LATEST or EXCHANGE_QUEUE.
+	 * @param capacity	The number of messages the queue can hold. Ignored by EXCHANGE_LATEST.
+	 */
+	message_exchange(int policy, size_t capacity);
+
+	/**
+	 * @brief Publishes a fully received message. Called by the producing thread only.
+	 *
+	 * @param data		The message.
+	 * @param size		The size of the message in bytes.
+	 * @param arrival	The time the message arrived in nanoseconds since epoch.
+	 *
+	 * @return			false if the queue was full and the message was dropped.
+	 */
+	bool publish(const char *data, size_t size, int64_t arrival=0);
+
+	/**
+	 * @brief Takes the next message, which was not consumed yet. Called by the consuming thread only.
+	 *
+	 * The returned message stays valid and unchanged until consume() is called again.
+	 *
+	 * @param published	EXCHANGE_QUEUE only takes messages published before get_published() returned this number,
+	 *					so a consumer can stop at a snapshot while the producer keeps publishing.
+	 *					Ignored by EXCHANGE_LATEST.
+	 *
+	 * @return	The message or nullptr if no new message was published.
+	 */
+	const exchange_message* consume(size_t published=SIZE_MAX);
+
+	/**
+	 * @brief Returns the number of messages published so far. Called by the consuming thread only.
+	 *
+	 * Only EXCHANGE_QUEUE counts its messages, EXCHANGE_LATEST always returns 0.
+	 */
+	size_t get_published();
+
+	/**
+	 * @brief Returns the policy of the exchange.
+	 */
+	int get_policy();
+
+	/**
+	 * @brief Returns the number of messages dropped, because the queue was full.
+	 */
+	unsigned long long get_dropped();
+
+private:
+	static const unsigned int FRESH_FLAG = 4;
+
+	int _policy;
+	std::vector<exchange_message> _buffers;
+
+	// EXCHANGE_LATEST: Index of the buffer handed over between both threads, marked with FRESH_FLAG if unread.
+	std::atomic<unsigned int> _middle;
+	unsigned int _back;		// Owned by the producer
+	unsigned int _front;	// Owned by the consumer
+
+	// EXCHANGE_QUEUE: Both counters only grow. Their difference is the number of queued messages.
+	std::atomic<size_t> _head;
+	char _padding[64];		// Keeps both counters on different cache lines
+	std::atomic<size_t> _tail;
+	bool _is_holding;		// Owned by the consumer. The buffer at _tail is still in use by the consumer.
+
+	std::atomic<unsigned long long> _dropped;
+};
+
+} //namespace utils
+
+#endif //MESSAGE_EXCHANGE_HPP
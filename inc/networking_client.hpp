@@ -5,10 +5,35 @@
  * @brief A class responsible for receiving messages from an environment.
  *
  * It receives messages via UDP/IP and stores them in a hashtable.
+ * Messages split into frames by the sender are reassembled by the receiving thread. Datagrams
+ * coalesced by the kernel (UDP_GRO) are split up again, so bursts of frames need few system calls.
+ * Producers on the same host can instead write into a named shm_ring, which is read directly by
+ * store_message() without a receiving thread and without system calls.
+ * The receiving thread hands complete messages to the thread calling store_message()
+ * via a lock free message_exchange, either only the newest one or all of them.
  * Can return the full message as a string, a hashtable, or can return
  * only certain values of the message.
  *
  * The messages should be in json shape for full functionality of the class.
+ * Registered channels are extracted by a json_scanner, the full hashtable is only parsed
+ * when one of the functions returning json needs it.
+ * Messages in the binary channel format are detected automatically and can
+ * be read with get_binary_value().
+ * Delta messages of a networking_sender in delta mode only contain changed channels,
+ * so the registered channels missing from them keep their value.
+ * Vector channels carry many values, as a json array or as consecutive binary channels, into
+ * consecutive slots.
+ * Channels can aggregate all values received between two calls of store_message() instead of
+ * keeping only the newest one. Then the receiving thread extracts the channels of every message
+ * into a channel_aggregator, so no value is lost to the message exchange.
+ * A port can be received by several queues, each with its own socket bound with SO_REUSEPORT
+ * and its own receiving thread. The kernel distributes the senders over the queues, every sender
+ * stays on one queue. store_message() merges the messages of all queues by arrival and the
+ * channel_aggregator merges their aggregates.
+ * Channels linked directly to output nodes can be forwarded by the receiving thread as soon as
+ * they arrive, through a relay_table.
+ * Instead of an ip address, a path like "unix:/tmp/cogna.sock" receives on a Unix domain datagram
+ * socket, which skips the IP stack for producers on the same host. The messages stay the same.
  *
  * @date 2021-05-27
  *
@@ -18,11 +43,21 @@
 #define NETWORKING_CLIENT_HPP
 
 #include <string>
+#include <vector>
+#include <sys/socket.h>
 #include "json.hpp"
 #include "client_server.hpp"
+#include "message_exchange.hpp"
+#include "json_scanner.hpp"
+#include "shm_ring.hpp"
+#include "channel_aggregator.hpp"
+#include "input_signal.hpp"
+#include "frame_protocol.hpp"
 
 namespace utils{
 
+class relay_table;
+
 class networking_client{
 public:
 	/**
@@ -31,9 +66,25 @@ public:
 	 * @param ip		The ip of the message server.
 	 * @param port		The port where the information is sent on.
 	 * @param is_json	Determines if the received information is supposedly in json format.
+	 * @param policy	EXCHANGE_LATEST to only store the newest message or EXCHANGE_QUEUE to store all
+	 *					messages received since the last call of store_message(). Once a delta message
+	 *					arrived, all are stored, as deltas only contain the changed channels.
+	 * @param queues	The number of receive queues sharing the port, each with its own socket.
 	 *
 	 */
-	networking_client(std::string ip, int port, bool is_json);
+	networking_client(std::string ip, int port, bool is_json, int policy=EXCHANGE_LATEST, int queues=1);
+
+	/**
+	 * @brief Attaches to a shared memory ring, which is created if it does not exist yet.
+	 *
+	 * @param shm_name	The name of the shared memory, e.g. "/cogna_sensors".
+	 * @param is_json	Determines if the received information is supposedly in json format.
+	 * @param policy	EXCHANGE_LATEST to only store the newest message or EXCHANGE_QUEUE to store all
+	 *					messages written since the last call of store_message(). Once a delta message
+	 *					arrived, all are stored, as deltas only contain the changed channels.
+	 *
+	 */
+	networking_client(std::string shm_name, bool is_json, int policy=EXCHANGE_LATEST);
 
 	/**
 	 * @brief Closes UDP socket.
@@ -51,25 +102,129 @@ public:
 	/**
 	 * @brief Returns the given port of the socket.
 	 *
-	 * @return The port as integer.
+	 * @return The port as integer. 0 for a shared memory ring.
 	 */
 	int get_port();
 
 	/**
-	 * @brief Receives a message via UDP and stores it as a string.
+	 * @brief Returns true if the client reads from a shared memory ring instead of a socket.
+	 */
+	bool is_local();
+
+	/**
+	 * @brief Returns the name of the shared memory ring. Empty for UDP clients.
+	 */
+	std::string get_shm_name();
+
+	/**
+	 * @brief Sets the size of every receive buffer. Longer datagrams are truncated. Must be set before receiving starts.
+	 *
+	 * Only buffers of 64 KiB let the kernel coalesce datagrams (UDP_GRO), as it fills them up to that size.
+	 * Ignored for a shared memory ring.
 	 *
+	 * @param size	The size in bytes, between 1024 and 65536.
+	 *
+	 * @return		0 on success, -1 if the size is out of range.
+	 */
+	int set_receive_buffer_size(size_t size);
+
+	/**
+	 * @brief Returns the size of every receive buffer in bytes. 0 for a shared memory ring.
+	 */
+	size_t get_receive_buffer_size();
+
+	/**
+	 * @brief Returns true if the kernel coalesces received datagrams of the same size (UDP_GRO).
+	 */
+	bool is_coalescing();
+
+	/**
+	 * @brief Returns the number of receive queues. 0 for a shared memory ring.
+	 */
+	int get_queue_number();
+
+	/**
+	 * @brief Receives messages via UDP and publishes them to the message exchange.
+	 *
+	 * Drains all queued datagrams with one system call into a preallocated ring of buffers.
 	 * Should be called in its own worker thread, so that it can continuously receive messages.
+	 * Returns immediately for a shared memory ring, which is read by store_message() itself.
+	 *
+	 * @param queue	The receive queue. Every queue needs its own thread.
+	 */
+	void receive_message(int queue=0);
+
+	/**
+	 * @brief Receives all datagrams queued on the socket of a queue without blocking and publishes them.
+	 *
+	 * Called by an io_reactor whenever the socket becomes readable. A queue must not be received
+	 * by two threads at the same time.
+	 *
+	 * @param queue	The receive queue.
+	 *
+	 * @return		The number of received datagrams.
 	 */
-	void receive_message();
+	int receive_pending(int queue=0);
+
+	/**
+	 * @brief Sets a signal, which is notified whenever a new message was received. nullptr for none.
+	 *
+	 * Must be set before receiving starts.
+	 */
+	void set_input_signal(input_signal *signal);
+
+	/**
+	 * @brief Returns the signal notified whenever a new message was received. nullptr if none is set.
+	 */
+	input_signal* get_input_signal();
+
+	/**
+	 * @brief Sets the relay table, whose immediate routes are forwarded by the receiving thread. nullptr for none.
+	 *
+	 * Must be set before receiving starts.
+	 */
+	void set_relay(relay_table *relay);
+
+	/**
+	 * @brief Waits for new messages in the shared memory ring and notifies the input signal about them.
+	 *
+	 * Does not read the messages, so store_message() can be called meanwhile by another thread.
+	 *
+	 * @param timeout_ms	The longest time to wait in milliseconds.
+	 */
+	void watch_local(int timeout_ms);
+
+	/**
+	 * @brief Returns the file descriptor of the receiving socket of a queue. -1 for a shared memory ring.
+	 */
+	int get_socket(int queue=0);
 
 	/**
 	 * @brief Stores the message in a returnable variable.
 	 *
 	 * This function makes a snapshot of the incoming message stream. This snapshot can later be accessed to
 	 * via different functions. To receive the latest message, this function must be called.
+	 * With EXCHANGE_QUEUE all messages received since the last call are applied in order, so every
+	 * channel holds the value of the newest message containing it. The message functions return the
+	 * newest message. If nothing was received since the last call, the snapshot stays unchanged.
+	 * Messages published while the queued ones are applied are left for the next call, so a fast sender
+	 * cannot keep this function busy.
+	 * The messages of several receive queues are applied in the order they arrived.
 	 */
 	void store_message();
 
+	/**
+	 * @brief Reads the sequence number of the message stored by the last call of store_message().
+	 *
+	 * It is the sequence number of the header of a binary message or the integer value of the key
+	 * "sequence" of a json message.
+	 *
+	 * @param sequence	Gets the sequence number.
+	 *
+	 * @return			false if no message was stored since clear_message() or it has no sequence number.
+	 */
+	bool get_sequence(int64_t *sequence);
+
 	/**
 	 * @brief Returns the last received message as string.
 	 *
@@ -89,6 +244,69 @@ public:
 	 */
 	nlohmann::json get_json_value(std::string key);
 
+	/**
+	 * @brief Registers a channel whose value is extracted from every stored message.
+	 *
+	 * Called while building the cluster, so that reading a channel during a tick is a plain array read.
+	 * Registering the same channel twice returns the same slot.
+	 *
+	 * @param key			The key of the channel in json messages.
+	 * @param format		FORMAT_JSON or one of the binary formats.
+	 * @param channel_index	The index of the channel in binary messages.
+	 * @param aggregation	How the values received between two calls of store_message() are combined.
+	 *						AGGREGATE_LAST keeps the newest one.
+	 * @param width			The number of values of a vector channel. Its json value is an array, its binary
+	 *						values are the channels from channel_index on. 1 for a scalar channel.
+	 *
+	 * @return				The slot of the channel. The values of a vector channel take the slots from there on.
+	 */
+	int register_channel(std::string key, int format, int channel_index, int aggregation=AGGREGATE_LAST,
+						 int width=1);
+
+	/**
+	 * @brief Returns the value of a registered channel in the last stored message.
+	 *
+	 * @param slot	The slot returned by register_channel().
+	 *
+	 * @return		The value of the channel. 0 if it was not part of the message.
+	 *				For aggregated channels the aggregate of all values since the last call of store_message().
+	 */
+	float get_slot_value(int slot);
+
+	/**
+	 * @brief Returns when the message, which set the value of a registered channel, arrived.
+	 *
+	 * The kernel stamps datagrams on arrival if supported, otherwise the receiving thread does.
+	 *
+	 * @param slot	The slot returned by register_channel().
+	 *
+	 * @return		The arrival in nanoseconds since epoch. 0 if the channel was not part of the message.
+	 */
+	int64_t get_slot_arrival(int slot);
+
+	/**
+	 * @brief Returns the values of a registered vector channel, like get_slot_value() for every element.
+	 *
+	 * @param slot	The slot returned by register_channel().
+	 *
+	 * @return		The values of all elements. Valid until the next channel is registered.
+	 */
+	const float* get_slot_values(int slot);
+
+	/**
+	 * @brief Returns the arrivals of a registered vector channel, like get_slot_arrival() for every element.
+	 */
+	const int64_t* get_slot_arrivals(int slot);
+
+	/**
+	 * @brief Returns a certain value of the message, if it is coded in the binary channel format.
+	 *
+	 * @param channel_index	The index of the channel in the binary message.
+	 *
+	 * @return				The value of the channel. 0 if the channel is not contained in the message.
+	 */
+	float get_binary_value(int channel_index);
+
 	/**
 	 * @brief Returns the complete json hashtable.
 	 *
@@ -96,14 +314,151 @@ public:
 	 */
 	nlohmann::json get_hashtable();
 
+	/**
+	 * @brief Returns the number of messages dropped, because the queue of EXCHANGE_QUEUE was full
+	 *        or the shared memory ring overwrote them before they were read.
+	 */
+	unsigned long long get_dropped_messages();
+
+	/**
+	 * @brief Returns the number of framed messages, which could not be reassembled, because frames were lost or malformed.
+	 */
+	unsigned long long get_incomplete_messages();
+
+	/**
+	 * @brief Clears the stored message at the end of a tick.
+	 *
+	 * The registered channels are set to 0, unless delta messages were received. A delta sender only
+	 * sends changed channels and nothing at all if none changed, so its channels keep their last value.
+	 */
 	void clear_message();
 
 private:
-	std::string _msg;
+	/**
+	 * @brief Everything owned by the receiving thread of one socket.
+	 */
+	struct receive_queue{
+		int index;								// The producer of the queue in the channel aggregator
+		udp_client_server::udp_server *receiver;
+		message_exchange *exchange;
+		message_exchange *delta_exchange;		// EXCHANGE_LATEST: Takes every message once a delta arrived
+		bool is_delta_stream;					// Owned by the receiving thread
+		std::vector<char> ring;
+		std::vector<struct iovec> vectors;
+		std::vector<struct mmsghdr> headers;
+		std::vector<char> controls;
+		std::vector<struct sockaddr_storage> sources;	// The sender addresses of the batch, which frames are assembled by
+		frame_assembler assembler;
+		const char *pending_data;				// The newest message of a batch, published at its end
+		size_t pending_size;
+		int64_t pending_arrival;
+		json_scanner scanner;					// Used if aggregating or relaying
+		std::vector<float> binary_values;
+		std::vector<bool> binary_contained;
+		std::vector<int> relayed_slots;			// The channels of a message forwarded by the relay at once
+		std::vector<float> relayed_values;
+	};
+
 	std::string _stored_message;
-	udp_client_server::udp_server *_receiver;
+	int64_t _stored_arrival;
+	std::vector<receive_queue*> _queues;
+	std::vector<message_exchange*> _exchanges;				// The exchanges of all queues, merged by store_message()
+	std::vector<const exchange_message*> _queue_messages;	// The next message of every exchange in store_message()
+	std::vector<size_t> _queue_published;					// Messages published to every exchange when store_message() began
+	shm_ring *_local_ring;
+	receive_queue *_local_queue;	// Extracts the aggregated channels of a shared memory ring, without socket
+	uint64_t _watched_head;			// Messages in the ring known to watch_local()
+	input_signal *_input_signal;
+	relay_table *_relay;
+	exchange_message _local_message;
+	size_t _receive_slot_size;
+	bool _is_coalescing;
 	nlohmann::json _hashtable;
+	bool _is_hashtable_parsed;
+	bool _is_snapshot_cleared;		// The registered channels were set to 0 by the current store_message()
+	int _delta_key;
+	bool _is_delta_stream;			// A delta message was applied, so the channels keep their value between messages
+	bool _is_tick_cleared;			// The channels were set to 0 by clear_message() and no message was applied since
+	std::vector<float> _tick_values;		// The channels before clear_message(), restored by the first delta message
+	std::vector<int64_t> _tick_arrivals;
+	json_scanner _scanner;
+	std::vector<std::vector<int>> _scanner_slots;	// The slots of every key of the scanner
+	std::vector<float> _binary_values;
+	std::vector<bool> _binary_contained;
+	std::vector<std::string> _slot_keys;
+	std::vector<int> _slot_formats;
+	std::vector<int> _slot_indices;
+	std::vector<int> _slot_widths;		// The width of the channel starting at a slot, 0 for further elements
+	std::vector<float> _slot_values;
+	std::vector<int64_t> _slot_arrivals;
+	std::vector<int> _slot_aggregations;
 	bool _is_json;
+	int _policy;
+	bool _is_aggregating;
+	channel_aggregator _aggregator;
+
+	/**
+	 * @brief Creates a receive queue. Without address it has no socket.
+	 */
+	receive_queue* create_queue(const std::string &ip, int port, bool is_shared);
+
+	/**
+	 * @brief Publishes the datagrams of a received batch to the message exchange of the queue.
+	 */
+	void publish_batch(receive_queue *queue, int received);
+
+	/**
+	 * @brief Reassembles a received datagram if it is a frame and hands complete messages to the exchange and aggregator.
+	 */
+	void deliver_datagram(receive_queue *queue, const char *data, size_t size, int64_t arrival, uint64_t source);
+
+	/**
+	 * @brief Applies the messages of all queues in the order they arrived.
+	 *
+	 * @return	true if any message was applied.
+	 */
+	bool apply_queued_messages();
+
+	/**
+	 * @brief Reads the unread messages of the shared memory ring into the snapshot.
+	 */
+	void store_local_messages();
+
+	/**
+	 * @brief Sets up the parts shared by UDP and shared memory clients.
+	 */
+	void init(bool is_json, int policy);
+
+	/**
+	 * @brief Extracts the registered channels of a message, adds them to the channel aggregator
+	 *        and forwards them through the relay table.
+	 */
+	void extract_channels(receive_queue *queue, const char *data, size_t size, int64_t arrival);
+
+	/**
+	 * @brief Parses a message and updates the snapshot with it.
+	 */
+	void apply_message(const exchange_message &message);
+
+	/**
+	 * @brief Sets all registered channels to 0, once per call of store_message().
+	 */
+	void clear_slots();
+
+	/**
+	 * @brief Marks the client as receiving deltas and restores the channels cleared by clear_message().
+	 */
+	void restore_tick_slots();
+
+	/**
+	 * @brief Extracts the values of all registered channels contained in the stored message.
+	 */
+	void update_slots(bool is_binary);
+
+	/**
+	 * @brief Parses the stored message into the hashtable, if it was not parsed yet.
+	 */
+	void parse_hashtable();
 };
 
 } //namespace utils
@@ -8,6 +8,23 @@
  * called.
  *
  * The messages sent are always in json shape.
+ * In delta mode only channels whose value changed by more than an epsilon since they were last
+ * sent are part of a message, and a message without changes is not sent at all. Every
+ * keyframe_interval ticks a full keyframe with all channels is sent. Messages carry a sequence
+ * number, so receivers can detect lost deltas and wait for the next keyframe.
+ * Consumers on the same host can instead read the messages from a named shm_ring, which is
+ * written without system calls.
+ * Payloads larger than the maximum datagram size are split into frames (see frame_protocol.hpp),
+ * which the networking_client reassembles.
+ * A sender can have several destinations, e.g. one per consumer of the same channels. The payload
+ * is serialized once and the same buffer is sent to every destination. All destinations share the
+ * socket of the first one. A destination can also be a multicast group, which the network delivers
+ * to all of its members. It is sent with the default TTL of 1 through the default interface, so it
+ * does not leave the local network.
+ * A destination like "unix:/tmp/cogna.sock" is a Unix domain datagram socket on the same host.
+ * Json payloads of registered channels are written from a template of the keys, which is built
+ * once when the channels change. Only the values are formatted per tick, into a reused buffer.
+ * The result is byte for byte what serializing the json object would give.
  *
  * @date 2021-05-27
  *
@@ -17,9 +34,18 @@
 #define NETWORKING_SENDER_HPP
 
 #include <string>
+#include <vector>
 #include <mutex>
+#include <cstdint>
 #include "json.hpp"
 #include "client_server.hpp"
+#include "latency_histogram.hpp"
+#include "shm_ring.hpp"
+#include "aligned_allocator.hpp"
+
+#ifndef DEFAULT_KEYFRAME_INTERVAL
+#define DEFAULT_KEYFRAME_INTERVAL 100
+#endif //DEFAULT_KEYFRAME_INTERVAL
 
 namespace utils{
 
@@ -34,6 +60,14 @@ public:
 	 */
 	networking_sender(std::string ip, int port);
 
+	/**
+	 * @brief Attaches to a shared memory ring, which is created if it does not exist yet.
+	 *
+	 * @param shm_name	The name of the shared memory, e.g. "/cogna_motors".
+	 *
+	 */
+	explicit networking_sender(std::string shm_name);
+
 	/**
 	 * @brief Closes UDP socket.
 	 *
@@ -43,16 +77,41 @@ public:
 	/**
 	 * @brief Returns the given ip address of the socket.
 	 *
+	 * @param destination	The index of the destination, 0 for the one given to the constructor.
+	 *
 	 * @return The ip address as string.
 	 */
-	std::string get_ip();
+	std::string get_ip(int destination=0);
 
 	/**
 	 * @brief Returns the given port of the socket.
 	 *
-	 * @return The port as integer.
+	 * @param destination	The index of the destination, 0 for the one given to the constructor.
+	 *
+	 * @return The port as integer. 0 for a shared memory ring.
+	 */
+	int get_port(int destination=0);
+
+	/**
+	 * @brief Adds a destination, which is sent the same payload. Must use the address family of the first one.
+	 *
+	 * @param ip	The ip of the destination. Can be a multicast group, which is only reached within the local network.
+	 * @param port	The port of the destination.
+	 *
+	 * @return		0 on success or if the destination already exists, -1 if it is invalid or the sender
+	 *				writes into a shared memory ring.
 	 */
-	int get_port();
+	int add_destination(std::string ip, int port);
+
+	/**
+	 * @brief Returns the number of destinations. 0 for a shared memory ring.
+	 */
+	int get_destination_number();
+
+	/**
+	 * @brief Returns true if the sender writes into a shared memory ring instead of a socket.
+	 */
+	bool is_local();
 
 	/**
 	 * @brief Adds data to the json payload.
@@ -68,6 +127,166 @@ public:
 	void add_data(std::string key, int value);
 	void add_data(std::string key, std::string value);
 
+	/**
+	 * @brief Adds data to the binary payload. Values added to the same channel are summed up.
+	 *
+	 * Only sent if the sender uses one of the binary formats.
+	 *
+	 * @param channel_index	The index of the channel in the binary message.
+	 * @param value			The value to add.
+	 *
+	 */
+	void add_binary_data(int channel_index, float value);
+
+	/**
+	 * @brief Registers a channel which is written via add_slot_data().
+	 *
+	 * Called while building the cluster, so that writing a channel during a tick needs no lookup.
+	 * Registering the same channel twice returns the same slot.
+	 *
+	 * @param key			The key of the channel in json messages.
+	 * @param channel_index	The index of the channel in binary messages.
+	 *
+	 * @return				The slot of the channel.
+	 */
+	int register_channel(std::string key, int channel_index);
+
+	/**
+	 * @brief Adds a value to a registered channel. Values added to the same channel are summed up.
+	 *
+	 * @param slot		The slot returned by register_channel().
+	 * @param value		The value to add.
+	 * @param arrival	The arrival of the newest input influencing the value in nanoseconds since epoch.
+	 *					0 if unknown. When the payload is sent, the time since the arrival is recorded
+	 *					as latency of the channel.
+	 *
+	 */
+	void add_slot_data(int slot, float value, int64_t arrival=0);
+
+	/**
+	 * @brief Registers a writer of a channel, which accumulates its values without locking.
+	 *
+	 * Every writer has its own buffer, so writers used by different threads never contend.
+	 * The buffers are merged into their channels, summing up their values, when the payload is serialized.
+	 * A writer must only be used by one thread at a time, and not while the payload is serialized.
+	 *
+	 * @param slot	The slot returned by register_channel().
+	 *
+	 * @return		The index of the writer.
+	 */
+	int register_writer(int slot);
+
+	/**
+	 * @brief Adds a value to the buffer of a writer.
+	 *
+	 * @param writer	The index returned by register_writer().
+	 * @param value		The value to add.
+	 * @param arrival	The arrival of the newest input influencing the value in nanoseconds since epoch. 0 if unknown.
+	 *
+	 */
+	void add_writer_data(int writer, float value, int64_t arrival=0);
+
+	/**
+	 * @brief Returns the number of registered channels.
+	 */
+	int get_channel_number();
+
+	/**
+	 * @brief Returns the key of a registered channel.
+	 */
+	std::string get_channel_key(int slot);
+
+	/**
+	 * @brief Returns the index of a registered channel in binary messages.
+	 */
+	int get_channel_index(int slot);
+
+	/**
+	 * @brief Returns the latencies from input arrival to sending recorded for a registered channel.
+	 */
+	const latency_histogram& get_channel_latency(int slot);
+
+	/**
+	 * @brief Sets the format the payload is sent in.
+	 *
+	 * @param format	FORMAT_JSON, FORMAT_BINARY_PAIRS or FORMAT_BINARY_DENSE.
+	 *
+	 */
+	void set_format(int format);
+
+	/**
+	 * @brief Returns the format the payload is sent in.
+	 *
+	 * @return The format.
+	 */
+	int get_format();
+
+	/**
+	 * @brief Enables the delta mode. Not supported by FORMAT_BINARY_DENSE, which always contains every channel.
+	 *
+	 * @param epsilon			Channels are sent if their value differs by more than epsilon from the value sent last.
+	 * @param keyframe_interval	Every keyframe_interval payloads all channels are sent. At least 1.
+	 *
+	 */
+	void set_delta_mode(float epsilon, int keyframe_interval);
+
+	/**
+	 * @brief Marks every payload as delta, so that receivers keep the channels it does not contain.
+	 *
+	 * Unlike the delta mode, unchanged values are still sent. Payloads without any channel are not sent.
+	 * Not supported by FORMAT_BINARY_DENSE, which always contains every channel.
+	 *
+	 * @param is_partial	True to mark every payload as delta.
+	 */
+	void set_partial(bool is_partial);
+
+	/**
+	 * @brief Returns if every payload is marked as delta.
+	 */
+	bool is_partial();
+
+	/**
+	 * @brief Echoes the sequence number of a request in every json payload, as the key "reply".
+	 *
+	 * Used by the request tick mode, so a controller can match the outputs to its request.
+	 * Binary payloads do not carry it.
+	 *
+	 * @param sequence	The sequence number of the request. Negative to stop echoing it.
+	 */
+	void set_reply_sequence(int64_t sequence);
+
+	/**
+	 * @brief Returns if the delta mode is enabled, its epsilon and its keyframe interval.
+	 */
+	bool is_delta();
+	float get_delta_epsilon();
+	int get_keyframe_interval();
+
+	/**
+	 * @brief Sets the size of the largest datagram sent. Larger payloads are split into frames.
+	 *
+	 * @param size	The size in bytes, at most UDP_MAX_PAYLOAD. 0 for UDP_MAX_PAYLOAD.
+	 *
+	 * @return		0 on success, -1 if the size is too small to hold a frame or too large for UDP.
+	 */
+	int set_max_datagram_size(size_t size);
+
+	/**
+	 * @brief Returns the size of the largest datagram sent in bytes.
+	 */
+	size_t get_max_datagram_size();
+
+	/**
+	 * @brief Splits a serialized payload into frames of the maximum datagram size.
+	 *
+	 * @param payload		The payload returned by serialize_payload().
+	 * @param frame_number	Filled with the number of frames.
+	 *
+	 * @return				The frames back to back, every frame but the last one get_max_datagram_size() bytes large.
+	 *						Valid until the next call. Empty if the payload is too large to be framed.
+	 */
+	const std::string& frame_payload(const std::string &payload, int *frame_number);
+
 	/**
 	 * @brief Removes a single key-value pair from the json, if it exists.
 	 *
@@ -93,17 +312,125 @@ public:
 	std::string stringify_payload(int indent=-1);
 
 	/**
-	 * @brief Sends the whole payload at once to the designated ip and port.
+	 * @brief Serializes the whole payload into the send buffer of the sender and clears it.
+	 *
+	 * @param time_in_ns	The time of sending in nanoseconds since epoch. Written into the payload in milliseconds.
+	 *
+	 * @return				The serialized json or binary datagram. Valid until the next call.
+	 *						Empty in delta mode, if nothing changed.
+	 */
+	const std::string& serialize_payload(int64_t time_in_ns);
+
+	/**
+	 * @brief Returns the address of the designated ip and port. nullptr for a shared memory ring.
 	 *
-	 * The json payload sent is cleared afterwards.
+	 * @param destination	The index of the destination, 0 for the one given to the constructor.
+	 */
+	const struct addrinfo* get_addrinfo(int destination=0);
+
+	/**
+	 * @brief Sends the whole payload at once to all designated ips and ports.
+	 *
+	 * Sends the json payload or the binary payload, depending on the format of the sender.
+	 * The payload sent is cleared afterwards.
 	 *
 	 */
 	void send_payload();
 
+	/**
+	 * @brief Sends the whole payload at once, stamped with the given time.
+	 *
+	 * @param time_in_ns	The time of sending in nanoseconds since epoch.
+	 *
+	 * @return				false if nothing was sent, because nothing changed in delta mode or the
+	 *						payload is too large for the shared memory ring.
+	 */
+	bool send_payload(int64_t time_in_ns);
+
+	/**
+	 * @brief Returns the number of payloads dropped, because they were larger than a slot of the shared memory ring.
+	 */
+	unsigned long long get_dropped_payloads();
+
 private:
+	/**
+	 * @brief The buffer of a writer. Takes a whole cache line, so that writers never share one.
+	 */
+	struct alignas(64) writer_buffer{
+		float value;
+		bool is_set;
+		int64_t arrival;
+		int slot;
+	};
+	static_assert(sizeof(writer_buffer) == 64, "A writer buffer must take a whole cache line.");
+
 	udp_client_server::udp_client *_sender;
+	std::vector<udp_client_server::udp_address*> _destinations;	// All destinations, sent through _sender
+	shm_ring *_local_ring;
 	nlohmann::json _payload;
 	std::mutex _payload_mutex;
+	int _format;
+	uint32_t _sequence;
+	int64_t _reply_sequence;		// Sequence of the request echoed in json payloads, -1 if none
+	std::vector<float> _binary_values;
+	std::vector<bool> _binary_is_set;
+	std::string _send_buffer;
+	std::string _frame_buffer;
+	size_t _max_datagram_size;
+	std::vector<std::string> _slot_keys;
+	std::vector<int> _slot_indices;
+	std::vector<float> _slot_values;
+	std::vector<bool> _slot_is_set;
+	std::vector<int64_t> _slot_arrivals;
+	std::vector<latency_histogram> _slot_latencies;
+	std::vector<writer_buffer, aligned_allocator<writer_buffer>> _writers;	// Every writer starts its own cache line
+	bool _is_delta;
+	bool _is_partial;
+	float _delta_epsilon;
+	int _keyframe_interval;
+	int _ticks_since_keyframe;
+	bool _is_keyframe;
+	bool _has_changes;
+	std::vector<float> _slot_sent_values;
+	std::vector<bool> _slot_was_sent;
+
+	/**
+	 * @brief A key of the json payload, in the order the keys are serialized.
+	 */
+	struct json_field{
+		std::string prefix;		// The quoted key followed by a colon
+		int kind;
+		std::vector<int> slots;	// The channels written to the key, summed up
+	};
+	std::vector<json_field> _json_fields;
+	size_t _json_field_slots;		// The number of channels the fields were built for
+	bool _is_json_templated;		// False if a channel uses a key of the header, like "time"
+
+	/**
+	 * @brief Warns that a multicast destination is sent with the default TTL and interface.
+	 */
+	void warn_multicast(const udp_client_server::udp_address &destination);
+
+	/**
+	 * @brief Sums the buffers of all writers into their channels and clears them.
+	 */
+	void merge_writers();
+
+	/**
+	 * @brief Moves the values of all registered channels into the json or binary payload
+	 *        and records their latencies. In delta mode only changed channels are moved.
+	 */
+	void flush_slots(int64_t time_in_ns);
+
+	/**
+	 * @brief Builds the sorted json fields of all registered channels and of the header.
+	 */
+	void build_json_fields();
+
+	/**
+	 * @brief Writes the registered channels and the header into the send buffer using the json fields.
+	 */
+	void write_json_payload(int64_t time_in_ms);
 };
 
 } //namespace utils
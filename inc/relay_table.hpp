@@ -0,0 +1,145 @@
+/**
+ * @file relay_table.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Forwards channels received by input nodes directly to the output nodes they are linked to.
+ *
+ * Links between an input node and an output node do not need any neuron. They are compiled
+ * into routes from a slot of a networking_client to a slot of a networking_sender, which are
+ * executed by the I/O layer instead of the networks.
+ *  - RELAY_TICK:      After the messages of a tick are stored, the received value of every route
+ *                     is added to a writer buffer of the sender, which is sent with the next payload.
+ *  - RELAY_IMMEDIATE: The receiving thread forwards every received message at once through a sender
+ *                     of its own to the destinations of the output node. All channels of one message
+ *                     routed to the same output node are sent in one payload. It only contains the
+ *                     relayed channels and is marked as delta, so receivers keep all other channels.
+ *                     A networking_client applies deltas in order even with EXCHANGE_LATEST, so
+ *                     relayed payloads and the tick payloads of the output node can share a port.
+ * As before, only values above 0 are forwarded.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef RELAY_TABLE_HPP
+#define RELAY_TABLE_HPP
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+#include "networking_client.hpp"
+#include "networking_sender.hpp"
+
+namespace utils{
+
+const int RELAY_TICK = 0;
+const int RELAY_IMMEDIATE = 1;
+
+/**
+ * @brief Converts the name of a relay mode used in the network files to its constant.
+ *
+ * @param name	"tick" or "immediate".
+ *
+ * @return		RELAY_TICK, RELAY_IMMEDIATE or -1 if the name is unknown.
+ */
+int parse_relay_mode(const std::string &name);
+
+class relay_table{
+public:
+	/**
+	 * @param is_tracing_latency	True to hand the arrival of relayed values to the senders, which record the latency.
+	 */
+	relay_table(bool is_tracing_latency=false);
+
+	/**
+	 * @brief Closes the senders of immediate routes. The receiving threads must be stopped before.
+	 */
+	~relay_table();
+
+	/**
+	 * @brief Adds a route. Must not be called while messages are received or forwarded.
+	 *
+	 * Adding the same route twice returns the existing one.
+	 *
+	 * @param client		The client receiving the channel.
+	 * @param client_slot	The slot of the channel at the client.
+	 * @param sender		The sender of the output node.
+	 * @param sender_slot	The slot of the channel at the sender.
+	 * @param mode			RELAY_TICK or RELAY_IMMEDIATE.
+	 *
+	 * @return				The index of the route, -1 if the sender cannot be relayed to immediately.
+	 */
+	int add_route(networking_client *client, int client_slot, networking_sender *sender, int sender_slot,
+				  int mode=RELAY_TICK);
+
+	/**
+	 * @brief Forwards the stored values of all tick routes to their senders. Called after the messages are stored.
+	 */
+	void forward();
+
+	/**
+	 * @brief Forwards the values of a received message through their immediate routes. Called by the receiving threads.
+	 *
+	 * Every relay sender reached by the message sends one payload with all of its routed values.
+	 *
+	 * @param client		The client which received the message.
+	 * @param client_slots	The slots of the received channels at the client.
+	 * @param values		The received values, one per slot.
+	 * @param number		The number of received values.
+	 * @param arrival		The arrival of the message in nanoseconds since epoch.
+	 */
+	void forward_received(networking_client *client, const int *client_slots, const float *values, int number,
+						  int64_t arrival);
+
+	/**
+	 * @brief Returns the number of routes.
+	 */
+	int get_route_number();
+
+private:
+	struct route{
+		networking_client *client;
+		int client_slot;
+		networking_sender *sender;
+		int sender_slot;
+		int mode;
+		int writer;			// The writer of tick routes at the sender
+		int relay;			// The relay sender of immediate routes
+		int relay_slot;
+	};
+
+	/**
+	 * @brief Sends the immediate routes towards the destinations of one output sender.
+	 */
+	struct relay_sender{
+		networking_sender *output;
+		networking_sender *sender;
+		std::mutex mutex;			// Receiving threads of different queues can relay at the same time
+	};
+
+	/**
+	 * @brief The immediate routes of one client.
+	 */
+	struct immediate_client{
+		std::vector<std::vector<int>> slot_routes;	// The routes of every client slot
+		std::vector<int> relays;					// The relay senders reached by any route, once each
+	};
+
+	std::vector<route> _routes;
+	std::vector<relay_sender*> _relays;
+	std::unordered_map<networking_client*, immediate_client> _immediate_routes;
+	bool _is_tracing_latency;
+
+	/**
+	 * @brief Returns the relay sender towards the destinations of an output sender, which is created if needed.
+	 *
+	 * @return	The index of the relay sender, -1 if the output sender cannot be relayed to.
+	 */
+	int get_relay(networking_sender *output);
+};
+
+} //namespace utils
+
+#endif //RELAY_TABLE_HPP
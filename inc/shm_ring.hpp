@@ -0,0 +1,160 @@
+/**
+ * @file shm_ring.hpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief A ring of messages in named POSIX shared memory for processes on the same host.
+ *
+ * One process writes, any number of processes read. The writer never waits: if a reader is
+ * too slow, its oldest unread messages are overwritten and counted as lost by the reader.
+ * Every slot is guarded by a sequence number, so readers detect messages overwritten while
+ * they were copied. Writing and reading need no system call. Readers can block in wait(),
+ * which sleeps on a futex in the shared memory. The writer only wakes it with a system call
+ * if a reader is actually waiting.
+ *
+ * Layout of the shared memory:
+ *   header (128 bytes): magic, version, slot size, slot number, head, futex word, waiter count
+ *   slots: sequence (8 bytes), length (4 bytes), reserved (4 bytes), timestamp (8 bytes), data
+ *
+ * Whichever side opens the ring first creates it, the other one attaches to it.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#ifndef SHM_RING_HPP
+#define SHM_RING_HPP
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#ifndef SHM_RING_SLOT_SIZE
+#define SHM_RING_SLOT_SIZE 8192
+#endif //SHM_RING_SLOT_SIZE
+
+#ifndef SHM_RING_SLOT_NUMBER
+#define SHM_RING_SLOT_NUMBER 64
+#endif //SHM_RING_SLOT_NUMBER
+
+namespace utils{
+
+class shm_ring{
+public:
+	shm_ring();
+
+	/**
+	 * @brief Unmaps the shared memory. The shared memory itself stays until it is unlinked.
+	 */
+	~shm_ring();
+
+	/**
+	 * @brief Creates the ring or attaches to an existing one.
+	 *
+	 * @param name			The name of the shared memory, e.g. "/cogna_sensors".
+	 * @param slot_size		The largest message in bytes. Ignored when attaching to an existing ring.
+	 * @param slot_number	The number of messages the ring holds. Ignored when attaching to an existing ring.
+	 *
+	 * @return				0 on success, -1 if the shared memory could not be opened or is not a ring.
+	 */
+	int open(const std::string &name, uint32_t slot_size=SHM_RING_SLOT_SIZE, uint32_t slot_number=SHM_RING_SLOT_NUMBER);
+
+	/**
+	 * @brief Writes a message. Only one process may write into a ring.
+	 *
+	 * @param data		The message.
+	 * @param size		The size of the message in bytes.
+	 * @param timestamp	The time of writing in nanoseconds since epoch.
+	 *
+	 * @return			false if the message is larger than a slot and was dropped.
+	 */
+	bool write(const char *data, size_t size, int64_t timestamp);
+
+	/**
+	 * @brief Reads the next unread message.
+	 *
+	 * @param out		Filled with the message.
+	 * @param timestamp	Filled with the time the message was written.
+	 * @param newest	True to skip to the newest message. Skipped messages are not counted as lost.
+	 *
+	 * @return			true if a message was read, false if there is no unread message.
+	 */
+	bool read(std::string &out, int64_t *timestamp, bool newest);
+
+	/**
+	 * @brief Waits until an unread message is available.
+	 *
+	 * @param timeout_ms	The longest time to wait in milliseconds.
+	 *
+	 * @return				true if an unread message is available.
+	 */
+	bool wait(int timeout_ms);
+
+	/**
+	 * @brief Waits until more messages than known were written. Does not read, so another thread can read meanwhile.
+	 *
+	 * @param head			The number of messages known to be written. Updated to the current number.
+	 * @param timeout_ms	The longest time to wait in milliseconds.
+	 *
+	 * @return				true if new messages were written.
+	 */
+	bool wait_beyond(uint64_t *head, int timeout_ms);
+
+	/**
+	 * @brief Returns the number of messages overwritten before this reader could read them.
+	 */
+	unsigned long long get_lost();
+
+	/**
+	 * @brief Returns the number of messages dropped by this writer, because they were larger than a slot.
+	 */
+	unsigned long long get_dropped();
+
+	/**
+	 * @brief Returns the name of the shared memory.
+	 */
+	std::string get_name();
+
+	/**
+	 * @brief Removes the shared memory with the given name. Processes still attached keep their mapping.
+	 */
+	static void unlink(const std::string &name);
+
+private:
+	struct ring_header{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t slot_size;
+		uint32_t slot_number;
+		char _padding0[48];
+		std::atomic<uint64_t> head;			// Number of messages ever written
+		std::atomic<uint32_t> signal;		// Futex word, counted up when waiting readers are woken
+		std::atomic<uint32_t> waiters;
+		char _padding1[48];
+	};
+	static_assert(sizeof(ring_header) == 128, "Layout of the shared memory must not depend on the compiler.");
+
+	struct slot_header{
+		std::atomic<uint64_t> sequence;		// 2 * (index + 1) when message index is complete, odd while written
+		uint32_t length;
+		uint32_t reserved;
+		int64_t timestamp;
+	};
+
+	std::string _name;
+	void *_memory;
+	size_t _memory_size;
+	ring_header *_header;
+	char *_slots;
+	size_t _slot_stride;
+	uint64_t _next_read;
+	uint64_t _next_write;
+	unsigned long long _lost;
+	unsigned long long _dropped;
+
+	slot_header* slot(uint64_t index);
+};
+
+} //namespace utils
+
+#endif //SHM_RING_HPP
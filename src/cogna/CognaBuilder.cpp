@@ -16,6 +16,8 @@
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <type_traits>
 
 namespace COGNA{
 
@@ -23,7 +25,43 @@ CognaBuilder::CognaBuilder(std::string project_name){
     _project_name = project_name;
     _project_path = "../../Projects/" + project_name + "/";
     _frequency = 0;
+    _neuron_ordering = NEURON_ORDERING_NONE;
+    _receive_policy = utils::EXCHANGE_LATEST;
+    _io_threads = 1;
+    _is_tracing_latency = false;
+    _tick_mode = TICK_MODE_PERIODIC;
+    _min_tick_interval = 0;
+    _ticks_per_request = 1;
+    _max_datagram_size = 0;
+    _receive_buffer_size = RECEIVE_BUFFER_MAX_SIZE;
     _curr_network_neuron_number = 0;
+    _relay_table = nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+template<typename T>
+void CognaBuilder::parse_number(const nlohmann::json &json, const std::string &key, T invalid, T *number){
+    *number = invalid;
+    if(json.find(key) == json.end()){
+        return;
+    }
+    try{
+        if(json[key].is_string()){
+            if(std::is_integral<T>::value){
+                *number = (T)std::stoll((std::string)json[key]);
+            }
+            else{
+                *number = (T)std::stod((std::string)json[key]);
+            }
+        }
+        else{
+            *number = json[key].get<T>();
+        }
+    }
+    catch(...){
+        *number = invalid;
+    }
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -61,7 +99,11 @@ void CognaBuilder::tester(){
     std::cout << std::endl;
 
     for(unsigned int i=0; i<_sender_list.size(); i++){
-        std::cout << "Sender -> " << _sender_list[i]->get_ip() << ":" << _sender_list[i]->get_port() << std::endl;
+        std::cout << "Sender ->";
+        for(int d=0; d < std::max(_sender_list[i]->get_destination_number(), 1); d++){
+            std::cout << " " << _sender_list[i]->get_ip(d) << ":" << _sender_list[i]->get_port(d);
+        }
+        std::cout << std::endl;
     }
     for(unsigned int i=0; i<_client_list.size(); i++){
         std::cout << "Client -> " << _client_list[i]->get_ip() << ":" << _client_list[i]->get_port() << std::endl;
@@ -86,12 +128,42 @@ std::vector<utils::networking_sender*> CognaBuilder::get_sender_list(){
     return _sender_list;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+utils::relay_table* CognaBuilder::get_relay_table(){
+    return _relay_table;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 int CognaBuilder::get_frequency(){
     return _frequency;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+int CognaBuilder::get_io_threads(){
+    return _io_threads;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int CognaBuilder::get_tick_mode(){
+    return _tick_mode;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int CognaBuilder::get_min_tick_interval(){
+    return _min_tick_interval;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int CognaBuilder::get_ticks_per_request(){
+    return _ticks_per_request;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 int CognaBuilder::build_cogna_cluster(){
@@ -101,6 +173,7 @@ int CognaBuilder::build_cogna_cluster(){
 
     std::cout << "[INFO] Loading global parameters." << std::endl;
     if(load_globals_file() == ERROR_CODE) return ERROR_CODE;
+    _relay_table = new utils::relay_table(_is_tracing_latency);
 
     std::cout << "[INFO] Loading transmitter file." << std::endl;
     if(load_transmitters() == ERROR_CODE) return ERROR_CODE;
@@ -116,8 +189,30 @@ int CognaBuilder::build_cogna_cluster(){
     std::cout << "[INFO] Compiling presynaptic connections." << std::endl;
     if(create_presynaptic_connections() == ERROR_CODE) return ERROR_CODE;
 
+    // The io reactor spreads the receive queues of a port over its threads, so fewer threads than queues
+    // leave several queues of one port on the same thread
+    int max_queue_number = 1;
+    for(unsigned int i=0; i < _client_list.size(); i++){
+        max_queue_number = std::max(max_queue_number, _client_list[i]->get_queue_number());
+    }
+    if(_io_threads == 0){
+        _io_threads = max_queue_number;
+    }
+    else if(_io_threads < max_queue_number){
+        std::cout << "[WARNING] io_threads is " << _io_threads << ", but a port has " << max_queue_number
+                  << " receive_queues. Some queues share a thread." << std::endl;
+    }
+
+    if(_neuron_ordering != NEURON_ORDERING_NONE){
+        std::cout << "[INFO] Reordering neurons." << std::endl;
+        for(unsigned int i=0; i < _network_list.size(); i++){
+            if(_network_list[i]->reorder_neurons(_neuron_ordering, _network_list) == ERROR_CODE) return ERROR_CODE;
+        }
+    }
+
     for(unsigned int i=0; i < _network_list.size(); i++){
         if(_network_list[i]->setup_network() == ERROR_CODE) return ERROR_CODE;
+        _network_list[i]->set_latency_tracing(_is_tracing_latency);
     }
 
     return SUCCESS_CODE;
@@ -141,6 +236,122 @@ int CognaBuilder::load_globals_file(){
     _frequency = std::stoi((std::string)global_json["frequency"]);
     _main_network = global_json["main_network"];
 
+    _neuron_ordering = NEURON_ORDERING_NONE;
+    if(global_json.find("neuron_ordering") != global_json.end()){
+        std::string ordering = global_json["neuron_ordering"];
+        if(ordering == "bfs"){
+            _neuron_ordering = NEURON_ORDERING_BFS;
+        }
+        else if(ordering == "rcm"){
+            _neuron_ordering = NEURON_ORDERING_RCM;
+        }
+        else if(ordering == "degree"){
+            _neuron_ordering = NEURON_ORDERING_DEGREE;
+        }
+        else if(ordering != "none"){
+            std::cout << "[ERROR] Invalid neuron_ordering <" << ordering << "> in global.config of project "
+                      << _project_name << ". Use none, bfs, rcm or degree." << std::endl;
+            return ERROR_CODE;
+        }
+    }
+
+    _receive_policy = utils::EXCHANGE_LATEST;
+    if(global_json.find("receive_policy") != global_json.end()){
+        std::string policy = global_json["receive_policy"];
+        if(policy == "queue"){
+            _receive_policy = utils::EXCHANGE_QUEUE;
+        }
+        else if(policy != "latest"){
+            std::cout << "[ERROR] Invalid receive_policy <" << policy << "> in global.config of project "
+                      << _project_name << ". Use latest or queue." << std::endl;
+            return ERROR_CODE;
+        }
+    }
+
+    // 0 starts one thread per receive queue of the busiest port once the nodes are loaded
+    _io_threads = 0;
+    if(global_json.find("io_threads") != global_json.end()){
+        parse_number(global_json, "io_threads", 0, &_io_threads);
+        if(_io_threads < 1){
+            std::cout << "[ERROR] Invalid io_threads in global.config of project "
+                      << _project_name << ". Use a number of at least 1." << std::endl;
+            return ERROR_CODE;
+        }
+    }
+
+    _is_tracing_latency = false;
+    if(global_json.find("latency_tracing") != global_json.end()){
+        nlohmann::json tracing = global_json["latency_tracing"];
+        if(tracing == true || tracing == "true"){
+            _is_tracing_latency = true;
+        }
+        else if(tracing != false && tracing != "false"){
+            std::cout << "[ERROR] Invalid latency_tracing in global.config of project "
+                      << _project_name << ". Use true or false." << std::endl;
+            return ERROR_CODE;
+        }
+    }
+
+    _tick_mode = TICK_MODE_PERIODIC;
+    if(global_json.find("tick_mode") != global_json.end()){
+        std::string mode = global_json["tick_mode"];
+        if(mode == "input"){
+            _tick_mode = TICK_MODE_INPUT;
+        }
+        else if(mode == "request"){
+            _tick_mode = TICK_MODE_REQUEST;
+        }
+        else if(mode != "periodic"){
+            std::cout << "[ERROR] Invalid tick_mode <" << mode << "> in global.config of project "
+                      << _project_name << ". Use periodic, input or request." << std::endl;
+            return ERROR_CODE;
+        }
+    }
+
+    _min_tick_interval = 0;
+    if(global_json.find("min_tick_interval") != global_json.end()){
+        parse_number(global_json, "min_tick_interval", -1, &_min_tick_interval);
+        if(_min_tick_interval < 0){
+            std::cout << "[ERROR] Invalid min_tick_interval in global.config of project "
+                      << _project_name << ". Use a number of microseconds of at least 0." << std::endl;
+            return ERROR_CODE;
+        }
+    }
+
+    // A request passes one network or hop per tick, so deeper clusters need several ticks to answer it
+    _ticks_per_request = 1;
+    if(global_json.find("ticks_per_request") != global_json.end()){
+        parse_number(global_json, "ticks_per_request", 0, &_ticks_per_request);
+        if(_ticks_per_request < 1){
+            std::cout << "[ERROR] Invalid ticks_per_request in global.config of project "
+                      << _project_name << ". Use a number of at least 1." << std::endl;
+            return ERROR_CODE;
+        }
+    }
+
+    _max_datagram_size = 0;
+    if(global_json.find("max_datagram_size") != global_json.end()){
+        parse_number(global_json, "max_datagram_size", -1, &_max_datagram_size);
+        if(_max_datagram_size != 0 && (_max_datagram_size <= (int)utils::FRAME_HEADER_SIZE ||
+                                       _max_datagram_size > (int)utils::UDP_MAX_PAYLOAD)){
+            std::cout << "[ERROR] Invalid max_datagram_size in global.config of project "
+                      << _project_name << ". Use a number of bytes between " << utils::FRAME_HEADER_SIZE + 1
+                      << " and " << utils::UDP_MAX_PAYLOAD << "." << std::endl;
+            return ERROR_CODE;
+        }
+    }
+
+    _receive_buffer_size = RECEIVE_BUFFER_MAX_SIZE;
+    if(global_json.find("receive_buffer_size") != global_json.end()){
+        parse_number(global_json, "receive_buffer_size", -1, &_receive_buffer_size);
+        if(_receive_buffer_size < RECEIVE_BUFFER_MIN_SIZE || _receive_buffer_size > RECEIVE_BUFFER_MAX_SIZE){
+            std::cout << "[ERROR] Invalid receive_buffer_size in global.config of project "
+                      << _project_name << ". Use a number of bytes between " << RECEIVE_BUFFER_MIN_SIZE
+                      << " and " << RECEIVE_BUFFER_MAX_SIZE << "." << std::endl;
+            return ERROR_CODE;
+        }
+    }
+
     return SUCCESS_CODE;
 }
 
@@ -279,12 +490,50 @@ int CognaBuilder::load_nodes(NeuralNetwork *nn, nlohmann::json network_json){
             std::string ip = "0.0.0.0";
             int port = 0;
             std::string channel;
-            try{
-                port = std::stoi((std::string)network_json["nodes"][i]["port"]);
+            std::string shm_name;
+            if(network_json["nodes"][i].find("transport") != network_json["nodes"][i].end()){
+                std::string transport;
+                try{
+                    transport = network_json["nodes"][i]["transport"];
+                }
+                catch(...){
+                    transport = "";
+                }
+                if(transport == "shm"){
+                    try{
+                        shm_name = network_json["nodes"][i]["shm_name"];
+                    }
+                    catch(...){
+                        shm_name = "";
+                    }
+                    if(shm_name.size() < 2 || shm_name[0] != '/' || shm_name.find('/', 1) != std::string::npos){
+                        std::cout << "[ERROR] Cannot parse shm_name of node. Use a name like \"/cogna_sensors\"." << std::endl;
+                        return ERROR_CODE;
+                    }
+                }
+                else if(transport != "udp"){
+                    std::cout << "[ERROR] Invalid transport of node. Use udp or shm." << std::endl;
+                    return ERROR_CODE;
+                }
             }
-            catch(...){
-                std::cout << "[ERROR] Cannot parse port number of node." << std::endl;
-                return ERROR_CODE;
+            // Nodes on the same host can use a Unix domain socket path like "unix:/tmp/cogna.sock" instead of a port
+            bool is_unix = false;
+            if(shm_name.empty() && network_json["nodes"][i].find("ip_address") != network_json["nodes"][i].end() &&
+               network_json["nodes"][i]["ip_address"].is_string()){
+                std::string address = network_json["nodes"][i]["ip_address"];
+                if(udp_client_server::is_unix_address(address)){
+                    ip = address;
+                    is_unix = true;
+                }
+            }
+            if(shm_name.empty() && !is_unix){
+                try{
+                    port = std::stoi((std::string)network_json["nodes"][i]["port"]);
+                }
+                catch(...){
+                    std::cout << "[ERROR] Cannot parse port number of node." << std::endl;
+                    return ERROR_CODE;
+                }
             }
             try{
                 channel = network_json["nodes"][i]["channel"];
@@ -293,33 +542,195 @@ int CognaBuilder::load_nodes(NeuralNetwork *nn, nlohmann::json network_json){
                 std::cout << "[ERROR] Cannot parse channel of node." << std::endl;
                 return ERROR_CODE;
             }
+
+            int format = utils::FORMAT_JSON;
+            int channel_index = 0;
+            if(network_json["nodes"][i].find("format") != network_json["nodes"][i].end()){
+                try{
+                    format = utils::parse_format(network_json["nodes"][i]["format"]);
+                }
+                catch(...){
+                    format = -1;
+                }
+                if(format == -1){
+                    std::cout << "[ERROR] Invalid format of node. Use json, binary or binary_dense." << std::endl;
+                    return ERROR_CODE;
+                }
+            }
+            if(format != utils::FORMAT_JSON){
+                parse_number(network_json["nodes"][i], "channel_index", -1, &channel_index);
+                if(channel_index < 0 || (unsigned int)channel_index >= utils::BINARY_MAX_CHANNELS){
+                    std::cout << "[ERROR] Cannot parse channel_index of binary node." << std::endl;
+                    return ERROR_CODE;
+                }
+            }
+
+            int aggregation = utils::AGGREGATE_LAST;
+            if(network_json["nodes"][i].find("aggregation") != network_json["nodes"][i].end()){
+                try{
+                    aggregation = utils::parse_aggregation(network_json["nodes"][i]["aggregation"]);
+                }
+                catch(...){
+                    aggregation = -1;
+                }
+                if(aggregation == -1){
+                    std::cout << "[ERROR] Invalid aggregation of node. Use last, sum, mean or max." << std::endl;
+                    return ERROR_CODE;
+                }
+            }
+
+            // A vector channel activates the neurons from population_start on, one per element
+            int width = 1;
+            int population_start = 0;
+            if(network_json["nodes"][i].find("width") != network_json["nodes"][i].end()){
+                try{
+                    width = network_json["nodes"][i]["width"];
+                }
+                catch(...){
+                    width = 0;
+                }
+                if(width < 1 || (format != utils::FORMAT_JSON &&
+                                 (unsigned int)(channel_index + width) > utils::BINARY_MAX_CHANNELS)){
+                    std::cout << "[ERROR] Invalid width of node." << std::endl;
+                    return ERROR_CODE;
+                }
+            }
+            if(width > 1){
+                if(network_json["nodes"][i]["function"] != "interface_input"){
+                    std::cout << "[ERROR] Only input nodes can have a width." << std::endl;
+                    return ERROR_CODE;
+                }
+                try{
+                    population_start = network_json["nodes"][i]["population_start"];
+                }
+                catch(...){
+                    std::cout << "[ERROR] Cannot parse population_start of vector node." << std::endl;
+                    return ERROR_CODE;
+                }
+            }
+
             int networking_id = 0;
 
             if(network_json["nodes"][i]["function"] == "interface_input"){
+                // Several receiving threads can share a busy port, each with its own socket
+                int receive_queues = 1;
+                bool has_queues = network_json["nodes"][i].find("receive_queues") != network_json["nodes"][i].end();
+                if(has_queues){
+                    parse_number(network_json["nodes"][i], "receive_queues", 0, &receive_queues);
+                    if(receive_queues < 1 || receive_queues > RECEIVE_QUEUES_MAX){
+                        std::cout << "[ERROR] receive_queues of node must be between 1 and "
+                                  << RECEIVE_QUEUES_MAX << "." << std::endl;
+                        return ERROR_CODE;
+                    }
+                    if(!shm_name.empty() || is_unix){
+                        std::cout << "[ERROR] Only udp nodes with a port can have receive_queues." << std::endl;
+                        return ERROR_CODE;
+                    }
+                }
+
+                // Links to output nodes are forwarded once per tick or by the receiving thread on arrival
+                int relay_mode = utils::RELAY_TICK;
+                if(network_json["nodes"][i].find("relay") != network_json["nodes"][i].end()){
+                    try{
+                        relay_mode = utils::parse_relay_mode(network_json["nodes"][i]["relay"]);
+                    }
+                    catch(...){
+                        relay_mode = -1;
+                    }
+                    if(relay_mode == -1){
+                        std::cout << "[ERROR] Invalid relay of node. Use tick or immediate." << std::endl;
+                        return ERROR_CODE;
+                    }
+                    if(relay_mode == utils::RELAY_IMMEDIATE && !shm_name.empty()){
+                        std::cout << "[ERROR] Only udp nodes can relay immediately." << std::endl;
+                        return ERROR_CODE;
+                    }
+                }
+
                 bool client_does_exist = false;
                 for(unsigned int j=0; j < _client_list.size(); j++){
-                    if(_client_list[j]->get_port() == port){
+                    if(_client_list[j]->get_shm_name() == shm_name && _client_list[j]->get_port() == port &&
+                       (!shm_name.empty() || _client_list[j]->get_ip() == ip)){
                         client_does_exist = true;
                         networking_id = j;
                     }
                 }
+                if(client_does_exist && has_queues && _client_list[networking_id]->get_queue_number() != receive_queues){
+                    std::cout << "[ERROR] Input nodes receiving on port " << port
+                              << " use different receive_queues." << std::endl;
+                    return ERROR_CODE;
+                }
                 if(!client_does_exist){
                     networking_id = _client_list.size();
-                    utils::networking_client *temp_client = new utils::networking_client(ip, port, true);
+                    utils::networking_client *temp_client = nullptr;
+                    if(!shm_name.empty()){
+                        try{
+                            temp_client = new utils::networking_client(shm_name, true, _receive_policy);
+                        }
+                        catch(...){
+                            std::cout << "[ERROR] Cannot open shared memory ring " << shm_name << " of node." << std::endl;
+                            return ERROR_CODE;
+                        }
+                    }
+                    else{
+                        try{
+                            temp_client = new utils::networking_client(ip, port, true, _receive_policy, receive_queues);
+                        }
+                        catch(...){
+                            std::cout << "[ERROR] Cannot receive on " << (is_unix ? ip : "port " + std::to_string(port))
+                                      << " of node." << std::endl;
+                            return ERROR_CODE;
+                        }
+                        if(temp_client->set_receive_buffer_size(_receive_buffer_size) != 0){
+                            delete temp_client;
+                            return ERROR_CODE;
+                        }
+                    }
                     _client_list.push_back(temp_client);
                 }
 
                 int node_id = network_json["nodes"][i]["id"];
-                nn->add_extern_input_node(node_id, _client_list[networking_id], channel);
+                if(nn->add_extern_input_node(node_id, _client_list[networking_id], channel, format, channel_index,
+                                             aggregation, width, population_start) == ERROR_CODE){
+                    return ERROR_CODE;
+                }
+                nn->_extern_input_nodes.back()->set_relay_mode(relay_mode);
             }
 
             else if(network_json["nodes"][i]["function"] == "interface_output"){
-                try{
-                    ip = network_json["nodes"][i]["ip_address"];
+                if(!shm_name.empty()){
+                    ip = "shm:" + shm_name;
                 }
-                catch(...){
-                    std::cout << "[ERROR] Cannot parse ip address of node." << std::endl;
-                    return ERROR_CODE;
+                else{
+                    try{
+                        ip = network_json["nodes"][i]["ip_address"];
+                    }
+                    catch(...){
+                        std::cout << "[ERROR] Cannot parse ip address of node." << std::endl;
+                        return ERROR_CODE;
+                    }
+                }
+
+                bool is_delta = network_json["nodes"][i].find("delta_epsilon") != network_json["nodes"][i].end();
+                float delta_epsilon = 0.0f;
+                int keyframe_interval = DEFAULT_KEYFRAME_INTERVAL;
+                if(is_delta){
+                    parse_number(network_json["nodes"][i], "delta_epsilon", -1.0f, &delta_epsilon);
+                    if(delta_epsilon < 0.0f){
+                        std::cout << "[ERROR] Cannot parse delta_epsilon of node." << std::endl;
+                        return ERROR_CODE;
+                    }
+                    if(format == utils::FORMAT_BINARY_DENSE){
+                        std::cout << "[ERROR] Delta mode of node needs format json or binary." << std::endl;
+                        return ERROR_CODE;
+                    }
+                    if(network_json["nodes"][i].find("keyframe_interval") != network_json["nodes"][i].end()){
+                        parse_number(network_json["nodes"][i], "keyframe_interval", 0, &keyframe_interval);
+                        if(keyframe_interval < 1){
+                            std::cout << "[ERROR] Cannot parse keyframe_interval of node." << std::endl;
+                            return ERROR_CODE;
+                        }
+                    }
                 }
 
                 bool sender_does_exist = false;
@@ -331,12 +742,72 @@ int CognaBuilder::load_nodes(NeuralNetwork *nn, nlohmann::json network_json){
                 }
                 if(!sender_does_exist){
                     networking_id = _sender_list.size();
-                    utils::networking_sender *temp_sender = new utils::networking_sender(ip, port);
+                    utils::networking_sender *temp_sender = nullptr;
+                    if(!shm_name.empty()){
+                        try{
+                            temp_sender = new utils::networking_sender(shm_name);
+                        }
+                        catch(...){
+                            std::cout << "[ERROR] Cannot open shared memory ring " << shm_name << " of node." << std::endl;
+                            return ERROR_CODE;
+                        }
+                    }
+                    else{
+                        temp_sender = new utils::networking_sender(ip, port);
+                        if(temp_sender->set_max_datagram_size(_max_datagram_size) != 0){
+                            delete temp_sender;
+                            return ERROR_CODE;
+                        }
+                    }
+                    temp_sender->set_format(format);
+                    if(is_delta){
+                        temp_sender->set_delta_mode(delta_epsilon, keyframe_interval);
+                    }
                     _sender_list.push_back(temp_sender);
                 }
+                else if(_sender_list[networking_id]->get_format() != format){
+                    std::cout << "[ERROR] Output nodes sending to " << ip << ":" << port
+                              << " use different formats." << std::endl;
+                    return ERROR_CODE;
+                }
+                else if(_sender_list[networking_id]->is_delta() != is_delta ||
+                        (is_delta && (_sender_list[networking_id]->get_delta_epsilon() != delta_epsilon ||
+                                      _sender_list[networking_id]->get_keyframe_interval() != keyframe_interval))){
+                    std::cout << "[ERROR] Output nodes sending to " << ip << ":" << port
+                              << " use different delta settings." << std::endl;
+                    return ERROR_CODE;
+                }
+
+                // Further consumers of the payload, which is serialized once for all of them
+                if(network_json["nodes"][i].find("destinations") != network_json["nodes"][i].end()){
+                    if(!network_json["nodes"][i]["destinations"].is_array()){
+                        std::cout << "[ERROR] Destinations of node must be a list." << std::endl;
+                        return ERROR_CODE;
+                    }
+                    for(unsigned int d=0; d < network_json["nodes"][i]["destinations"].size(); d++){
+                        std::string destination_ip;
+                        int destination_port = 0;
+                        try{
+                            destination_ip = network_json["nodes"][i]["destinations"][d]["ip_address"];
+                        }
+                        catch(...){
+                            destination_ip = "";
+                        }
+                        if(!udp_client_server::is_unix_address(destination_ip)){
+                            parse_number(network_json["nodes"][i]["destinations"][d], "port", -1, &destination_port);
+                        }
+                        if(destination_ip.empty() || destination_port < 0){
+                            std::cout << "[ERROR] Cannot parse ip address and port of destination of node." << std::endl;
+                            return ERROR_CODE;
+                        }
+                        if(_sender_list[networking_id]->add_destination(destination_ip, destination_port) != 0){
+                            return ERROR_CODE;
+                        }
+                    }
+                }
 
                 int node_id = network_json["nodes"][i]["id"];
-                nn->add_extern_output_node(node_id, _sender_list[networking_id], channel);
+                nn->add_extern_output_node(node_id, _sender_list[networking_id], channel, format, channel_index);
             }
         }
     }
@@ -446,20 +917,24 @@ int CognaBuilder::load_node_connection(NeuralNetwork *nn, nlohmann::json connect
             }
         }
 
+        if(target_node->width() > 1){
+            std::cout << "[ERROR] Node " << prev_id << " receives a vector channel and activates its population. "
+                      << "It cannot be connected." << std::endl;
+            return ERROR_CODE;
+        }
+
         if(connection_json["next_neuron_function"] == "neuron"){
             target_node->add_target(nn->_neurons[next_id]);
         }
         else if(connection_json["next_neuron_function"] == "interface_output"){
-            int output_node_id = (int)connection_json["next_neuron"] - 1;
-            std::string sender_ip = connection_json["nodes"][output_node_id]["ip_address"];
-            int sender_port = std::stoi((std::string)connection_json["nodes"][output_node_id]["port"]);
-            std::string sender_channel = connection_json["nodes"][output_node_id]["channel"];
-
+            // The link is executed by the relay table, without any neuron
             for(unsigned int ex_out=0; ex_out < nn->_extern_output_nodes.size(); ex_out++){
-                if(nn->_extern_output_nodes[ex_out]->_sender->get_ip() == sender_ip &&
-                        nn->_extern_output_nodes[ex_out]->_sender->get_port() == sender_port &&
-                        nn->_extern_output_nodes[ex_out]->channel() == sender_channel){
-                    target_node->add_target(nn->_extern_output_nodes[ex_out]);
+                NetworkingNode *output_node = nn->_extern_output_nodes[ex_out];
+                if(next_id == output_node->id()){
+                    if(_relay_table->add_route(target_node->_client, target_node->slot(), output_node->_sender,
+                                               output_node->slot(), target_node->relay_mode()) < 0){
+                        return ERROR_CODE;
+                    }
                 }
             }
         }
@@ -21,17 +21,38 @@ namespace COGNA{
 CognaLauncher::CognaLauncher(std::vector<NeuralNetwork*> network_list,
                              std::vector<utils::networking_client*> client_list,
                              std::vector<utils::networking_sender*> sender_list,
-                             int frequency){
+                             int frequency,
+                             int io_threads,
+                             int tick_mode,
+                             int min_tick_interval,
+                             utils::relay_table *relay_table,
+                             int ticks_per_request){
     _network_list = network_list;
     _client_list = client_list;
     _sender_list = sender_list;
+    _relay_table = relay_table;
     _frequency = frequency;
+    _io_threads = io_threads;
+    _tick_mode = tick_mode;
+    _min_tick_interval = min_tick_interval;
+    _ticks_per_request = ticks_per_request > 0 ? ticks_per_request : 1;
+    _request_ticks = 0;
+    _seen_input = 0;
+    _reactor = nullptr;
+    _batch_sender = nullptr;
     _curr_cluster_step = new unsigned long long(0);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
 CognaLauncher::~CognaLauncher(){
+    delete _reactor;    // Joins the receiving threads before their clients are freed
+    _reactor = nullptr;
+    delete _batch_sender;
+    _batch_sender = nullptr;
+    delete _relay_table;    // After the reactor, whose receiving threads forward its immediate routes
+    _relay_table = nullptr;
+
     for(unsigned int i=0; i < _network_list.size(); i++){
         delete _network_list[i];
         _network_list[i] = nullptr;
@@ -44,10 +65,6 @@ CognaLauncher::~CognaLauncher(){
         delete _client_list[i];
         _client_list[i] = nullptr;
     }
-    for(unsigned int i=0; i < _client_worker_list.size(); i++){
-        delete _client_worker_list[i];
-        _client_worker_list[i] = nullptr;
-    }
 
     delete _curr_cluster_step;
 }
@@ -67,11 +84,14 @@ int CognaLauncher::run_cogna(){
               << std::endl << std::endl;
 
     struct timeval _cluster_time;
-    long curr_time, prev_time, time_delta, sleep_time = 0;
+    long curr_time, prev_time;
 
     std::condition_variable *thread_condition_lock = new std::condition_variable;
 
-    create_networking_workers();
+    if(create_networking_workers() == ERROR_CODE){
+        delete thread_condition_lock;
+        return ERROR_CODE;
+    }
     create_cogna_workers(thread_condition_lock);
 
     usleep(100000); //wait 0.1 seconds to ensure networking sockets and networks to connect
@@ -85,6 +105,13 @@ int CognaLauncher::run_cogna(){
             for(unsigned int i=0; i < _client_list.size(); i++){
                 _client_list[i]->store_message();
             }
+            // The first tick of a request
+            if(_tick_mode == TICK_MODE_REQUEST && _request_ticks == _ticks_per_request){
+                echo_request_sequence();
+            }
+            if(_relay_table != nullptr){
+                _relay_table->forward();
+            }
 
             for(unsigned int i=0; i < _network_list.size(); i++){
                 _network_list[i]->receive_data();   // Here happens seg fault
@@ -106,27 +133,26 @@ int CognaLauncher::run_cogna(){
                 _network_list[i]->_is_finished = false;
             }
 
-            for(unsigned int i=0; i < _sender_list.size(); i++){
-                _sender_list[i]->send_payload();
-            }
+            _batch_sender->flush();
 
             for(unsigned int i=0; i < _client_list.size(); i++){
                 _client_list[i]->clear_message();
             }
 
-            curr_time = utils::get_time_microsec(_cluster_time);
-
-            time_delta = curr_time - prev_time;
-            sleep_time = (MICROSECOND_FACTOR / _frequency) - time_delta;
-
             iterator ++;
 
-            if(sleep_time > 0){
-                usleep(sleep_time);
-            }
+            wait_for_next_tick(prev_time);
         }
     }
 
+    _reactor->stop();
+    if(_batch_sender->get_dropped() > 0){
+        std::cout << "[WARNING] " << _batch_sender->get_dropped() << " of "
+                  << _batch_sender->get_sent() + _batch_sender->get_dropped() << " output messages were dropped, "
+                  << _batch_sender->get_would_block() << " of them because the socket buffer was full." << std::endl;
+    }
+    print_latencies();
+
     for(unsigned int i=0; i < _cogna_worker_list.size(); i++){
         delete _cogna_worker_list[i];
         _cogna_worker_list[i] = nullptr;
@@ -142,14 +168,105 @@ int CognaLauncher::run_cogna(){
 //----------------------------------------------------------------------------------------------------------------------
 //
 int CognaLauncher::create_networking_workers(){
-    for(unsigned int i=0; i < _client_list.size(); i++){
-        std::thread *client_worker = new std::thread(&utils::networking_client::receive_message, _client_list[i]);
-        _client_worker_list.push_back(client_worker);
+    if(_tick_mode != TICK_MODE_PERIODIC){
+        for(unsigned int i=0; i < _client_list.size(); i++){
+            _client_list[i]->set_input_signal(&_input_signal);
+        }
+        _seen_input = _input_signal.get_counter();
+    }
+
+    _reactor = new utils::io_reactor(_client_list, _io_threads);
+    if(_reactor->start() != 0){
+        std::cout << "[ERROR] Could not start receiving messages." << std::endl;
+        return ERROR_CODE;
+    }
+
+    _batch_sender = new utils::batch_sender(_sender_list);
+    if(_batch_sender->open_sockets() != 0){
+        std::cout << "[ERROR] Could not start sending messages." << std::endl;
+        return ERROR_CODE;
     }
 
     return SUCCESS_CODE;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+void CognaLauncher::echo_request_sequence(){
+    int64_t sequence = -1;
+    for(unsigned int i=0; i < _client_list.size(); i++){
+        if(_client_list[i]->get_sequence(&sequence)){
+            break;
+        }
+    }
+    for(unsigned int i=0; i < _sender_list.size(); i++){
+        _sender_list[i]->set_reply_sequence(sequence);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void CognaLauncher::wait_for_next_tick(long tick_start){
+    struct timeval tick_time;
+    long time_delta = utils::get_time_microsec(tick_time) - tick_start;
+
+    if(_tick_mode == TICK_MODE_PERIODIC){
+        long sleep_time = (MICROSECOND_FACTOR / _frequency) - time_delta;
+        if(sleep_time > 0){
+            usleep(sleep_time);
+        }
+        return;
+    }
+
+    if(_tick_mode == TICK_MODE_INPUT){
+        // The frequency still ticks the cluster if no input arrives
+        long idle_time = (MICROSECOND_FACTOR / _frequency) - time_delta;
+        _input_signal.wait(&_seen_input, idle_time > 0 ? idle_time : 0);
+    }
+    else{
+        // The ticks of a request run back to back, so its input can pass several networks or hops
+        if(_request_ticks > 1){
+            _request_ticks--;
+            return;
+        }
+
+        // Waits in slices to notice a stopped cluster
+        while(!_input_signal.wait(&_seen_input, MICROSECOND_FACTOR / 10)){
+            if(NeuralNetwork::m_cluster_state == STATE_STOPPED){
+                return;
+            }
+        }
+        _request_ticks = _ticks_per_request;
+    }
+
+    // Input arriving faster than the minimum interval is aggregated into the next tick
+    time_delta = utils::get_time_microsec(tick_time) - tick_start;
+    if(time_delta < _min_tick_interval){
+        usleep(_min_tick_interval - time_delta);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void CognaLauncher::print_latencies(){
+    for(unsigned int i=0; i < _sender_list.size(); i++){
+        for(int slot=0; slot < _sender_list[i]->get_channel_number(); slot++){
+            const utils::latency_histogram &latency = _sender_list[i]->get_channel_latency(slot);
+            if(latency.get_count() == 0){
+                continue;
+            }
+
+            std::cout << "[INFO] Latency of channel <" << _sender_list[i]->get_channel_key(slot) << "> to "
+                      << _sender_list[i]->get_ip() << ":" << _sender_list[i]->get_port() << " in us: "
+                      << "n=" << latency.get_count()
+                      << " mean=" << latency.get_mean() / 1000
+                      << " p50<=" << latency.get_percentile(0.5) / 1000
+                      << " p99<=" << latency.get_percentile(0.99) / 1000
+                      << " max=" << latency.get_max() / 1000 << std::endl;
+        }
+    }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 int CognaLauncher::create_cogna_workers(std::condition_variable *thread_lock){
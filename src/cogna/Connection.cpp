@@ -84,6 +84,10 @@ namespace COGNA{
 
         last_presynaptic_activated_step = 0;
         last_activated_step = 0;
+        plasticity_events = 0;
+
+        fire_threshold = default_parameter->activation_threshold;
+        cache_parameter();
     }
 
     //----------------------------------------------------------------------------------------------------------------------
@@ -93,12 +97,23 @@ namespace COGNA{
         _parameter = NULL;
     }
 
+    //----------------------------------------------------------------------------------------------------------------------
+    //
+    void Connection::cache_parameter(){
+        activation_type = (int8_t)_parameter->activation_type;
+        activation_function = (int8_t)_parameter->activation_function;
+        transmitter_type = (int16_t)_parameter->transmitter_type;
+        if(prev_neuron != NULL){
+            fire_threshold = prev_neuron->_parameter->activation_threshold;
+        }
+    }
+
     //----------------------------------------------------------------------------------------------------------------------
     //
     void Connection::long_learning_weight_backfall(int64_t network_step){
         if(DEBUG_MODE && DEB_LONG_LEARNING_WEIGHT)
             printf("<%ld> C-%d -> Long learning weight before backfall = %.3f\n",
-                   network_step, prev_neuron->_id, long_learning_weight);
+                   network_step, prev_neuron->_id, (float)long_learning_weight);
 
         long_learning_weight =  MathUtils::calculate_static_gradient(long_learning_weight,
                                                               _parameter->long_learning_weight_backfall_steepness,
@@ -110,7 +125,7 @@ namespace COGNA{
 
         if(DEBUG_MODE && DEB_LONG_LEARNING_WEIGHT)
             printf("<%ld> C-%d -> Long learning weight after backfall = %.3f\n\n",
-                   network_step, prev_neuron->_id, long_learning_weight);
+                   network_step, prev_neuron->_id, (float)long_learning_weight);
     }
 
     //----------------------------------------------------------------------------------------------------------------------
@@ -118,7 +133,7 @@ namespace COGNA{
     void Connection::long_learning_weight_reduction(int64_t network_step){
         if(DEBUG_MODE && DEB_LONG_LEARNING_WEIGHT)
             printf("<%ld> C-%d -> Long learning weight before reduction = %.3f\n",
-                   network_step, prev_neuron->_id, long_learning_weight);
+                   network_step, prev_neuron->_id, (float)long_learning_weight);
 
         long_learning_weight =  MathUtils::calculate_static_gradient(long_learning_weight,
                                                               _parameter->long_learning_weight_reduction_steepness,
@@ -129,32 +144,23 @@ namespace COGNA{
                                                               MIN_LONG_LEARNING_WEIGHT);
         if(DEBUG_MODE && DEB_LONG_LEARNING_WEIGHT)
             printf("<%ld> C-%d -> Long learning weight after reduction = %.3f\n\n",
-                   network_step, prev_neuron->_id, long_learning_weight);
+                   network_step, prev_neuron->_id, (float)long_learning_weight);
     }
 
     //----------------------------------------------------------------------------------------------------------------------
     //
-    void Connection::habituate(int64_t network_step, Connection *conditioning_con){
-        // TODO first part not good
-        float activation = prev_neuron->_activation;
-        float conditioning_type = NONDIRECTIONAL;
-
-        if(conditioning_con){
-            activation = conditioning_con->prev_neuron->_activation;
-            conditioning_type = conditioning_con->_parameter->activation_type;
-        }
-
+    void Connection::habituate(int64_t network_step, float activation, int conditioning_type){
         if((conditioning_type == NONDIRECTIONAL && activation < _parameter->habituation_threshold) ||
            (conditioning_type == INHIBITORY)){
             if(DEBUG_MODE && DEB_HABITUATION){
                 printf("<%ld> N-%d -> Short before habituation = %.5f\n",
-                       network_step, prev_neuron->_id, short_weight);
+                       network_step, prev_neuron->_id, (float)short_weight);
                 printf("<%ld> N-%d -> Long before habituation = %.5f\n",
-                       network_step, prev_neuron->_id, long_weight);
+                       network_step, prev_neuron->_id, (float)long_weight);
             }
             if(DEBUG_MODE && DEB_LONG_LEARNING_WEIGHT)
                 printf("<%ld> N-%d -> Learner before habituation = %.5f\n",
-                       network_step, prev_neuron->_id, long_learning_weight);
+                       network_step, prev_neuron->_id, (float)long_learning_weight);
 
             if(conditioning_type == NONDIRECTIONAL)
                 activation = _parameter->habituation_threshold - activation;
@@ -179,39 +185,30 @@ namespace COGNA{
 
             if(DEBUG_MODE && DEB_HABITUATION){
                 printf("<%ld> N-%d -> Short after habituation = %.5f\n",
-                       network_step, prev_neuron->_id, short_weight);
+                       network_step, prev_neuron->_id, (float)short_weight);
                 printf("<%ld> N-%d -> Long after habituation = %.5f\n",
-                       network_step, prev_neuron->_id, long_weight);
+                       network_step, prev_neuron->_id, (float)long_weight);
             }
             if(DEBUG_MODE && DEB_LONG_LEARNING_WEIGHT)
                 printf("<%ld> N-%d -> Learner after habituation = %.5f\n\n",
-                       network_step, prev_neuron->_id, long_learning_weight);
+                       network_step, prev_neuron->_id, (float)long_learning_weight);
         }
     }
 
     //----------------------------------------------------------------------------------------------------------------------
     //
-    void Connection::sensitize(int64_t network_step, Connection *conditioning_con){
-        // TODO first part not good
-        float activation = prev_neuron->_activation;
-        float conditioning_type = NONDIRECTIONAL;
-
-        if(conditioning_con){
-            activation = conditioning_con->prev_neuron->_activation;
-            conditioning_type = conditioning_con->_parameter->activation_type;
-        }
-
+    void Connection::sensitize(int64_t network_step, float activation, int conditioning_type){
         if((conditioning_type == NONDIRECTIONAL && activation > _parameter->sensitization_threshold) ||
            (conditioning_type == EXCITATORY)){
             if(DEBUG_MODE && DEB_SENSITIZATION){
                 printf("<%ld> N-%d -> Short before sensitization = %.5f\n",
-                       network_step,  prev_neuron->_id, short_weight);
+                       network_step,  prev_neuron->_id, (float)short_weight);
                 printf("<%ld> N-%d -> Long before sensitization = %.5f\n",
-                       network_step, prev_neuron->_id, long_weight);
+                       network_step, prev_neuron->_id, (float)long_weight);
             }
             if(DEBUG_MODE && DEB_LONG_LEARNING_WEIGHT)
                 printf("<%ld> N-%d -> Learner before sensitization = %.5f\n",
-                       network_step, prev_neuron->_id, long_learning_weight);
+                       network_step, prev_neuron->_id, (float)long_learning_weight);
 
             if(conditioning_type == NONDIRECTIONAL)
                 activation = activation - _parameter->sensitization_threshold;
@@ -236,13 +233,13 @@ namespace COGNA{
 
             if(DEBUG_MODE && DEB_SENSITIZATION){
                 printf("<%ld> N-%d -> Short after sensitization = %.5f\n",
-                       network_step, prev_neuron->_id, short_weight);
+                       network_step, prev_neuron->_id, (float)short_weight);
                 printf("<%ld> N-%d -> Long after sensitization = %.5f\n",
-                       network_step, prev_neuron->_id, long_weight);
+                       network_step, prev_neuron->_id, (float)long_weight);
             }
             if(DEBUG_MODE && DEB_LONG_LEARNING_WEIGHT)
                 printf("<%ld> N-%d -> Learner after sensitization = %.5f\n\n",
-                       network_step, prev_neuron->_id, long_learning_weight);
+                       network_step, prev_neuron->_id, (float)long_learning_weight);
         }
     }
 
@@ -251,9 +248,9 @@ namespace COGNA{
     void Connection::dehabituate(int64_t network_step){
         if(DEBUG_MODE && DEB_HABITUATION){
             printf("<%ld> N-%d -> Short before dehabituation = %.5f\n",
-                   network_step, prev_neuron->_id, short_weight);
+                   network_step, prev_neuron->_id, (float)short_weight);
             printf("<%ld> N-%d -> Long before dehabituation = %.5f\n",
-                   network_step, prev_neuron->_id, long_weight);
+                   network_step, prev_neuron->_id, (float)long_weight);
         }
 
         if(long_weight < base_weight){
@@ -278,9 +275,9 @@ namespace COGNA{
 
         if(DEBUG_MODE && DEB_HABITUATION){
             printf("<%ld> N-%d -> Short after dehabituation = %.5f\n",
-                   network_step, prev_neuron->_id, short_weight);
+                   network_step, prev_neuron->_id, (float)short_weight);
             printf("<%ld> N-%d -> Long after dehabituation = %.5f\n\n",
-                   network_step, prev_neuron->_id, long_weight);
+                   network_step, prev_neuron->_id, (float)long_weight);
         }
     }
 
@@ -289,9 +286,9 @@ namespace COGNA{
     void Connection::desensitize(int64_t network_step){
         if(DEBUG_MODE && DEB_SENSITIZATION){
             printf("<%ld> N-%d -> Short before desensitization = %.5f\n",
-                   network_step, prev_neuron->_id, short_weight);
+                   network_step, prev_neuron->_id, (float)short_weight);
             printf("<%ld> N-%d -> Long before desensitization = %.5f\n",
-                   network_step, prev_neuron->_id, long_weight);
+                   network_step, prev_neuron->_id, (float)long_weight);
         }
 
         if(long_weight > base_weight){
@@ -316,27 +313,54 @@ namespace COGNA{
 
         if(DEBUG_MODE && DEB_SENSITIZATION){
             printf("<%ld> N-%d -> Short after desensitization = %.5f\n",
-                   network_step, prev_neuron->_id, short_weight);
+                   network_step, prev_neuron->_id, (float)short_weight);
             printf("<%ld> N-%d -> Long after desensitization = %.5f\n\n",
-                   network_step, prev_neuron->_id, long_weight);
+                   network_step, prev_neuron->_id, (float)long_weight);
         }
     }
 
     //----------------------------------------------------------------------------------------------------------------------
     //
     void Connection::basic_learning(int64_t network_step, Connection *conditioning_con){
+        if(conditioning_con){
+            apply_learning(network_step, conditioning_con->prev_neuron->_activation,
+                           conditioning_con->_parameter->activation_type);
+        }
+        else{
+            apply_learning(network_step, prev_neuron->_activation, NONDIRECTIONAL);
+        }
+    }
+
+    //----------------------------------------------------------------------------------------------------------------------
+    //
+    void Connection::apply_learning(int64_t network_step, float activation, int conditioning_type){
+        PlasticityEvent event = {this, activation, conditioning_type};
+        apply_learning_batch(network_step, &event, 1);
+    }
+
+    //----------------------------------------------------------------------------------------------------------------------
+    //
+    void Connection::apply_learning_batch(int64_t network_step, const PlasticityEvent *events, unsigned int event_number){
+        int learning_type = _parameter->learning_type;
+        bool is_habituating = (learning_type == LEARNING_HABITUATION || learning_type == LEARNING_HABISENS);
+        bool is_sensitizing = (learning_type == LEARNING_SENSITIZATION || learning_type == LEARNING_HABISENS);
+
         long_learning_weight_backfall(network_step);
 
-        if(_parameter->learning_type == LEARNING_HABITUATION ||
-           _parameter->learning_type == LEARNING_HABISENS){
-            dehabituate(network_step);
-            habituate(network_step, conditioning_con);
-        }
+        for(unsigned int event=0; event < event_number; event++){
+            if(is_habituating){
+                if(event == 0){
+                    dehabituate(network_step);
+                }
+                habituate(network_step, events[event].activation, events[event].conditioning_type);
+            }
 
-        if(_parameter->learning_type == LEARNING_SENSITIZATION ||
-           _parameter->learning_type == LEARNING_HABISENS){
-             desensitize(network_step);
-             sensitize(network_step, conditioning_con);
+            if(is_sensitizing){
+                if(event == 0){
+                    desensitize(network_step);
+                }
+                sensitize(network_step, events[event].activation, events[event].conditioning_type);
+            }
         }
 
         last_activated_step = network_step;
@@ -347,7 +371,7 @@ namespace COGNA{
     void Connection::presynaptic_potential_backfall(int64_t network_step){
         if(DEBUG_MODE && DEB_PRESYNAPTIC)
             printf("<%ld> C-%d -> Presynaptic potential before backfall = %.3f\n",
-                   network_step, prev_neuron->_id, presynaptic_potential);
+                   network_step, prev_neuron->_id, (float)presynaptic_potential);
 
         presynaptic_potential =  MathUtils::calculate_static_gradient(presynaptic_potential,
                                                          _parameter->presynaptic_backfall_steepness,
@@ -359,13 +383,13 @@ namespace COGNA{
 
         if(DEBUG_MODE && DEB_PRESYNAPTIC)
             printf("<%ld> C-%d -> Presynaptic potential after backfall = %.3f\n\n",
-                   network_step, prev_neuron->_id, presynaptic_potential);
+                   network_step, prev_neuron->_id, (float)presynaptic_potential);
     }
 
     //----------------------------------------------------------------------------------------------------------------------
     //
     float Connection::choose_activation_function(float input){
-        switch(_parameter->activation_function){
+        switch(activation_function){
           case FUNCTION_SIGMOID:
               return MathUtils::sigmoid(input);
               break;
@@ -388,15 +412,15 @@ namespace COGNA{
 
     //----------------------------------------------------------------------------------------------------------------------
     //
-    void Connection::activate_next_neuron(int64_t network_step, std::vector<float> transmitter_weights){
+    void Connection::activate_next_neuron(int64_t network_step, const std::vector<float> &transmitter_weights){
         next_neuron->calculate_neuron_backfall(network_step);
 
         float temp_activation = short_weight * prev_neuron->_activation;
 
         next_neuron->_next_activation +=
               choose_activation_function(temp_activation) *
-              _parameter->activation_type *
-              transmitter_weights[_parameter->transmitter_type];
+              activation_type *
+              transmitter_weights[transmitter_type];
 
         next_neuron->_was_activated = true;
 
@@ -413,17 +437,19 @@ namespace COGNA{
 
     //----------------------------------------------------------------------------------------------------------------------
     //
-    void Connection::activate_next_connection(int64_t network_step){
+    bool Connection::activate_next_connection(int64_t network_step){
         if(DEBUG_MODE && DEB_PRESYNAPTIC){
             printf("<%ld> C-%d -> Presynaptic potential before influence : %.3f\n",
                    network_step,
                    prev_neuron->_id,
-                   next_connection->presynaptic_potential);
+                   (float)next_connection->presynaptic_potential);
         }
 
+        bool does_condition = false;
+
         presynaptic_potential_backfall(network_step);
         if(next_connection->presynaptic_potential > DEFAULT_PRESYNAPTIC_POTENTIAL){
-            next_connection->basic_learning(network_step, this);
+            does_condition = true;
             next_connection->presynaptic_potential = DEFAULT_PRESYNAPTIC_POTENTIAL;
         }
 
@@ -433,7 +459,9 @@ namespace COGNA{
             printf("<%ld> C-%d -> Presynaptic potential after influence : %.3f\n",
                    network_step,
                    prev_neuron->_id,
-                   next_connection->presynaptic_potential);
+                   (float)next_connection->presynaptic_potential);
         }
+
+        return does_condition;
     }
 }
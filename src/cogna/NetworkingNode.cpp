@@ -14,9 +14,17 @@
 
 namespace COGNA{
 
-NetworkingNode::NetworkingNode(int id, std::string channel){
+NetworkingNode::NetworkingNode(int id, std::string channel, int format, int channel_index, int aggregation,
+                               int width){
     _id = id;
     _channel = channel;
+    _format = format;
+    _channel_index = channel_index;
+    _aggregation = aggregation;
+    _width = width;
+    _relay_mode = utils::RELAY_TICK;
+    _slot = -1;
+    _writer = -1;
 
     _client = nullptr;
     _sender = nullptr;
@@ -51,34 +59,68 @@ int NetworkingNode::add_target(Neuron *target){
 
 //----------------------------------------------------------------------------------------------------------------------
 //
-int NetworkingNode::add_target(NetworkingNode *target){
-    bool can_add = true;
-    for(unsigned int i=0; i < _output_target_list.size(); i++){
-        if(target->_sender->get_ip() == _output_target_list[i]->_sender->get_ip() &&
-                target->_sender->get_port() == _output_target_list[i]->_sender->get_port()){
-            can_add = false;
-        }
+int NetworkingNode::set_population(const std::vector<Neuron*> &population){
+    if((int)population.size() != _width){
+        std::cout << "[ERROR] Node " << _id << " needs a population of " << _width << " neurons, not "
+                  << population.size() << "." << std::endl;
+        return ERROR_CODE;
     }
 
-    if(can_add){
-        _output_target_list.push_back(target);
-        return SUCCESS_CODE;
+    _population = population;
+    return SUCCESS_CODE;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NetworkingNode::relink_targets(const std::unordered_map<Neuron*, Neuron*> &relocated){
+    for(unsigned int i=0; i < _target_list.size(); i++){
+        auto it = relocated.find(_target_list[i]);
+        if(it != relocated.end()){
+            _target_list[i] = it->second;
+        }
     }
-    else{
-        std::string client_address = _client->get_ip() + ":" + std::to_string(_client->get_port());
-        std::string target_address = target->_sender->get_ip() + ":" + std::to_string(target->_sender->get_port());
-        std::cout << "[ERROR] Cannot add connection between node with address " << client_address
-                  << " and node with address " << target_address << "." << std::endl;
-        return ERROR_CODE;
+    for(unsigned int i=0; i < _population.size(); i++){
+        auto it = relocated.find(_population[i]);
+        if(it != relocated.end()){
+            _population[i] = it->second;
+        }
     }
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
-void NetworkingNode::remote_activate_senders(float injected_activation){
-    for(unsigned int i=0; i < _output_target_list.size(); i++){
-        _output_target_list[i]->_sender->add_data(_output_target_list[i]->channel(), injected_activation);
-    }
+void NetworkingNode::set_relay_mode(int relay_mode){
+    _relay_mode = relay_mode;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+float NetworkingNode::received_value(){
+    return _client->get_slot_value(_slot);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int64_t NetworkingNode::received_arrival(){
+    return _client->get_slot_arrival(_slot);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const float* NetworkingNode::received_values(){
+    return _client->get_slot_values(_slot);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const int64_t* NetworkingNode::received_arrivals(){
+    return _client->get_slot_arrivals(_slot);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NetworkingNode::add_sent_data(float value, int64_t arrival){
+    _sender->add_writer_data(_writer, value, arrival);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -87,6 +129,7 @@ int NetworkingNode::setup_client(utils::networking_client *client){
     if(_client == nullptr && _sender == nullptr){
         _client = client;
         _role = ROLE_EXTERN_INPUT;
+        _slot = _client->register_channel(_channel, _format, _channel_index, _aggregation, _width);
         return SUCCESS_CODE;
     }
     else{
@@ -101,6 +144,8 @@ int NetworkingNode::setup_sender(utils::networking_sender *sender){
     if(_client == nullptr && _sender == nullptr){
         _sender = sender;
         _role = ROLE_EXTERN_OUTPUT;
+        _slot = _sender->register_channel(_channel, _channel_index);
+        _writer = _sender->register_writer(_slot);
         return SUCCESS_CODE;
     }
     else{
@@ -129,8 +174,50 @@ std::string NetworkingNode::channel(){
 
 //----------------------------------------------------------------------------------------------------------------------
 //
-std::vector<Neuron*> NetworkingNode::targets(){
+int NetworkingNode::format(){
+    return _format;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int NetworkingNode::channel_index(){
+    return _channel_index;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int NetworkingNode::aggregation(){
+    return _aggregation;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int NetworkingNode::width(){
+    return _width;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int NetworkingNode::slot(){
+    return _slot;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int NetworkingNode::relay_mode(){
+    return _relay_mode;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const std::vector<Neuron*>& NetworkingNode::targets(){
     return _target_list;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+const std::vector<Neuron*>& NetworkingNode::population(){
+    return _population;
+}
+
 } //namespace COGNA
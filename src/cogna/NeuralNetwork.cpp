@@ -14,6 +14,8 @@
 #include <cmath>
 #include <iostream>
 #include <mutex>
+#include <algorithm>
+#include <unordered_map>
 #include <unistd.h>
 #include "Constants.hpp"
 #include "MathUtils.hpp"
@@ -25,6 +27,14 @@ using namespace COGNA;
 
 namespace COGNA{
 
+template<typename T>
+static void relink_pointer(T *&pointer, const std::unordered_map<T*, T*> &relocated){
+    auto it = relocated.find(pointer);
+    if(it != relocated.end()){
+        pointer = it->second;
+    }
+}
+
 int NeuralNetwork::m_cluster_state = STATE_RUNNING;
 
 int NeuralNetwork::m_max_id = 0;
@@ -39,11 +49,15 @@ NeuralNetwork::NeuralNetwork(){
     m_max_id++;
     _is_finished = false;
 
+    _random_generator.seed(((uint64_t)time(0) << 16) ^ (uint64_t)_id);
+
     _parameter = new NeuralNetworkParameterHandler();
     add_neuron(99999.0);
     _network_step_counter = 0;
     _transmitter_weights.push_back(1.0f);
     _network_step_counter = 0;
+    _is_tracing_latency = false;
+    _is_deferring_plasticity = true;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -57,7 +71,6 @@ NeuralNetwork::~NeuralNetwork(){
         _neurons[i] = NULL;
     }
     _neurons.clear();
-    _random_neurons.clear();
 
     _transmitter_weights.clear();
 
@@ -74,16 +87,35 @@ int NeuralNetwork::add_neuron(float threshold){
 
     temp_neuron->_parameter->activation_threshold = threshold;
 
+    temp_neuron->_json_id = _neurons.size();
+    _neuron_ids.push_back(temp_neuron->_json_id);
     _neurons.push_back(temp_neuron);
     return SUCCESS_CODE;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
-int NeuralNetwork::add_extern_input_node(int node_id, utils::networking_client *client, std::string channel){
+int NeuralNetwork::add_extern_input_node(int node_id, utils::networking_client *client, std::string channel,
+                                         int format, int channel_index, int aggregation, int width,
+                                         int population_start){
     int new_id = node_id;
-    NetworkingNode *temp_input_node = new NetworkingNode(new_id, channel);
+    std::vector<Neuron*> population;
+    if(width > 1){
+        if(population_start < MIN_NEURON_ID || (unsigned int)(population_start + width) > _neurons.size()){
+            LOG_ERROR("Population N-%d to N-%d of node %d does not exist.\n", population_start,
+                      population_start + width - 1, node_id);
+            return ERROR_CODE;
+        }
+        for(int n=population_start; n < population_start + width; n++){
+            population.push_back(_neurons[find_neuron_id(n)]);
+        }
+    }
+
+    NetworkingNode *temp_input_node = new NetworkingNode(new_id, channel, format, channel_index, aggregation, width);
     temp_input_node->setup_client(client);
+    if(width > 1){
+        temp_input_node->set_population(population);
+    }
     _extern_input_nodes.push_back(temp_input_node);
 
     return SUCCESS_CODE;
@@ -91,9 +123,10 @@ int NeuralNetwork::add_extern_input_node(int node_id, utils::networking_client *
 
 //----------------------------------------------------------------------------------------------------------------------
 //
-int NeuralNetwork::add_extern_output_node(int node_id, utils::networking_sender *sender, std::string channel){
+int NeuralNetwork::add_extern_output_node(int node_id, utils::networking_sender *sender, std::string channel,
+                                          int format, int channel_index){
     int new_id = node_id;
-    NetworkingNode *temp_output_node = new NetworkingNode(new_id, channel);
+    NetworkingNode *temp_output_node = new NetworkingNode(new_id, channel, format, channel_index);
     temp_output_node->setup_sender(sender);
     _extern_output_nodes.push_back(temp_output_node);
 
@@ -105,12 +138,13 @@ int NeuralNetwork::add_extern_output_node(int node_id, utils::networking_sender
 int NeuralNetwork::set_neural_transmitter_influence(int neuron_id,
                                                     int transmitter_id,
                                                     int influence_direction){
-    if(neuron_id >= MIN_NEURON_ID && (unsigned int)neuron_id < _neurons.size()){
+    int n_id = find_neuron_id(neuron_id);
+    if(n_id >= MIN_NEURON_ID){
         if(transmitter_id >= 0 && (unsigned int)transmitter_id < _transmitter_weights.size()){
             if(influence_direction == POSITIVE_INFLUENCE ||
                influence_direction == NEGATIVE_INFLUENCE){
-                   _neurons[neuron_id]->_parameter->influenced_transmitter = transmitter_id;
-                   _neurons[neuron_id]->_parameter->transmitter_influence_direction = influence_direction;
+                   _neurons[n_id]->_parameter->influenced_transmitter = transmitter_id;
+                   _neurons[n_id]->_parameter->transmitter_influence_direction = influence_direction;
                    return SUCCESS_CODE;
             }
         }
@@ -147,9 +181,10 @@ int NeuralNetwork::set_neural_transmitter_influence(int neuron_id,
  int NeuralNetwork::set_random_neuron_activation(int neuron_id,
                                                  int chance,
                                                  float activation_value){
-     if(neuron_id >= MIN_NEURON_ID && (unsigned int)neuron_id < _neurons.size()){
+     int n_id = find_neuron_id(neuron_id);
+     if(n_id >= MIN_NEURON_ID){
         if(chance >= 0 && chance < MAX_CHANCE){
-            _neurons[neuron_id]->set_random_activation(chance, activation_value);
+            _neurons[n_id]->set_random_activation(chance, activation_value);
             return SUCCESS_CODE;
         }
         else{
@@ -184,8 +219,10 @@ Connection* NeuralNetwork::add_neuron_connection(int source_neuron, int target_n
     }
 
     if(source_neuron >= MIN_NEURON_ID || target_neuron >= MIN_NEURON_ID){
-        if((unsigned int)source_neuron < _neurons.size() && (unsigned int)target_neuron < _neurons.size()){
-            Connection *temp_con = _neurons[source_neuron]->add_neuron_connection(_neurons[target_neuron], weight,
+        int source_id = find_neuron_id(source_neuron);
+        int target_id = find_neuron_id(target_neuron);
+        if(source_id >= 0 && target_id >= 0){
+            Connection *temp_con = _neurons[source_id]->add_neuron_connection(_neurons[target_id], weight,
                                                                                   connection_type,
                                                                                   function_type,
                                                                                   learning_type,
@@ -230,8 +267,9 @@ Connection* NeuralNetwork::add_neuron_connection(int source_neuron, Neuron *targ
        return NULL;
    }
 
-   if((unsigned int)source_neuron < _neurons.size()){
-       Connection *temp_con = _neurons[source_neuron]->add_neuron_connection(target_neuron, weight,
+   int source_id = find_neuron_id(source_neuron);
+   if(source_id >= 0){
+       Connection *temp_con = _neurons[source_id]->add_neuron_connection(target_neuron, weight,
                                                                              connection_type,
                                                                              function_type,
                                                                              learning_type,
@@ -272,19 +310,20 @@ Connection* NeuralNetwork::add_synaptic_connection(int source_neuron,
     }
 
     if(source_neuron >= MIN_NEURON_ID && connected_neuron_1 >= MIN_NEURON_ID && connected_neuron_2 >= MIN_NEURON_ID){
-        if((unsigned int)source_neuron < _neurons.size() &&
-                (unsigned int)connected_neuron_1 < _neurons.size() &&
-                (unsigned int)connected_neuron_2 < _neurons.size()){
+        int source_id = find_neuron_id(source_neuron);
+        int connected_id_1 = find_neuron_id(connected_neuron_1);
+        int connected_id_2 = find_neuron_id(connected_neuron_2);
+        if(source_id >= 0 && connected_id_1 >= 0 && connected_id_2 >= 0){
             Connection *temp_connection = NULL;
-            for(unsigned i=0; i<_neurons[connected_neuron_1]->_connections.size(); i++){
-                if(_neurons[connected_neuron_1]->_connections[i]->next_neuron){
-                    if(_neurons[connected_neuron_1]->_connections[i]->next_neuron->_id == connected_neuron_2){
-                        temp_connection = _neurons[connected_neuron_1]->_connections[i];
+            for(unsigned i=0; i<_neurons[connected_id_1]->_connections.size(); i++){
+                if(_neurons[connected_id_1]->_connections[i]->next_neuron){
+                    if(_neurons[connected_id_1]->_connections[i]->next_neuron->_id == connected_id_2){
+                        temp_connection = _neurons[connected_id_1]->_connections[i];
                     }
                 }
             }
             if(temp_connection){
-                temp_connection = _neurons[source_neuron]->add_synaptic_connection(temp_connection, weight, connection_type,
+                temp_connection = _neurons[source_id]->add_synaptic_connection(temp_connection, weight, connection_type,
                                                                                   function_type, learning_type, transmitter_type);
                 _connections.push_back(temp_connection);
                 return temp_connection;
@@ -326,8 +365,9 @@ Connection* NeuralNetwork::add_synaptic_connection(int source_neuron,
         transmitter_type = STD_TRANSMITTER;
     }
     if(source_neuron >= MIN_NEURON_ID){
-        if((unsigned int)source_neuron < _neurons.size()){
-            Connection *temp_con = _neurons[source_neuron]->add_synaptic_connection(con, weight, connection_type,
+        int source_id = find_neuron_id(source_neuron);
+        if(source_id >= 0){
+            Connection *temp_con = _neurons[source_id]->add_synaptic_connection(con, weight, connection_type,
                                                                                     function_type, learning_type, transmitter_type);
             _connections.push_back(temp_con);
             return temp_con;
@@ -346,12 +386,9 @@ Connection* NeuralNetwork::add_synaptic_connection(int source_neuron,
 //----------------------------------------------------------------------------------------------------------------------
 //
 int NeuralNetwork::init_activation(int target_neuron, float activation){
-    if(target_neuron >= MIN_NEURON_ID && (unsigned int)target_neuron < _neurons.size()){
-        _neurons[target_neuron]->_activation += activation;
-
-        _curr_connections.insert(std::end(_curr_connections),
-                                 std::begin(_neurons[target_neuron]->_connections),
-                                 std::end(_neurons[target_neuron]->_connections));
+    int n_id = find_neuron_id(target_neuron);
+    if(n_id >= MIN_NEURON_ID){
+        init_activation(_neurons[n_id], activation);
     }
     else{
         LOG_ERROR("Initializing activation in N-%d was unsuccessful. Invalid ID.\n", target_neuron);
@@ -360,6 +397,33 @@ int NeuralNetwork::init_activation(int target_neuron, float activation){
     return SUCCESS_CODE;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NeuralNetwork::init_activation(Neuron *target_neuron, float activation){
+    target_neuron->_activation += activation;
+
+    _curr_connections.insert(std::end(_curr_connections),
+                             std::begin(target_neuron->_connections),
+                             std::end(target_neuron->_connections));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NeuralNetwork::init_population_activation(const std::vector<Neuron*> &population, const float *values,
+                                               const int64_t *arrivals){
+    for(unsigned int n=0; n < population.size(); n++){
+        if(values[n] > 0){
+            population[n]->_activation += values[n];
+            _curr_connections.insert(std::end(_curr_connections),
+                                     std::begin(population[n]->_connections),
+                                     std::end(population[n]->_connections));
+            if(arrivals != nullptr && arrivals[n] > population[n]->_input_arrival){
+                population[n]->_input_arrival = arrivals[n];
+            }
+        }
+    }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 int NeuralNetwork::setup_network(){
@@ -368,18 +432,202 @@ int NeuralNetwork::setup_network(){
             _neurons[n]->add_neuron_connection(_neurons[0], 0.0);
         }
 
+        for(unsigned int con=0; con < _neurons[n]->_connections.size(); con++){
+            _neurons[n]->_connections[con]->cache_parameter();
+        }
+
         if(_neurons[n]->_parameter->random_activation == true){
-            _random_neurons.push_back(_neurons[n]);
+            schedule_random_neuron(_neurons[n]);
         }
     }
 
     Neuron::s_max_id = 0;
     Connection::s_max_id = 0;
 
-    srandom(time(0));
     return SUCCESS_CODE;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+int NeuralNetwork::reorder_neurons(int ordering, std::vector<NeuralNetwork*> network_list){
+    if(ordering == NEURON_ORDERING_NONE){
+        return SUCCESS_CODE;
+    }
+
+    if(ordering != NEURON_ORDERING_BFS &&
+       ordering != NEURON_ORDERING_RCM &&
+       ordering != NEURON_ORDERING_DEGREE){
+        LOG_ERROR("Invalid neuron ordering <%d> in NN-%d.\n", ordering, _id);
+        return ERROR_CODE;
+    }
+
+    if(network_list.size() == 0){
+        network_list.push_back(this);
+    }
+
+    relocate_neurons(find_neuron_order(ordering), network_list);
+
+    return SUCCESS_CODE;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+std::vector<int> NeuralNetwork::find_neuron_order(int ordering){
+    std::vector<std::vector<int>> neighbours(_neurons.size());
+
+    for(unsigned int n=MIN_NEURON_ID; n < _neurons.size(); n++){
+        for(unsigned int con=0; con < _neurons[n]->_connections.size(); con++){
+            Connection *curr_con = _neurons[n]->_connections[con];
+            Neuron *target = curr_con->next_neuron;
+            if(target == NULL && curr_con->next_connection){
+                target = curr_con->next_connection->prev_neuron;
+            }
+
+            /* Only neurons of this network can be renumbered */
+            if(target == NULL || target == _neurons[n] || target->_network_id != _id ||
+               target->_id < MIN_NEURON_ID || (unsigned int)target->_id >= _neurons.size() ||
+               _neurons[target->_id] != target){
+                continue;
+            }
+
+            neighbours[n].push_back(target->_id);
+            neighbours[target->_id].push_back(n);
+        }
+    }
+
+    auto has_lower_degree = [&neighbours](int a, int b){
+        return neighbours[a].size() < neighbours[b].size();
+    };
+
+    std::vector<int> starting_points;
+    for(unsigned int n=MIN_NEURON_ID; n < _neurons.size(); n++){
+        starting_points.push_back(n);
+    }
+
+    if(ordering == NEURON_ORDERING_DEGREE){
+        std::stable_sort(starting_points.begin(), starting_points.end(),
+                         [&has_lower_degree](int a, int b){ return has_lower_degree(b, a); });
+        return starting_points;
+    }
+
+    if(ordering == NEURON_ORDERING_RCM){
+        std::stable_sort(starting_points.begin(), starting_points.end(), has_lower_degree);
+        for(unsigned int n=MIN_NEURON_ID; n < neighbours.size(); n++){
+            std::stable_sort(neighbours[n].begin(), neighbours[n].end(), has_lower_degree);
+        }
+    }
+
+    /* Breadth first search over every unconnected part of the network. The order itself is the queue. */
+    std::vector<int> order;
+    std::vector<bool> visited(_neurons.size(), false);
+    for(unsigned int i=0; i < starting_points.size(); i++){
+        if(visited[starting_points[i]]){
+            continue;
+        }
+
+        visited[starting_points[i]] = true;
+        unsigned int head = order.size();
+        order.push_back(starting_points[i]);
+
+        while(head < order.size()){
+            int curr_neuron = order[head];
+            head++;
+
+            for(unsigned int nb=0; nb < neighbours[curr_neuron].size(); nb++){
+                if(!visited[neighbours[curr_neuron][nb]]){
+                    visited[neighbours[curr_neuron][nb]] = true;
+                    order.push_back(neighbours[curr_neuron][nb]);
+                }
+            }
+        }
+    }
+
+    if(ordering == NEURON_ORDERING_RCM){
+        std::reverse(order.begin(), order.end());
+    }
+
+    return order;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NeuralNetwork::relocate_neurons(const std::vector<int> &order, std::vector<NeuralNetwork*> network_list){
+    std::unordered_map<Neuron*, Neuron*> moved_neurons;
+    std::unordered_map<Connection*, Connection*> moved_connections;
+    std::vector<Neuron*> new_neurons(_neurons.size());
+    std::vector<Neuron*> old_neurons;
+    new_neurons[0] = _neurons[0];
+
+    /* All copies are created before freeing the originals, so they are not spread into freed gaps */
+    for(unsigned int i=0; i < order.size(); i++){
+        Neuron *old_neuron = _neurons[order[i]];
+        Neuron *new_neuron = new Neuron(*old_neuron);
+        new_neuron->_id = i + MIN_NEURON_ID;
+
+        for(unsigned int con=0; con < old_neuron->_connections.size(); con++){
+            Connection *new_con = new Connection(*old_neuron->_connections[con]);
+            new_con->prev_neuron = new_neuron;
+            new_neuron->_connections[con] = new_con;
+            moved_connections[old_neuron->_connections[con]] = new_con;
+        }
+
+        moved_neurons[old_neuron] = new_neuron;
+        new_neurons[new_neuron->_id] = new_neuron;
+        _neuron_ids[new_neuron->_json_id] = new_neuron->_id;
+        old_neurons.push_back(old_neuron);
+    }
+
+    /* The parameters now belong to the copies */
+    for(unsigned int i=0; i < old_neurons.size(); i++){
+        for(unsigned int con=0; con < old_neurons[i]->_connections.size(); con++){
+            old_neurons[i]->_connections[con]->_parameter = NULL;
+        }
+        old_neurons[i]->_parameter = NULL;
+        delete old_neurons[i];
+    }
+    _neurons = new_neurons;
+
+    for(unsigned int net=0; net < network_list.size(); net++){
+        NeuralNetwork *nn = network_list[net];
+
+        for(unsigned int n=0; n < nn->_neurons.size(); n++){
+            for(unsigned int con=0; con < nn->_neurons[n]->_connections.size(); con++){
+                relink_pointer(nn->_neurons[n]->_connections[con]->next_neuron, moved_neurons);
+                relink_pointer(nn->_neurons[n]->_connections[con]->next_connection, moved_connections);
+            }
+            for(unsigned int prev=0; prev < nn->_neurons[n]->_previous.size(); prev++){
+                relink_pointer(nn->_neurons[n]->_previous[prev], moved_neurons);
+            }
+        }
+
+        for(unsigned int con=0; con < nn->_connections.size(); con++){
+            relink_pointer(nn->_connections[con], moved_connections);
+        }
+        for(unsigned int con=0; con < nn->_curr_connections.size(); con++){
+            relink_pointer(nn->_curr_connections[con], moved_connections);
+        }
+        for(unsigned int con=0; con < nn->_next_connections.size(); con++){
+            relink_pointer(nn->_next_connections[con], moved_connections);
+        }
+
+        for(unsigned int node=0; node < nn->_extern_input_nodes.size(); node++){
+            nn->_extern_input_nodes[node]->relink_targets(moved_neurons);
+        }
+        for(unsigned int node=0; node < nn->_extern_output_nodes.size(); node++){
+            nn->_extern_output_nodes[node]->relink_targets(moved_neurons);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int NeuralNetwork::find_neuron_id(int json_id){
+    if(json_id >= 0 && (unsigned int)json_id < _neuron_ids.size()){
+        return _neuron_ids[json_id];
+    }
+    return -1;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 int64_t NeuralNetwork::get_step_count(){
@@ -389,8 +637,9 @@ int64_t NeuralNetwork::get_step_count(){
 //----------------------------------------------------------------------------------------------------------------------
 //
 Neuron* NeuralNetwork::get_neuron(int neuron_id){
-    if(neuron_id >= MIN_NEURON_ID && (unsigned int)neuron_id < _neurons.size()){
-        return _neurons[neuron_id];
+    int n_id = find_neuron_id(neuron_id);
+    if(n_id >= MIN_NEURON_ID){
+        return _neurons[n_id];
     }
     else{
         LOG_WARN("Neuron ID %d for getting neuron is invalid.\n", neuron_id);
@@ -401,8 +650,9 @@ Neuron* NeuralNetwork::get_neuron(int neuron_id){
 //----------------------------------------------------------------------------------------------------------------------
 //
 bool NeuralNetwork::neuron_is_active(int neuron_id){
-    if(neuron_id >= MIN_NEURON_ID && (unsigned int)neuron_id < _neurons.size()){
-        return _neurons[neuron_id]->is_active();
+    int n_id = find_neuron_id(neuron_id);
+    if(n_id >= MIN_NEURON_ID){
+        return _neurons[n_id]->is_active();
     }
     else{
         LOG_WARN("Neuron ID %d for getting neuron state is invalid.\n", neuron_id);
@@ -413,8 +663,9 @@ bool NeuralNetwork::neuron_is_active(int neuron_id){
 //----------------------------------------------------------------------------------------------------------------------
 //
 float NeuralNetwork::get_neuron_activation(int neuron_id){
-    if(neuron_id >= MIN_NEURON_ID && (unsigned int)neuron_id < _neurons.size()){
-        return _neurons[neuron_id]->_activation;
+    int n_id = find_neuron_id(neuron_id);
+    if(n_id >= MIN_NEURON_ID){
+        return _neurons[n_id]->_activation;
     }
     else{
         LOG_WARN("Neuron ID %d for getting neuron activation is invalid.\n", neuron_id);
@@ -434,6 +685,24 @@ float NeuralNetwork::get_transmitter_weight(int transmitter_id){
     return 0.0f;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NeuralNetwork::set_random_seed(uint64_t seed){
+    _random_generator.seed(seed);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NeuralNetwork::set_latency_tracing(bool is_enabled){
+    _is_tracing_latency = is_enabled;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NeuralNetwork::set_deferred_plasticity(bool is_enabled){
+    _is_deferring_plasticity = is_enabled;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 void NeuralNetwork::change_transmitter_weight(int transmitter_id, float new_weight){
@@ -508,17 +777,25 @@ void NeuralNetwork::transmitter_backfall(){
 //
 void NeuralNetwork::activate_next_entities(){
     for(unsigned int con=0; con<_curr_connections.size(); con++){
-        if(_curr_connections[con]->prev_neuron->_activation >= _curr_connections[con]->prev_neuron->_parameter->activation_threshold){
-            _curr_connections[con]->basic_learning(_network_step_counter);
+        if(_curr_connections[con]->prev_neuron->_activation >= _curr_connections[con]->fire_threshold){
+            add_plasticity_event(_curr_connections[con], _curr_connections[con]->prev_neuron->_activation, NONDIRECTIONAL);
             _curr_connections[con]->presynaptic_potential = 2.0f;
             influence_transmitter(_curr_connections[con]->prev_neuron);
 
             if(_curr_connections[con]->next_neuron){
                 _curr_connections[con]->activate_next_neuron(_network_step_counter, _transmitter_weights);
+                if(_is_tracing_latency &&
+                   _curr_connections[con]->prev_neuron->_input_arrival > _curr_connections[con]->next_neuron->_input_arrival){
+                    _curr_connections[con]->next_neuron->_input_arrival = _curr_connections[con]->prev_neuron->_input_arrival;
+                }
             }
 
             else if(_curr_connections[con]->next_connection){
-                _curr_connections[con]->activate_next_connection(_network_step_counter);
+                if(_curr_connections[con]->activate_next_connection(_network_step_counter)){
+                    add_plasticity_event(_curr_connections[con]->next_connection,
+                                         _curr_connections[con]->prev_neuron->_activation,
+                                         _curr_connections[con]->activation_type);
+                }
             }
 
             _curr_connections[con]->prev_neuron->_last_fired_step = _network_step_counter;
@@ -526,6 +803,62 @@ void NeuralNetwork::activate_next_entities(){
     }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NeuralNetwork::add_plasticity_event(Connection *connection, float activation, int conditioning_type){
+    if(!_is_deferring_plasticity){
+        connection->apply_learning(_network_step_counter, activation, conditioning_type);
+        return;
+    }
+
+    /* The event counters of the connections are 16 bit wide and count up to the number of events of a type.
+       Applying everything recorded so far keeps the order of the events of every connection and gives the same weights */
+    int type = connection->_parameter->learning_type - LEARNING_NONE;
+    if(_plasticity_events[type].size() == UINT16_MAX){
+        process_plasticity();
+    }
+
+    if(connection->plasticity_events == 0){
+        _plasticity_connections[type].push_back(connection);
+    }
+    connection->plasticity_events++;
+    _plasticity_events[type].push_back({connection, activation, conditioning_type});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NeuralNetwork::process_plasticity(){
+    for(int type=0; type < LEARNING_TYPE_NUMBER; type++){
+        std::vector<PlasticityEvent> &events = _plasticity_events[type];
+        std::vector<Connection*> &connections = _plasticity_connections[type];
+
+        /* A counting sort by connection. The event counter of every connection becomes the position of its
+           next event in the batches, so the events of a connection stay in the order they were recorded */
+        unsigned int position = 0;
+        for(unsigned int con=0; con < connections.size(); con++){
+            unsigned int event_number = connections[con]->plasticity_events;
+            connections[con]->plasticity_events = position;
+            position += event_number;
+        }
+        _plasticity_batches.resize(events.size());
+        for(unsigned int event=0; event < events.size(); event++){
+            _plasticity_batches[events[event].connection->plasticity_events++] = events[event];
+        }
+
+        /* Every counter now points behind the last event of its connection */
+        unsigned int begin = 0;
+        for(unsigned int con=0; con < connections.size(); con++){
+            unsigned int end = connections[con]->plasticity_events;
+            connections[con]->apply_learning_batch(_network_step_counter, &_plasticity_batches[begin], end - begin);
+            connections[con]->plasticity_events = 0;
+            begin = end;
+        }
+
+        events.clear();
+        connections.clear();
+    }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 void NeuralNetwork::save_next_neurons(std::vector<NeuralNetwork*> network_list){
@@ -579,14 +912,27 @@ void NeuralNetwork::save_next_neurons(std::vector<NeuralNetwork*> network_list){
     }
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+void NeuralNetwork::schedule_random_neuron(Neuron *n){
+    if(n->_parameter->random_chance <= 0){
+        return;
+    }
+
+    double probability = (double)n->_parameter->random_chance / MAX_CHANCE;
+    int64_t skipped_steps = _random_generator.next_geometric(probability);
+    _random_schedule.push(std::make_pair(_network_step_counter + skipped_steps, n->_id));
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 void NeuralNetwork::activate_random_neurons(){
-    for(unsigned int n = 0; n < _random_neurons.size(); n++){
-        if(random()%MAX_CHANCE <= _random_neurons[n]->_parameter->random_chance){
-            init_activation(_random_neurons[n]->_id, _random_neurons[n]->_parameter->random_activation_value);
-            srandom(time(0));
-        }
+    while(!_random_schedule.empty() && _random_schedule.top().first <= _network_step_counter){
+        Neuron *n = _neurons[_random_schedule.top().second];
+        _random_schedule.pop();
+
+        init_activation(n, n->_parameter->random_activation_value);
+        schedule_random_neuron(n);
     }
 }
 
@@ -601,12 +947,23 @@ void NeuralNetwork::switch_vectors(){
 //
 void NeuralNetwork::receive_data(){
     for(unsigned int i=0; i < _extern_input_nodes.size(); i++){
-        float injected_activation = (float)_extern_input_nodes[i]->_client->get_json_value(_extern_input_nodes[i]->channel());
+        if(_extern_input_nodes[i]->width() > 1){
+            init_population_activation(_extern_input_nodes[i]->population(),
+                                       _extern_input_nodes[i]->received_values(),
+                                       _is_tracing_latency ? _extern_input_nodes[i]->received_arrivals() : nullptr);
+            continue;
+        }
+
+        float injected_activation = _extern_input_nodes[i]->received_value();
         if(injected_activation > 0){
-            for(unsigned int j=0; j < _extern_input_nodes[i]->targets().size(); j++){
-                init_activation(_extern_input_nodes[i]->targets()[j]->_id, injected_activation);
+            int64_t arrival = _is_tracing_latency ? _extern_input_nodes[i]->received_arrival() : 0;
+            const std::vector<Neuron*> &targets = _extern_input_nodes[i]->targets();
+            for(unsigned int j=0; j < targets.size(); j++){
+                init_activation(targets[j], injected_activation);
+                if(arrival > targets[j]->_input_arrival){
+                    targets[j]->_input_arrival = arrival;
+                }
             }
-            _extern_input_nodes[i]->remote_activate_senders(injected_activation);
         }
     }
 }
@@ -616,11 +973,16 @@ void NeuralNetwork::receive_data(){
 void NeuralNetwork::store_sent_data(){
     for(unsigned int i=0; i < _extern_output_nodes.size(); i++){
         float injected_activation = 0.0f;
-        for(unsigned int j=0; j < _extern_output_nodes[i]->targets().size(); j++){
-            injected_activation += _extern_output_nodes[i]->targets()[j]->_activation;
-            _extern_output_nodes[i]->targets()[j]->clear_neuron_activation(_network_step_counter);
+        int64_t arrival = 0;
+        const std::vector<Neuron*> &targets = _extern_output_nodes[i]->targets();
+        for(unsigned int j=0; j < targets.size(); j++){
+            injected_activation += targets[j]->_activation;
+            if(targets[j]->_activation > 0.0f && targets[j]->_input_arrival > arrival){
+                arrival = targets[j]->_input_arrival;
+            }
+            targets[j]->clear_neuron_activation(_network_step_counter);
         }
-        _extern_output_nodes[i]->_sender->add_data(_extern_output_nodes[i]->channel(), injected_activation);
+        _extern_output_nodes[i]->add_sent_data(injected_activation, arrival);
     }
 }
 
@@ -635,6 +997,7 @@ void NeuralNetwork::feed_forward(std::vector<NeuralNetwork*> network_list){
     store_sent_data();
     save_next_neurons(network_list);
     switch_vectors();
+    process_plasticity();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
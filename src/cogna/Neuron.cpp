@@ -81,6 +81,7 @@ namespace COGNA{
         _parameter->long_learning_weight_backfall_steepness = default_parameter->long_learning_weight_backfall_steepness;
 
         _id = s_max_id;
+        _json_id = _id;
         s_max_id++;
 
         _next_activation = 0.0f;
@@ -88,6 +89,7 @@ namespace COGNA{
         _was_activated = true;
         _last_activated_step = 0;
         _last_fired_step = 0;
+        _input_arrival = 0;
     }
 
     //----------------------------------------------------------------------------------------------------------------------
@@ -161,6 +163,7 @@ namespace COGNA{
             temp_con->_parameter->activation_function = fun_type;
             temp_con->_parameter->learning_type = learn_type;
             temp_con->_parameter->transmitter_type = transmitter_type;
+            temp_con->cache_parameter();
             temp_con->last_presynaptic_activated_step = 0;
             temp_con->last_activated_step = 0;
             _connections.push_back(temp_con);
@@ -200,6 +203,7 @@ namespace COGNA{
             temp_con->_parameter->activation_function = fun_type;
             temp_con->_parameter->learning_type = learn_type;
             temp_con->_parameter->transmitter_type = transmitter_type;
+            temp_con->cache_parameter();
             _connections.push_back(temp_con);
             return temp_con;
         }
@@ -263,6 +267,11 @@ namespace COGNA{
                                                        SUBTRACT,
                                                        _parameter->max_activation,
                                                        _parameter->min_activation);
+
+            /* The activation the input arrival belongs to has faded */
+            if(_activation <= _parameter->min_activation){
+                _input_arrival = 0;
+            }
         }
 
         if(DEBUG_MODE && DEB_NEURON_BACKFALL)
@@ -280,6 +289,9 @@ namespace COGNA{
         if(_activation >= _parameter->activation_threshold){
             _activation = _parameter->min_activation;
         }
+        if(_activation <= _parameter->min_activation){
+            _input_arrival = 0;
+        }
 
         if(DEBUG_MODE && DEB_NEURON_BACKFALL)
             printf("<%ld> N-%d -> Activation after clearing = %.3f\n\n",
@@ -0,0 +1,82 @@
+/**
+ * @file RandomGenerator.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of RandomGenerator class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "RandomGenerator.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace COGNA{
+
+static inline uint64_t rotate_left(uint64_t value, int shift){
+    return (value << shift) | (value >> (64 - shift));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+RandomGenerator::RandomGenerator(uint64_t seed){
+    this->seed(seed);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void RandomGenerator::seed(uint64_t seed){
+    // splitmix64 spreads a single seed over the whole state, so that even seeds like 0 or 1 work.
+    for(int i=0; i < 4; i++){
+        seed += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        _state[i] = z ^ (z >> 31);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+uint64_t RandomGenerator::next(){
+    const uint64_t result = rotate_left(_state[1] * 5, 7) * 9;
+    const uint64_t t = _state[1] << 17;
+
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = rotate_left(_state[3], 45);
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+double RandomGenerator::next_double(){
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int64_t RandomGenerator::next_geometric(double probability){
+    if(probability >= 1.0){
+        return 1;
+    }
+    if(probability <= 0.0){
+        return std::numeric_limits<int64_t>::max();
+    }
+
+    double uniform = 1.0 - next_double();    // (0;1], log() must never see 0
+    double trials = std::floor(std::log(uniform) / std::log1p(-probability)) + 1.0;
+
+    if(trials >= (double)std::numeric_limits<int64_t>::max()){
+        return std::numeric_limits<int64_t>::max();
+    }
+    return (int64_t)trials;
+}
+
+} //namespace COGNA
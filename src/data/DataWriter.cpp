@@ -123,7 +123,7 @@ namespace COGNA{
                 /* SAVING NEURONS */
                 _output << nn->get_step_count() << ",";
                 _output << "neuron" << ",";
-                _output << nn->_neurons[n]->_id << ",";
+                _output << nn->_neurons[n]->_json_id << ",";
                 _output << nn->_neurons[n]->_activation << ",";
                 _output << nn->_neurons[n]->_parameter->random_chance << ",";
                 _output << nn->_neurons[n]->_parameter->activation_threshold << ",";
@@ -164,14 +164,14 @@ namespace COGNA{
                     for(int i=0; i<connection_param_gap_size; i++){
                         _output << ",";
                     }
-                    _output << nn->_neurons[n]->_id << ",";
+                    _output << nn->_neurons[n]->_json_id << ",";
                     if(nn->_neurons[n]->_connections[con]->next_neuron){
-                        _output << nn->_neurons[n]->_connections[con]->next_neuron->_id << ",";
+                        _output << nn->_neurons[n]->_connections[con]->next_neuron->_json_id << ",";
                         _output << ",";
                     }
                     else{
                         _output << ",";
-                        _output << nn->_neurons[n]->_connections[con]->next_connection->prev_neuron->_id << ",";
+                        _output << nn->_neurons[n]->_connections[con]->next_connection->prev_neuron->_json_id << ",";
                     }
 
                     _output << nn->_neurons[n]->_connections[con]->short_weight << ",";
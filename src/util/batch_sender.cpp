@@ -0,0 +1,388 @@
+/**
+ * @file batch_sender.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of batch_sender class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "batch_sender.hpp"
+#include "frame_protocol.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <unistd.h>
+
+#ifndef SEGMENT_MAX_NUMBER
+#define SEGMENT_MAX_NUMBER 64		// The most datagrams the kernel splits one buffer into
+#endif //SEGMENT_MAX_NUMBER
+
+static const size_t SEGMENT_CONTROL_SIZE = CMSG_SPACE(sizeof(uint16_t));
+
+namespace utils{
+
+batch_sender::batch_sender(std::vector<networking_sender*> senders){
+	for(unsigned int i=0; i < senders.size(); i++){
+		if(senders[i]->is_local()){
+			_local_senders.push_back(senders[i]);
+		}
+		else if(senders[i]->get_addrinfo()->ai_family == AF_INET){
+			_senders.push_back(senders[i]);
+		}
+	}
+	_ipv4_number = _senders.size();
+	for(unsigned int i=0; i < senders.size(); i++){
+		if(!senders[i]->is_local() && senders[i]->get_addrinfo()->ai_family == AF_INET6){
+			_senders.push_back(senders[i]);
+		}
+	}
+	_ip_number = _senders.size();
+	for(unsigned int i=0; i < senders.size(); i++){
+		if(!senders[i]->is_local() && senders[i]->get_addrinfo()->ai_family == AF_UNIX){
+			_senders.push_back(senders[i]);
+		}
+	}
+
+	_batch.reserve(_senders.size());
+	_vectors.reserve(_senders.size());
+	_entry_senders.reserve(_senders.size());
+	_entry_destinations.reserve(_senders.size());
+	_entry_segments.reserve(_senders.size());
+	_entry_datagrams.reserve(_senders.size());
+	_batch_ipv4 = 0;
+	_batch_ipv6 = 0;
+	_socket_ipv4 = -1;
+	_socket_ipv6 = -1;
+	_socket_unix = -1;
+	_is_segmenting_ipv4 = false;
+	_is_segmenting_ipv6 = false;
+	_is_segmenting_unix = false;
+	_sent = 0;
+	_dropped = 0;
+	_would_block = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+batch_sender::~batch_sender(){
+	if(_socket_ipv4 >= 0){
+		close(_socket_ipv4);
+	}
+	if(_socket_ipv6 >= 0){
+		close(_socket_ipv6);
+	}
+	if(_socket_unix >= 0){
+		close(_socket_unix);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int batch_sender::open_sockets(){
+	if(_ipv4_number > 0 && _socket_ipv4 < 0){
+		_socket_ipv4 = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+		if(_socket_ipv4 < 0){
+			std::cout << "[ERROR] Could not open IPv4 socket for sending: " << strerror(errno) << std::endl;
+			return -1;
+		}
+		int segment_size = 0;
+		socklen_t length = sizeof(segment_size);
+		_is_segmenting_ipv4 = (getsockopt(_socket_ipv4, SOL_UDP, UDP_SEGMENT, &segment_size, &length) == 0);
+	}
+	if(_ip_number > _ipv4_number && _socket_ipv6 < 0){
+		_socket_ipv6 = socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+		if(_socket_ipv6 < 0){
+			std::cout << "[ERROR] Could not open IPv6 socket for sending: " << strerror(errno) << std::endl;
+			return -1;
+		}
+		int segment_size = 0;
+		socklen_t length = sizeof(segment_size);
+		_is_segmenting_ipv6 = (getsockopt(_socket_ipv6, SOL_UDP, UDP_SEGMENT, &segment_size, &length) == 0);
+	}
+	if(_senders.size() > _ip_number && _socket_unix < 0){
+		// Unix domain sockets have no segmentation offload
+		_socket_unix = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		// Receivers reassemble frames per source, which an unbound socket does not have
+		if(_socket_unix >= 0 && !udp_client_server::autobind_unix_socket(_socket_unix)){
+			close(_socket_unix);
+			_socket_unix = -1;
+		}
+		if(_socket_unix < 0){
+			std::cout << "[ERROR] Could not open unix socket for sending: " << strerror(errno) << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int batch_sender::flush(){
+	auto time_in_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	// Senders in delta mode without changes return no datagram. Senders are sorted by family, so are their entries.
+	_entry_senders.clear();
+	_entry_destinations.clear();
+	_entry_segments.clear();
+	_entry_datagrams.clear();
+	_vectors.clear();
+	_batch_ipv4 = 0;
+	_batch_ipv6 = 0;
+	for(unsigned int i=0; i < _senders.size(); i++){
+		const std::string &datagram = _senders[i]->serialize_payload((int64_t)time_in_ns);
+		if(!datagram.empty()){
+			if(datagram.size() <= _senders[i]->get_max_datagram_size()){
+				for(int destination=0; destination < _senders[i]->get_destination_number(); destination++){
+					add_entry(i, destination, datagram.data(), datagram.size(), 0, 1);
+				}
+			}
+			else{
+				add_frames(i, datagram);
+			}
+		}
+		if(i + 1 == _ipv4_number){
+			_batch_ipv4 = _vectors.size();
+		}
+		if(i + 1 == _ip_number){
+			_batch_ipv6 = _vectors.size();
+		}
+	}
+	prepare_batch();
+
+	unsigned long long sent_before = _sent;
+	for(unsigned int i=0; i < _local_senders.size(); i++){
+		unsigned long long dropped_before = _local_senders[i]->get_dropped_payloads();
+		if(_local_senders[i]->send_payload((int64_t)time_in_ns)){
+			_sent++;
+		}
+		else if(_local_senders[i]->get_dropped_payloads() != dropped_before){
+			_dropped++;
+		}
+	}
+	send_range(_socket_ipv4, 0, _batch_ipv4, &_is_segmenting_ipv4);
+	send_range(_socket_ipv6, _batch_ipv4, _batch_ipv6, &_is_segmenting_ipv6);
+	send_range(_socket_unix, _batch_ipv6, _batch.size(), &_is_segmenting_unix);
+	return (int)(_sent - sent_before);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void batch_sender::add_entry(unsigned int sender, unsigned int destination, const char *data, size_t size,
+							 size_t segment_size, unsigned int datagrams){
+	struct iovec vector;
+	vector.iov_base = (void*)data;
+	vector.iov_len = size;
+	_vectors.push_back(vector);
+	_entry_senders.push_back(sender);
+	_entry_destinations.push_back(destination);
+	_entry_segments.push_back(segment_size);
+	_entry_datagrams.push_back(datagrams);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void batch_sender::add_frames(unsigned int sender, const std::string &payload){
+	int frame_number = 0;
+	const std::string &frames = _senders[sender]->frame_payload(payload, &frame_number);
+	if(frame_number == 0){
+		_dropped++;
+		return;
+	}
+
+	// With segmentation offload as many frames as fit into one UDP payload are handed over at once
+	size_t frame_size = _senders[sender]->get_max_datagram_size();
+	bool is_segmenting = (sender < _ipv4_number) ? _is_segmenting_ipv4 :
+						 (sender < _ip_number) ? _is_segmenting_ipv6 : _is_segmenting_unix;
+	unsigned int frames_per_entry = 1;
+	if(is_segmenting){
+		frames_per_entry = std::min((size_t)SEGMENT_MAX_NUMBER, UDP_MAX_PAYLOAD / frame_size);
+		frames_per_entry = std::max(frames_per_entry, 1u);
+	}
+
+	for(int destination=0; destination < _senders[sender]->get_destination_number(); destination++){
+		for(unsigned int frame=0; frame < (unsigned int)frame_number; frame += frames_per_entry){
+			unsigned int datagrams = std::min(frames_per_entry, (unsigned int)frame_number - frame);
+			size_t offset = frame * frame_size;
+			size_t size = std::min(datagrams * frame_size, frames.size() - offset);
+			add_entry(sender, destination, frames.data() + offset, size, datagrams > 1 ? frame_size : 0, datagrams);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void batch_sender::prepare_batch(){
+	_batch.resize(_vectors.size());
+	if(_controls.size() < _vectors.size() * SEGMENT_CONTROL_SIZE){
+		_controls.resize(_vectors.size() * SEGMENT_CONTROL_SIZE);
+	}
+
+	for(unsigned int i=0; i < _batch.size(); i++){
+		const struct addrinfo *address = _senders[_entry_senders[i]]->get_addrinfo(_entry_destinations[i]);
+		struct msghdr *header = &_batch[i].msg_hdr;
+		memset(&_batch[i], 0, sizeof(struct mmsghdr));
+		header->msg_name = address->ai_addr;
+		header->msg_namelen = address->ai_addrlen;
+		header->msg_iov = &_vectors[i];
+		header->msg_iovlen = 1;
+		if(_entry_segments[i] == 0){
+			continue;
+		}
+
+		header->msg_control = &_controls[i * SEGMENT_CONTROL_SIZE];
+		header->msg_controllen = SEGMENT_CONTROL_SIZE;
+		struct cmsghdr *control = CMSG_FIRSTHDR(header);
+		control->cmsg_level = SOL_UDP;
+		control->cmsg_type = UDP_SEGMENT;
+		control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+		uint16_t segment_size = (uint16_t)_entry_segments[i];
+		memcpy(CMSG_DATA(control), &segment_size, sizeof(segment_size));
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void batch_sender::send_range(int socket, unsigned int begin, unsigned int end, bool *is_segmenting){
+	if(begin >= end){
+		return;
+	}
+	if(socket < 0){
+		for(unsigned int i=begin; i < end; i++){
+			_dropped += _entry_datagrams[i];
+		}
+		return;
+	}
+
+	unsigned int next = begin;
+	while(next < end){
+		// Once segmentation offload failed, the remaining entries holding several datagrams are split here
+		unsigned int stop = end;
+		if(!*is_segmenting){
+			if(_entry_segments[next] > 0){
+				if(!send_segments(socket, next)){
+					for(unsigned int i=next + 1; i < end; i++){
+						_would_block += _entry_datagrams[i];
+						_dropped += _entry_datagrams[i];
+					}
+					return;
+				}
+				next++;
+				continue;
+			}
+			stop = next + 1;
+			while(stop < end && _entry_segments[stop] == 0){
+				stop++;
+			}
+		}
+
+		int sent = sendmmsg(socket, &_batch[next], stop - next, 0);
+		if(sent > 0){
+			for(int i=0; i < sent; i++){
+				_sent += _entry_datagrams[next + i];
+			}
+			next += sent;
+		}
+		else if(sent < 0 && errno == EINTR){
+			continue;
+		}
+		else if(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+			for(unsigned int i=next; i < end; i++){
+				_would_block += _entry_datagrams[i];
+				_dropped += _entry_datagrams[i];
+			}
+			return;
+		}
+		else{
+			// The device might not support segmentation offload, e.g. if a frame exceeds its MTU.
+			// The refused entry is then sent again as single datagrams.
+			if(_entry_segments[next] > 0 && *is_segmenting){
+				std::cout << "[WARNING] Segmentation offload failed: " << strerror(errno)
+						  << ". Frames are sent as single datagrams from now on." << std::endl;
+				*is_segmenting = false;
+				continue;
+			}
+			_dropped += _entry_datagrams[next];		// Skip the entry the kernel refused, e.g. because it is too large
+			next++;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool batch_sender::send_segments(int socket, unsigned int entry){
+	const char *data = (const char*)_vectors[entry].iov_base;
+	size_t size = _vectors[entry].iov_len;
+	size_t segment_size = _entry_segments[entry];
+	unsigned int datagrams = _entry_datagrams[entry];
+	_segment_batch.resize(datagrams);
+	_segment_vectors.resize(datagrams);
+	for(unsigned int i=0; i < datagrams; i++){
+		size_t offset = i * segment_size;
+		_segment_vectors[i].iov_base = (void*)(data + offset);
+		_segment_vectors[i].iov_len = std::min(segment_size, size - offset);
+		memset(&_segment_batch[i], 0, sizeof(struct mmsghdr));
+		_segment_batch[i].msg_hdr.msg_name = _batch[entry].msg_hdr.msg_name;
+		_segment_batch[i].msg_hdr.msg_namelen = _batch[entry].msg_hdr.msg_namelen;
+		_segment_batch[i].msg_hdr.msg_iov = &_segment_vectors[i];
+		_segment_batch[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	unsigned int next = 0;
+	while(next < datagrams){
+		int sent = sendmmsg(socket, &_segment_batch[next], datagrams - next, 0);
+		if(sent > 0){
+			_sent += sent;
+			next += sent;
+		}
+		else if(sent < 0 && errno == EINTR){
+			continue;
+		}
+		else if(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+			_would_block += datagrams - next;
+			_dropped += datagrams - next;
+			return false;
+		}
+		else{
+			_dropped++;
+			next++;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool batch_sender::is_segmenting(int family){
+	if(family == AF_INET){
+		return _is_segmenting_ipv4;
+	}
+	return (family == AF_INET6) ? _is_segmenting_ipv6 : _is_segmenting_unix;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long batch_sender::get_sent(){
+	return _sent;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long batch_sender::get_dropped(){
+	return _dropped;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long batch_sender::get_would_block(){
+	return _would_block;
+}
+
+} //namespace utils
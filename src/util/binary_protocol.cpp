@@ -0,0 +1,202 @@
+/**
+ * @file binary_protocol.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of the binary channel format.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "binary_protocol.hpp"
+#include <cstring>
+#include <algorithm>
+
+namespace utils{
+
+static const char BINARY_MAGIC[4] = {'C', 'G', 'N', 'A'};
+
+static inline void put_u16(std::string &out, uint16_t value){
+	out.push_back((char)(value & 0xFF));
+	out.push_back((char)(value >> 8));
+}
+
+static inline void put_u32(std::string &out, uint32_t value){
+	for(int i=0; i < 4; i++){
+		out.push_back((char)((value >> (8 * i)) & 0xFF));
+	}
+}
+
+static inline void put_u64(std::string &out, uint64_t value){
+	for(int i=0; i < 8; i++){
+		out.push_back((char)((value >> (8 * i)) & 0xFF));
+	}
+}
+
+static inline void put_float(std::string &out, float value){
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	put_u32(out, bits);
+}
+
+static inline uint64_t get_uint(const char *data, int bytes){
+	uint64_t value = 0;
+	for(int i=0; i < bytes; i++){
+		value |= (uint64_t)(uint8_t)data[i] << (8 * i);
+	}
+	return value;
+}
+
+static inline float get_float(const char *data){
+	uint32_t bits = (uint32_t)get_uint(data, 4);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static void put_header(std::string &out, uint8_t layout, uint16_t count, uint32_t sequence, int64_t timestamp){
+	out.clear();
+	out.append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+	out.push_back((char)BINARY_VERSION);
+	out.push_back((char)layout);
+	put_u16(out, count);
+	put_u32(out, sequence);
+	put_u64(out, (uint64_t)timestamp);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int parse_format(const std::string &name){
+	if(name == "json"){
+		return FORMAT_JSON;
+	}
+	else if(name == "binary"){
+		return FORMAT_BINARY_PAIRS;
+	}
+	else if(name == "binary_dense"){
+		return FORMAT_BINARY_DENSE;
+	}
+	return -1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool is_binary_message(const char *data, size_t size){
+	return size >= BINARY_HEADER_SIZE && memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool is_binary_delta(const char *data, size_t size){
+	return size >= BINARY_HEADER_SIZE && ((uint8_t)data[5] & BINARY_FLAG_DELTA) != 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+uint32_t get_binary_sequence(const char *data, size_t size){
+	return size >= BINARY_HEADER_SIZE ? (uint32_t)get_uint(data + 8, 4) : 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void encode_binary_pairs(std::string &out, uint32_t sequence, int64_t timestamp,
+						 const std::vector<float> &values, const std::vector<bool> &is_set, bool is_delta){
+	size_t channel_number = std::min(values.size(), BINARY_MAX_CHANNELS);
+	uint16_t count = 0;
+	for(size_t i=0; i < channel_number; i++){
+		if(is_set[i]){
+			count++;
+		}
+	}
+
+	put_header(out, BINARY_LAYOUT_PAIRS | (is_delta ? BINARY_FLAG_DELTA : 0), count, sequence, timestamp);
+	for(size_t i=0; i < channel_number; i++){
+		if(is_set[i]){
+			put_u16(out, (uint16_t)i);
+			put_float(out, values[i]);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void encode_binary_dense(std::string &out, uint32_t sequence, int64_t timestamp,
+						 const std::vector<float> &values){
+	uint16_t count = (uint16_t)std::min(values.size(), BINARY_MAX_CHANNELS);
+
+	put_header(out, BINARY_LAYOUT_DENSE, count, sequence, timestamp);
+	for(uint16_t i=0; i < count; i++){
+		put_float(out, values[i]);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int decode_binary_message(const char *data, size_t size, binary_header *header, std::vector<float> &values,
+						  std::vector<bool> *contained){
+	if(!is_binary_message(data, size)){
+		return -1;
+	}
+
+	header->version = (uint8_t)data[4];
+	header->layout = (uint8_t)data[5] & BINARY_LAYOUT_MASK;
+	header->is_delta = ((uint8_t)data[5] & BINARY_FLAG_DELTA) != 0;
+	header->count = (uint16_t)get_uint(data + 6, 2);
+	header->sequence = (uint32_t)get_uint(data + 8, 4);
+	header->timestamp = (int64_t)get_uint(data + 12, 8);
+
+	if(header->version != BINARY_VERSION){
+		return -1;
+	}
+
+	std::fill(values.begin(), values.end(), 0.0f);
+	if(contained != nullptr){
+		contained->assign(values.size(), false);
+	}
+	const char *entry = data + BINARY_HEADER_SIZE;
+
+	if(header->layout == BINARY_LAYOUT_PAIRS){
+		if(size < BINARY_HEADER_SIZE + (size_t)header->count * BINARY_PAIR_SIZE){
+			return -1;
+		}
+		for(uint16_t i=0; i < header->count; i++){
+			uint16_t channel_index = (uint16_t)get_uint(entry, 2);
+			if(channel_index >= values.size()){
+				values.resize(channel_index + 1, 0.0f);
+				if(contained != nullptr){
+					contained->resize(channel_index + 1, false);
+				}
+			}
+			values[channel_index] = get_float(entry + 2);
+			if(contained != nullptr){
+				(*contained)[channel_index] = true;
+			}
+			entry += BINARY_PAIR_SIZE;
+		}
+		return 0;
+	}
+	else if(header->layout == BINARY_LAYOUT_DENSE){
+		if(size < BINARY_HEADER_SIZE + (size_t)header->count * sizeof(float)){
+			return -1;
+		}
+		if(header->count > values.size()){
+			values.resize(header->count, 0.0f);
+			if(contained != nullptr){
+				contained->resize(header->count, false);
+			}
+		}
+		for(uint16_t i=0; i < header->count; i++){
+			values[i] = get_float(entry);
+			entry += sizeof(float);
+		}
+		// The dense layout always carries every channel up to its count
+		if(contained != nullptr){
+			std::fill(contained->begin(), contained->begin() + header->count, true);
+		}
+		return 0;
+	}
+
+	return -1;
+}
+
+} //namespace utils
@@ -0,0 +1,219 @@
+/**
+ * @file channel_aggregator.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of channel_aggregator class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "channel_aggregator.hpp"
+#include <thread>
+
+namespace utils{
+
+int parse_aggregation(const std::string &name){
+	if(name == "last"){
+		return AGGREGATE_LAST;
+	}
+	else if(name == "sum"){
+		return AGGREGATE_SUM;
+	}
+	else if(name == "mean"){
+		return AGGREGATE_MEAN;
+	}
+	else if(name == "max"){
+		return AGGREGATE_MAX;
+	}
+	return -1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+channel_aggregator::channel_aggregator(int producer_number){
+	_active.store(0);
+	set_producer_number(producer_number);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+channel_aggregator::~channel_aggregator(){
+	for(unsigned int i=0; i < _producers.size(); i++){
+		delete _producers[i];
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void channel_aggregator::set_producer_number(int producer_number){
+	channel_state empty = {0.0, 0, 0};
+	while((int)_producers.size() > producer_number && _producers.size() > 1){
+		delete _producers.back();
+		_producers.pop_back();
+	}
+	while((int)_producers.size() < producer_number || _producers.size() == 0){
+		producer_state *producer = new producer_state();
+		producer->sets[0].assign(_aggregations.size(), empty);
+		producer->sets[1].assign(_aggregations.size(), empty);
+		producer->sample_numbers[0] = 0;
+		producer->sample_numbers[1] = 0;
+		producer->adding.store(-1);
+		producer->batch_set = 0;
+		_producers.push_back(producer);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int channel_aggregator::add_channel(int aggregation){
+	channel_state empty = {0.0, 0, 0};
+	_aggregations.push_back(aggregation);
+	for(unsigned int i=0; i < _producers.size(); i++){
+		_producers[i]->sets[0].push_back(empty);
+		_producers[i]->sets[1].push_back(empty);
+	}
+	return _aggregations.size() - 1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void channel_aggregator::begin_batch(int producer){
+	// Announce the set before adding to it. If the consumer swapped the sets in between, announce the new one.
+	producer_state *current = _producers[producer];
+	while(true){
+		current->batch_set = _active.load(std::memory_order_seq_cst);
+		current->adding.store(current->batch_set, std::memory_order_seq_cst);
+		if(_active.load(std::memory_order_seq_cst) == current->batch_set){
+			return;
+		}
+		current->adding.store(-1, std::memory_order_seq_cst);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void channel_aggregator::add_sample(int channel, float value, int64_t arrival, int producer){
+	producer_state *current = _producers[producer];
+	channel_state &state = current->sets[current->batch_set][channel];
+	if(state.count == 0){
+		state.value = value;
+	}
+	else{
+		switch(_aggregations[channel]){
+			case AGGREGATE_SUM:
+			case AGGREGATE_MEAN:
+				state.value += value;
+				break;
+			case AGGREGATE_MAX:
+				if(value > state.value){
+					state.value = value;
+				}
+				break;
+			default:
+				state.value = value;
+				break;
+		}
+	}
+	state.count++;
+	if(arrival > state.arrival){
+		state.arrival = arrival;
+	}
+	current->sample_numbers[current->batch_set]++;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void channel_aggregator::end_batch(int producer){
+	_producers[producer]->adding.store(-1, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long channel_aggregator::collect(std::vector<float> &values, std::vector<int64_t> &arrivals){
+	int collected = _active.load(std::memory_order_relaxed);
+	_active.store(1 - collected, std::memory_order_seq_cst);
+	unsigned long long sample_number = 0;
+	for(unsigned int i=0; i < _producers.size(); i++){
+		while(_producers[i]->adding.load(std::memory_order_seq_cst) == collected){
+			std::this_thread::yield();
+		}
+		sample_number += _producers[i]->sample_numbers[collected];
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	if(sample_number == 0){
+		return 0;
+	}
+
+	for(unsigned int channel=0; channel < _aggregations.size(); channel++){
+		double value = 0.0;
+		unsigned int count = 0;
+		int64_t arrival = 0;
+		for(unsigned int i=0; i < _producers.size(); i++){
+			channel_state &state = _producers[i]->sets[collected][channel];
+			if(state.count == 0){
+				continue;
+			}
+
+			if(count == 0){
+				value = state.value;
+			}
+			else{
+				switch(_aggregations[channel]){
+					case AGGREGATE_SUM:
+					case AGGREGATE_MEAN:
+						value += state.value;
+						break;
+					case AGGREGATE_MAX:
+						if(state.value > value){
+							value = state.value;
+						}
+						break;
+					default:
+						if(state.arrival > arrival){
+							value = state.value;
+						}
+						break;
+				}
+			}
+			count += state.count;
+			if(state.arrival > arrival){
+				arrival = state.arrival;
+			}
+			state.count = 0;
+			state.arrival = 0;
+		}
+
+		if(count == 0){
+			values[channel] = 0.0f;
+			arrivals[channel] = 0;
+		}
+		else if(_aggregations[channel] == AGGREGATE_MEAN){
+			values[channel] = (float)(value / count);
+			arrivals[channel] = arrival;
+		}
+		else{
+			values[channel] = (float)value;
+			arrivals[channel] = arrival;
+		}
+	}
+	for(unsigned int i=0; i < _producers.size(); i++){
+		_producers[i]->sample_numbers[collected] = 0;
+	}
+	return sample_number;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int channel_aggregator::get_channel_number(){
+	return _aggregations.size();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int channel_aggregator::get_producer_number(){
+	return _producers.size();
+}
+
+} //namespace utils
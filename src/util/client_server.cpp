@@ -17,12 +17,207 @@
 
 #include "client_server.hpp"
 #include <string.h>
+#include <stddef.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
 
 namespace udp_client_server
 {
 
 
+// ========================= UNIX =========================
+
+/** \brief Check whether an address names a Unix domain socket.
+ *
+ * \param[in] addr  The address as given to a client or server.
+ *
+ * \return true if the address starts with UNIX_ADDRESS_PREFIX.
+ */
+bool is_unix_address(const std::string& addr)
+{
+    return addr.compare(0, strlen(UNIX_ADDRESS_PREFIX), UNIX_ADDRESS_PREFIX) == 0;
+}
+
+/** \brief Bind a sending Unix domain socket to a unique abstract name.
+ *
+ * An unbound socket sends datagrams without a source address, so the
+ * receiver cannot tell its senders apart. Binding with only the address
+ * family lets Linux pick a unique name in the abstract namespace.
+ *
+ * \param[in] socket  The Unix domain datagram socket.
+ *
+ * \return false if the socket could not be bound.
+ */
+bool autobind_unix_socket(int socket)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    return bind(socket, (struct sockaddr *)&address, sizeof(sa_family_t)) == 0;
+}
+
+/** \brief Fill in the address of a Unix domain datagram socket.
+ *
+ * The path follows UNIX_ADDRESS_PREFIX. A path starting with '@' names
+ * a socket in the abstract namespace of Linux, which needs no file.
+ *
+ * \param[in] addr  The address, e.g. "unix:/tmp/cogna.sock".
+ * \param[out] info  The address information pointing to \p address.
+ * \param[out] address  The socket address.
+ *
+ * \return false if the path is empty or too long.
+ */
+static bool init_unix_address(const std::string& addr, struct addrinfo *info, struct sockaddr_un *address)
+{
+    std::string path(addr.substr(strlen(UNIX_ADDRESS_PREFIX)));
+    if(path.empty() || path.size() >= sizeof(address->sun_path))
+    {
+        return false;
+    }
+
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    memcpy(address->sun_path, path.data(), path.size());
+    socklen_t length(offsetof(struct sockaddr_un, sun_path) + path.size() + 1);
+    if(path[0] == '@')
+    {
+        // Abstract names are not terminated, their length is the length of the address
+        address->sun_path[0] = '\0';
+        length = offsetof(struct sockaddr_un, sun_path) + path.size();
+    }
+
+    memset(info, 0, sizeof(*info));
+    info->ai_family = AF_UNIX;
+    info->ai_socktype = SOCK_DGRAM;
+    info->ai_addr = (struct sockaddr *)address;
+    info->ai_addrlen = length;
+    return true;
+}
+
+/** \brief Resolve the address of a destination.
+ *
+ * An address starting with UNIX_ADDRESS_PREFIX is filled into \p unix_info
+ * and \p unix_address, which are then returned. Any other address is
+ * resolved with getaddrinfo() and must be freed with freeaddrinfo().
+ *
+ * \exception udp_client_server_runtime_error
+ * The address or port cannot be resolved.
+ *
+ * \param[in] addr  The address to resolve.
+ * \param[in] port  The port number, ignored by Unix domain sockets.
+ * \param[out] unix_info  The address information of a Unix domain socket.
+ * \param[out] unix_address  The socket address of a Unix domain socket.
+ *
+ * \return The first address found.
+ */
+static struct addrinfo * resolve_address(const std::string& addr, int port, struct addrinfo *unix_info,
+                                         struct sockaddr_un *unix_address)
+{
+    if(is_unix_address(addr))
+    {
+        if(!init_unix_address(addr, unix_info, unix_address))
+        {
+            throw udp_client_server_runtime_error(("invalid unix socket path: \"" + addr + "\"").c_str());
+        }
+        return unix_info;
+    }
+
+    char decimal_port[16];
+    snprintf(decimal_port, sizeof(decimal_port), "%d", port);
+    decimal_port[sizeof(decimal_port) / sizeof(decimal_port[0]) - 1] = '\0';
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+    struct addrinfo *info(NULL);
+    int r(getaddrinfo(addr.c_str(), decimal_port, &hints, &info));
+    if(r != 0 || info == NULL)
+    {
+        throw udp_client_server_runtime_error(("invalid address or port: \"" + addr + ":" + decimal_port + "\"").c_str());
+    }
+    return info;
+}
+
+
+// ========================= ADDRESS =========================
+
+/** \brief Resolve the address of a destination without opening a socket.
+ *
+ * The address is resolved like by a udp_client. Messages are sent to it
+ * through the socket of a udp_client of the same address family.
+ *
+ * \exception udp_client_server_runtime_error
+ * The address or port cannot be resolved.
+ *
+ * \param[in] addr  The address to convert to a numeric IP.
+ * \param[in] port  The port number.
+ */
+udp_address::udp_address(const std::string& addr, int port)
+    : f_port(port)
+    , f_addr(addr)
+{
+    f_addrinfo = resolve_address(addr, port, &f_unix_addrinfo, &f_unix_address);
+}
+
+/** \brief Clean up the address object.
+ */
+udp_address::~udp_address()
+{
+    if(f_addrinfo != &f_unix_addrinfo)
+    {
+        freeaddrinfo(f_addrinfo);
+    }
+}
+
+/** \brief Retrieve the port of this address.
+ *
+ * \return The port as expected in a host integer.
+ */
+int udp_address::get_port() const
+{
+    return f_port;
+}
+
+/** \brief Retrieve a copy of the address as it was specified in the constructor.
+ *
+ * \return A string with a copy of the constructor input address.
+ */
+std::string udp_address::get_addr() const
+{
+    return f_addr;
+}
+
+/** \brief Retrieve the resolved address.
+ *
+ * \return The first address found by getaddrinfo(), owned by this object.
+ */
+const struct addrinfo * udp_address::get_addrinfo() const
+{
+    return f_addrinfo;
+}
+
+/** \brief Check whether the address is an IPv4 or IPv6 multicast group.
+ *
+ * \return true if messages sent to the address are delivered to a group.
+ */
+bool udp_address::is_multicast() const
+{
+    if(f_addrinfo->ai_family == AF_INET)
+    {
+        const struct sockaddr_in *address((const struct sockaddr_in *)f_addrinfo->ai_addr);
+        return IN_MULTICAST(ntohl(address->sin_addr.s_addr));
+    }
+    if(f_addrinfo->ai_family == AF_INET6)
+    {
+        const struct sockaddr_in6 *address((const struct sockaddr_in6 *)f_addrinfo->ai_addr);
+        return IN6_IS_ADDR_MULTICAST(&address->sin6_addr);
+    }
+    return false;
+}
+
+
 // ========================= CLIENT =========================
 
 /** \brief Initialize a UDP client object.
@@ -35,7 +230,8 @@ namespace udp_client_server
  * The \p addr parameter is a textual address. It may be an IPv4 or IPv6
  * address and it can represent a host name or an address defined with
  * just numbers. If the address cannot be resolved then an error occurs
- * and constructor throws.
+ * and constructor throws. An address starting with UNIX_ADDRESS_PREFIX
+ * names a Unix domain datagram socket instead and ignores the port.
  *
  * \note
  * The socket is open in this process. If you fork() or exec() then the
@@ -57,24 +253,27 @@ udp_client::udp_client(const std::string& addr, int port)
     : f_port(port)
     , f_addr(addr)
 {
-    char decimal_port[16];
-    snprintf(decimal_port, sizeof(decimal_port), "%d", f_port);
-    decimal_port[sizeof(decimal_port) / sizeof(decimal_port[0]) - 1] = '\0';
-    struct addrinfo hints;
-    memset(&hints, 0, sizeof(hints));
-    hints.ai_family = AF_UNSPEC;
-    hints.ai_socktype = SOCK_DGRAM;
-    hints.ai_protocol = IPPROTO_UDP;
-    int r(getaddrinfo(addr.c_str(), decimal_port, &hints, &f_addrinfo));
-    if(r != 0 || f_addrinfo == NULL)
+    f_addrinfo = resolve_address(addr, port, &f_unix_addrinfo, &f_unix_address);
+    if(f_addrinfo == &f_unix_addrinfo)
     {
-        throw udp_client_server_runtime_error(("invalid address or port: \"" + addr + ":" + decimal_port + "\"").c_str());
+        // Like UDP, a datagram the receiver has no room for is dropped instead of blocking the sender
+        f_socket = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if(f_socket == -1 || !autobind_unix_socket(f_socket))
+        {
+            if(f_socket != -1)
+            {
+                close(f_socket);
+            }
+            throw udp_client_server_runtime_error(("could not create socket for: \"" + addr + "\"").c_str());
+        }
+        return;
     }
+
     f_socket = socket(f_addrinfo->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
     if(f_socket == -1)
     {
         freeaddrinfo(f_addrinfo);
-        throw udp_client_server_runtime_error(("could not create socket for: \"" + addr + ":" + decimal_port + "\"").c_str());
+        throw udp_client_server_runtime_error(("could not create socket for: \"" + addr + ":" + std::to_string(port) + "\"").c_str());
     }
 }
 
@@ -85,7 +284,10 @@ udp_client::udp_client(const std::string& addr, int port)
  */
 udp_client::~udp_client()
 {
-    freeaddrinfo(f_addrinfo);
+    if(f_addrinfo != &f_unix_addrinfo)
+    {
+        freeaddrinfo(f_addrinfo);
+    }
     close(f_socket);
 }
 
@@ -128,6 +330,19 @@ std::string udp_client::get_addr() const
     return f_addr;
 }
 
+/** \brief Retrieve the resolved destination address.
+ *
+ * This function returns the first address found by getaddrinfo() in the
+ * constructor. It can be used to send messages to the same destination
+ * through another socket, for example with sendmmsg().
+ *
+ * \return The resolved address, owned by the UDP client.
+ */
+const struct addrinfo * udp_client::get_addrinfo() const
+{
+    return f_addrinfo;
+}
+
 /** \brief Send a message through this UDP client.
  *
  * This function sends \p msg through the UDP client socket. The function
@@ -150,6 +365,24 @@ int udp_client::send(const char *msg, size_t size)
     return sendto(f_socket, msg, size, 0, f_addrinfo->ai_addr, f_addrinfo->ai_addrlen);
 }
 
+/** \brief Send a message through this UDP client to another destination.
+ *
+ * The destination must use the address family of this client, so several
+ * destinations share one socket.
+ *
+ * \param[in] msg  The message to send.
+ * \param[in] size  The number of bytes representing this message.
+ * \param[in] destination  The resolved destination.
+ *
+ * \return -1 if an error occurs, otherwise the number of bytes sent. errno
+ * is set accordingly on error.
+ */
+int udp_client::send(const char *msg, size_t size, const udp_address& destination)
+{
+    const struct addrinfo *info(destination.get_addrinfo());
+    return sendto(f_socket, msg, size, 0, info->ai_addr, info->ai_addrlen);
+}
+
 
 
 // ========================= SEVER =========================
@@ -164,7 +397,9 @@ int udp_client::send(const char *msg, size_t size)
  * and/or port, you'll have to create a server for each.
  *
  * The address is a string and it can represent an IPv4 or IPv6
- * address.
+ * address. An address starting with UNIX_ADDRESS_PREFIX binds a Unix
+ * domain datagram socket to the path instead, replacing a stale socket
+ * file. The file is removed again by the destructor.
  *
  * Note that this function calls connect() to connect the socket
  * to the specified address. To accept data on different UDP addresses
@@ -185,11 +420,40 @@ int udp_client::send(const char *msg, size_t size)
  *
  * \param[in] addr  The address we receive on.
  * \param[in] port  The port we receive from.
+ * \param[in] reuse_port  Set SO_REUSEPORT, so that several servers can
+ *                        bind the same address and port. The kernel then
+ *                        distributes the senders over them.
  */
-udp_server::udp_server(const std::string& addr, int port)
+udp_server::udp_server(const std::string& addr, int port, bool reuse_port)
     : f_port(port)
     , f_addr(addr)
 {
+    if(is_unix_address(addr))
+    {
+        if(reuse_port || !init_unix_address(addr, &f_unix_addrinfo, &f_unix_address))
+        {
+            throw udp_client_server_runtime_error(("invalid unix socket path: \"" + addr + "\"").c_str());
+        }
+        f_addrinfo = &f_unix_addrinfo;
+        f_socket = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if(f_socket == -1)
+        {
+            throw udp_client_server_runtime_error(("could not create unix socket for: \"" + addr + "\"").c_str());
+        }
+        // A socket file left behind by a previous server would make bind() fail
+        struct stat status;
+        if(f_unix_address.sun_path[0] != '\0' && lstat(f_unix_address.sun_path, &status) == 0 && S_ISSOCK(status.st_mode))
+        {
+            unlink(f_unix_address.sun_path);
+        }
+        if(bind(f_socket, f_addrinfo->ai_addr, f_addrinfo->ai_addrlen) != 0)
+        {
+            close(f_socket);
+            throw udp_client_server_runtime_error(("could not bind unix socket with: \"" + addr + "\"").c_str());
+        }
+        return;
+    }
+
     char decimal_port[16];
     snprintf(decimal_port, sizeof(decimal_port), "%d", f_port);
     decimal_port[sizeof(decimal_port) / sizeof(decimal_port[0]) - 1] = '\0';
@@ -209,6 +473,16 @@ udp_server::udp_server(const std::string& addr, int port)
         freeaddrinfo(f_addrinfo);
         throw udp_client_server_runtime_error(("could not create UDP socket for: \"" + addr + ":" + decimal_port + "\"").c_str());
     }
+    if(reuse_port)
+    {
+        int enable(1);
+        if(setsockopt(f_socket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0)
+        {
+            freeaddrinfo(f_addrinfo);
+            close(f_socket);
+            throw udp_client_server_runtime_error(("could not share UDP port with: \"" + addr + ":" + decimal_port + "\"").c_str());
+        }
+    }
     r = bind(f_socket, f_addrinfo->ai_addr, f_addrinfo->ai_addrlen);
     if(r != 0)
     {
@@ -224,7 +498,14 @@ udp_server::udp_server(const std::string& addr, int port)
  */
 udp_server::~udp_server()
 {
-    freeaddrinfo(f_addrinfo);
+    if(f_addrinfo != &f_unix_addrinfo)
+    {
+        freeaddrinfo(f_addrinfo);
+    }
+    else if(f_unix_address.sun_path[0] != '\0')
+    {
+        unlink(f_unix_address.sun_path);
+    }
     close(f_socket);
 }
 
@@ -288,6 +569,30 @@ int udp_server::recv(char *msg, size_t max_size)
     return ::recv(f_socket, msg, max_size, 0);
 }
 
+/** \brief Wait for one or more messages to come in.
+ *
+ * This function blocks until at least one message is received and then
+ * returns all messages already queued on the socket, up to \p max_msgs,
+ * using a single recvmmsg() call.
+ *
+ * Every entry of \p msgs must point to its own buffer through msg_iov.
+ * After the call, msg_len of each filled entry holds the number of
+ * bytes received in that buffer.
+ *
+ * Passing MSG_DONTWAIT as \p flags makes the call return immediately
+ * with -1 and errno set to EAGAIN if no message is queued.
+ *
+ * \param[in,out] msgs  The message headers describing the buffers to fill.
+ * \param[in] max_msgs  The number of entries in \p msgs.
+ * \param[in] flags  The flags passed to recvmmsg().
+ *
+ * \return The number of messages received or -1 if an error occurs.
+ */
+int udp_server::recv_batch(struct mmsghdr *msgs, unsigned int max_msgs, int flags)
+{
+    return ::recvmmsg(f_socket, msgs, max_msgs, flags, NULL);
+}
+
 /** \brief Wait for data to come in.
  *
  * This function waits for a given amount of time for data to come in. If
@@ -0,0 +1,191 @@
+/**
+ * @file frame_protocol.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of the framing of large messages.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "frame_protocol.hpp"
+#include <cstring>
+
+namespace utils{
+
+static const char FRAME_MAGIC[4] = {'C', 'G', 'N', 'F'};
+
+static inline void put_uint(std::string &out, uint32_t value, int bytes){
+	for(int i=0; i < bytes; i++){
+		out.push_back((char)((value >> (8 * i)) & 0xFF));
+	}
+}
+
+static inline uint32_t get_uint(const char *data, int bytes){
+	uint32_t value = 0;
+	for(int i=0; i < bytes; i++){
+		value |= (uint32_t)(uint8_t)data[i] << (8 * i);
+	}
+	return value;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool is_frame(const char *data, size_t size){
+	return size >= FRAME_HEADER_SIZE && memcmp(data, FRAME_MAGIC, sizeof(FRAME_MAGIC)) == 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int encode_frames(std::string &out, uint32_t message_id, const char *data, size_t size, size_t datagram_size){
+	out.clear();
+	if(datagram_size <= FRAME_HEADER_SIZE || size > FRAME_MAX_MESSAGE_SIZE){
+		return -1;
+	}
+
+	size_t part_size = datagram_size - FRAME_HEADER_SIZE;
+	size_t count = (size + part_size - 1) / part_size;
+	if(count == 0){
+		count = 1;
+	}
+	if(count > FRAME_MAX_COUNT){
+		return -1;
+	}
+
+	out.reserve(size + count * FRAME_HEADER_SIZE);
+	for(size_t index=0; index < count; index++){
+		size_t offset = index * part_size;
+		size_t length = (size - offset < part_size) ? size - offset : part_size;
+		out.append(FRAME_MAGIC, sizeof(FRAME_MAGIC));
+		put_uint(out, message_id, 4);
+		put_uint(out, (uint32_t)index, 2);
+		put_uint(out, (uint32_t)count, 2);
+		put_uint(out, (uint32_t)size, 4);
+		out.append(data + offset, length);
+	}
+	return (int)count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+frame_assembler::frame_assembler(){
+	_pending.resize(FRAME_MAX_PENDING);
+	for(unsigned int i=0; i < _pending.size(); i++){
+		_pending[i].source = 0;
+		_pending[i].message_id = 0;
+		_pending[i].received_number = 0;
+		_pending[i].is_assembling = false;
+		_pending[i].has_completed = false;
+		_pending[i].last_use = 0;
+	}
+	_completed = 0;
+	_frame_counter = 0;
+	_incomplete = 0;
+	_malformed = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool frame_assembler::add(const char *data, size_t size, uint64_t source){
+	if(!is_frame(data, size)){
+		_malformed++;
+		return false;
+	}
+
+	uint32_t message_id = get_uint(data + 4, 4);
+	uint32_t index = get_uint(data + 8, 2);
+	uint32_t count = get_uint(data + 10, 2);
+	uint32_t message_size = get_uint(data + 12, 4);
+	size_t length = size - FRAME_HEADER_SIZE;
+
+	// Every frame but the last one starts at a multiple of its own size
+	size_t offset = (index + 1 == count) ? message_size - length : index * length;
+	if(count == 0 || index >= count || message_size > FRAME_MAX_MESSAGE_SIZE || length > message_size ||
+	   offset + length > message_size){
+		_malformed++;
+		return false;
+	}
+
+	pending_message &pending = find_pending(source, message_id);
+	pending.last_use = ++_frame_counter;
+	if(!pending.is_assembling && pending.has_completed){
+		return false;
+	}
+
+	if(!pending.is_assembling || count != pending.received.size() || message_size != pending.message.size()){
+		if(pending.is_assembling){
+			_incomplete++;
+		}
+		pending.message.resize(message_size);
+		pending.received.assign(count, false);
+		pending.received_number = 0;
+		pending.is_assembling = true;
+	}
+
+	if(!pending.received[index]){
+		memcpy(&pending.message[offset], data + FRAME_HEADER_SIZE, length);
+		pending.received[index] = true;
+		pending.received_number++;
+	}
+
+	if(pending.received_number < count){
+		return false;
+	}
+
+	pending.is_assembling = false;
+	pending.has_completed = true;
+	_completed = &pending - _pending.data();
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+frame_assembler::pending_message& frame_assembler::find_pending(uint64_t source, uint32_t message_id){
+	int oldest = 0;
+	for(unsigned int i=0; i < _pending.size(); i++){
+		pending_message &pending = _pending[i];
+		if((pending.is_assembling || pending.has_completed) && pending.source == source &&
+		   pending.message_id == message_id){
+			return pending;
+		}
+		// Places of completed messages are taken before those of incomplete ones, the least recently used first
+		if(pending.is_assembling != _pending[oldest].is_assembling){
+			if(!pending.is_assembling){
+				oldest = i;
+			}
+		}
+		else if(pending.last_use < _pending[oldest].last_use){
+			oldest = i;
+		}
+	}
+
+	pending_message &pending = _pending[oldest];
+	if(pending.is_assembling){
+		_incomplete++;
+	}
+	pending.source = source;
+	pending.message_id = message_id;
+	pending.is_assembling = false;
+	pending.has_completed = false;
+	return pending;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const std::string& frame_assembler::get_message(){
+	return _pending[_completed].message;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long frame_assembler::get_incomplete(){
+	return _incomplete;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long frame_assembler::get_malformed(){
+	return _malformed;
+}
+
+} //namespace utils
@@ -0,0 +1,73 @@
+/**
+ * @file input_signal.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of input_signal class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "input_signal.hpp"
+#include <climits>
+#include <ctime>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace utils{
+
+input_signal::input_signal(){
+	_counter.store(0);
+	_waiters.store(0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void input_signal::notify(){
+	_counter.fetch_add(1, std::memory_order_seq_cst);
+	if(_waiters.load(std::memory_order_seq_cst) > 0){
+		syscall(SYS_futex, (uint32_t*)&_counter, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool input_signal::wait(uint32_t *seen, int64_t timeout_us){
+	struct timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	int64_t deadline_ns = (int64_t)deadline.tv_sec * 1000000000 + deadline.tv_nsec + timeout_us * 1000;
+
+	_waiters.fetch_add(1, std::memory_order_seq_cst);
+	uint32_t counter = _counter.load(std::memory_order_seq_cst);
+	while(counter == *seen){
+		struct timespec timeout;
+		struct timespec *timeout_pointer = nullptr;
+		if(timeout_us >= 0){
+			struct timespec now;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			int64_t remaining_ns = deadline_ns - ((int64_t)now.tv_sec * 1000000000 + now.tv_nsec);
+			if(remaining_ns <= 0){
+				break;
+			}
+			timeout.tv_sec = remaining_ns / 1000000000;
+			timeout.tv_nsec = remaining_ns % 1000000000;
+			timeout_pointer = &timeout;
+		}
+		syscall(SYS_futex, (uint32_t*)&_counter, FUTEX_WAIT_PRIVATE, counter, timeout_pointer, nullptr, 0);
+		counter = _counter.load(std::memory_order_seq_cst);
+	}
+	_waiters.fetch_sub(1, std::memory_order_seq_cst);
+
+	bool is_signalled = (counter != *seen);
+	*seen = counter;
+	return is_signalled;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+uint32_t input_signal::get_counter(){
+	return _counter.load(std::memory_order_seq_cst);
+}
+
+} //namespace utils
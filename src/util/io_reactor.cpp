@@ -0,0 +1,204 @@
+/**
+ * @file io_reactor.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of io_reactor class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "io_reactor.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#ifndef REACTOR_EVENT_NUMBER
+#define REACTOR_EVENT_NUMBER 64
+#endif //REACTOR_EVENT_NUMBER
+
+#ifndef REACTOR_WATCH_TIMEOUT_MS
+#define REACTOR_WATCH_TIMEOUT_MS 100
+#endif //REACTOR_WATCH_TIMEOUT_MS
+
+namespace utils{
+
+io_reactor::io_reactor(std::vector<networking_client*> clients, int thread_number){
+	for(unsigned int i=0; i < clients.size(); i++){
+		if(!clients[i]->is_local()){
+			_clients.push_back(clients[i]);
+			for(int queue=0; queue < clients[i]->get_queue_number(); queue++){
+				receive_target target = {clients[i], queue};
+				_targets.push_back(target);
+			}
+		}
+		else{
+			_local_clients.push_back(clients[i]);
+		}
+	}
+	_requested_thread_number = thread_number > 0 ? thread_number : 1;
+	_stop_fd = -1;
+	_is_stopping.store(false);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+io_reactor::~io_reactor(){
+	stop();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int io_reactor::start(){
+	if(_threads.size() > 0 || _watchers.size() > 0){
+		return 0;
+	}
+
+	_is_stopping.store(false);
+	for(unsigned int i=0; i < _local_clients.size(); i++){
+		if(_local_clients[i]->get_input_signal() != nullptr){
+			_watchers.push_back(new std::thread(&io_reactor::watch, this, _local_clients[i]));
+		}
+	}
+
+	if(_clients.size() == 0){
+		return 0;
+	}
+
+	_stop_fd = eventfd(0, EFD_CLOEXEC);
+	if(_stop_fd < 0){
+		std::cout << "[ERROR] Could not create eventfd of io reactor: " << strerror(errno) << std::endl;
+		return -1;
+	}
+
+	unsigned int thread_number = std::min((unsigned int)_requested_thread_number, (unsigned int)_targets.size());
+	for(unsigned int i=0; i < thread_number; i++){
+		int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if(epoll_fd < 0){
+			std::cout << "[ERROR] Could not create epoll instance of io reactor: " << strerror(errno) << std::endl;
+			close_fds();
+			return -1;
+		}
+		_epoll_fds.push_back(epoll_fd);
+
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.ptr = nullptr;
+		if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _stop_fd, &event) < 0){
+			std::cout << "[ERROR] Could not register eventfd of io reactor: " << strerror(errno) << std::endl;
+			close_fds();
+			return -1;
+		}
+	}
+
+	// The queues of a client follow each other, so they are received by different threads if there are enough
+	for(unsigned int i=0; i < _targets.size(); i++){
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.ptr = &_targets[i];
+		if(epoll_ctl(_epoll_fds[i % thread_number], EPOLL_CTL_ADD, _targets[i].client->get_socket(_targets[i].queue),
+					 &event) < 0){
+			std::cout << "[ERROR] Could not register socket of port " << _targets[i].client->get_port()
+					  << " in io reactor: " << strerror(errno) << std::endl;
+			close_fds();
+			return -1;
+		}
+	}
+
+	for(unsigned int i=0; i < thread_number; i++){
+		_threads.push_back(new std::thread(&io_reactor::run, this, _epoll_fds[i]));
+	}
+
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void io_reactor::stop(){
+	if(_stop_fd >= 0 && _threads.size() > 0){
+		uint64_t signal = 1;
+		if(write(_stop_fd, &signal, sizeof(signal)) != sizeof(signal)){
+			std::cout << "[ERROR] Could not signal io reactor to stop: " << strerror(errno) << std::endl;
+		}
+	}
+
+	for(unsigned int i=0; i < _threads.size(); i++){
+		_threads[i]->join();
+		delete _threads[i];
+		_threads[i] = nullptr;
+	}
+	_threads.clear();
+
+	_is_stopping.store(true);
+	for(unsigned int i=0; i < _watchers.size(); i++){
+		_watchers[i]->join();
+		delete _watchers[i];
+		_watchers[i] = nullptr;
+	}
+	_watchers.clear();
+
+	close_fds();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int io_reactor::get_thread_number(){
+	return _threads.size();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void io_reactor::run(int epoll_fd){
+	struct epoll_event events[REACTOR_EVENT_NUMBER];
+
+	while(true){
+		int event_number = epoll_wait(epoll_fd, events, REACTOR_EVENT_NUMBER, -1);
+		if(event_number < 0){
+			if(errno == EINTR){
+				continue;
+			}
+			std::cout << "[ERROR] Waiting for sockets in io reactor failed: " << strerror(errno) << std::endl;
+			return;
+		}
+
+		for(int i=0; i < event_number; i++){
+			// The eventfd is never read, so it stays readable and wakes every thread up.
+			if(events[i].data.ptr == nullptr){
+				return;
+			}
+			receive_target *target = (receive_target*)events[i].data.ptr;
+			target->client->receive_pending(target->queue);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void io_reactor::watch(networking_client *client){
+	while(!_is_stopping.load()){
+		client->watch_local(REACTOR_WATCH_TIMEOUT_MS);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void io_reactor::close_fds(){
+	for(unsigned int i=0; i < _epoll_fds.size(); i++){
+		close(_epoll_fds[i]);
+	}
+	_epoll_fds.clear();
+
+	if(_stop_fd >= 0){
+		close(_stop_fd);
+		_stop_fd = -1;
+	}
+}
+
+} //namespace utils
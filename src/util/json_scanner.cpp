@@ -0,0 +1,553 @@
+/**
+ * @file json_scanner.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of json_scanner class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "json_scanner.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef JSON_SCANNER_MAX_DEPTH
+#define JSON_SCANNER_MAX_DEPTH 256		// Deeper nested messages are rejected instead of risking the stack
+#endif //JSON_SCANNER_MAX_DEPTH
+
+namespace utils{
+
+static inline bool is_digit(char c){
+	return c >= '0' && c <= '9';
+}
+
+static inline int hex_value(char c){
+	if(c >= '0' && c <= '9') return c - '0';
+	if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+static bool read_hex4(const char *data, unsigned int *code){
+	*code = 0;
+	for(int i=0; i < 4; i++){
+		int value = hex_value(data[i]);
+		if(value < 0){
+			return false;
+		}
+		*code = (*code << 4) | value;
+	}
+	return true;
+}
+
+static void append_utf8(std::string &out, unsigned int code){
+	if(code < 0x80){
+		out.push_back((char)code);
+	}
+	else if(code < 0x800){
+		out.push_back((char)(0xC0 | (code >> 6)));
+		out.push_back((char)(0x80 | (code & 0x3F)));
+	}
+	else if(code < 0x10000){
+		out.push_back((char)(0xE0 | (code >> 12)));
+		out.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+		out.push_back((char)(0x80 | (code & 0x3F)));
+	}
+	else{
+		out.push_back((char)(0xF0 | (code >> 18)));
+		out.push_back((char)(0x80 | ((code >> 12) & 0x3F)));
+		out.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+		out.push_back((char)(0x80 | (code & 0x3F)));
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int json_scanner::add_key(const std::string &key, int width){
+	if(width < 1){
+		width = 1;
+	}
+
+	int index = find_key(key.data(), key.size());
+	if(index >= 0){
+		if(width > _widths[index]){
+			_offsets[index] = _values.size();
+			_widths[index] = width;
+			_values.resize(_values.size() + width, 0.0f);
+		}
+		return index;
+	}
+
+	_keys.push_back(key);
+	_offsets.push_back(_values.size());
+	_widths.push_back(width);
+	_lengths.push_back(0);
+	_values.resize(_values.size() + width, 0.0f);
+	_contained.push_back(false);
+	return _keys.size() - 1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool json_scanner::is_contained(int index){
+	return _contained[index];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+float json_scanner::get_value(int index){
+	return _values[_offsets[index]];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const float* json_scanner::get_values(int index){
+	return &_values[_offsets[index]];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int json_scanner::get_length(int index){
+	return _lengths[index];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int json_scanner::get_key_number(){
+	return _keys.size();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool json_scanner::scan(const char *data, size_t size){
+	std::fill(_contained.begin(), _contained.end(), false);
+	_curr = data;
+	_end = data + size;
+
+	bool is_valid = false;
+	skip_whitespace();
+	if(_curr < _end && *_curr == '{'){
+		_curr++;
+		skip_whitespace();
+		if(_curr < _end && *_curr == '}'){
+			_curr++;
+			is_valid = true;
+		}
+
+		while(!is_valid){
+			const char *key;
+			size_t length;
+			bool is_escaped;
+			skip_whitespace();
+			if(!read_string(&key, &length, &is_escaped)){
+				break;
+			}
+
+			int index;
+			if(is_escaped){
+				if(!unescape(key, length)){
+					break;
+				}
+				index = find_key(_key_buffer.data(), _key_buffer.size());
+			}
+			else{
+				index = find_key(key, length);
+			}
+
+			skip_whitespace();
+			if(_curr >= _end || *_curr != ':'){
+				break;
+			}
+			_curr++;
+			skip_whitespace();
+			if(_curr >= _end){
+				break;
+			}
+
+			if(index >= 0 && (*_curr == '-' || is_digit(*_curr))){
+				if(!read_number(&_values[_offsets[index]])){
+					break;
+				}
+				_lengths[index] = 1;
+				_contained[index] = true;
+			}
+			else if(index >= 0 && (*_curr == 't' || *_curr == 'f')){
+				bool value = (*_curr == 't');
+				if(!read_literal(value ? "true" : "false")){
+					break;
+				}
+				_values[_offsets[index]] = value ? 1.0f : 0.0f;
+				_lengths[index] = 1;
+				_contained[index] = true;
+			}
+			else if(index >= 0 && _widths[index] > 1 && *_curr == '['){
+				if(!read_array(index)){
+					break;
+				}
+			}
+			else{
+				if(!skip_value()){
+					break;
+				}
+				if(index >= 0){
+					_contained[index] = false;	// A later duplicate key replaces the earlier value
+				}
+			}
+
+			skip_whitespace();
+			if(_curr < _end && *_curr == ','){
+				_curr++;
+			}
+			else if(_curr < _end && *_curr == '}'){
+				_curr++;
+				is_valid = true;
+			}
+			else{
+				break;
+			}
+		}
+	}
+
+	skip_whitespace();
+	if(!is_valid || _curr != _end){
+		std::fill(_contained.begin(), _contained.end(), false);
+		return false;
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void json_scanner::skip_whitespace(){
+	while(_curr < _end && (*_curr == ' ' || *_curr == '\n' || *_curr == '\r' || *_curr == '\t')){
+		_curr++;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool json_scanner::read_string(const char **begin, size_t *length, bool *is_escaped){
+	if(_curr >= _end || *_curr != '"'){
+		return false;
+	}
+	_curr++;
+	*begin = _curr;
+	*is_escaped = false;
+
+	while(_curr < _end){
+		char c = *_curr;
+		if(c == '"'){
+			*length = _curr - *begin;
+			_curr++;
+			return true;
+		}
+		else if(c == '\\'){
+			*is_escaped = true;
+			_curr += 2;
+		}
+		else if((unsigned char)c < 0x20){
+			return false;
+		}
+		else{
+			_curr++;
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool json_scanner::unescape(const char *begin, size_t length){
+	const char *end = begin + length;
+	_key_buffer.clear();
+
+	for(const char *c = begin; c < end; c++){
+		if(*c != '\\'){
+			_key_buffer.push_back(*c);
+			continue;
+		}
+
+		c++;
+		switch(*c){
+			case '"':  _key_buffer.push_back('"'); break;
+			case '\\': _key_buffer.push_back('\\'); break;
+			case '/':  _key_buffer.push_back('/'); break;
+			case 'b':  _key_buffer.push_back('\b'); break;
+			case 'f':  _key_buffer.push_back('\f'); break;
+			case 'n':  _key_buffer.push_back('\n'); break;
+			case 'r':  _key_buffer.push_back('\r'); break;
+			case 't':  _key_buffer.push_back('\t'); break;
+			case 'u':{
+				unsigned int code;
+				if(end - c < 5 || !read_hex4(c + 1, &code)){
+					return false;
+				}
+				c += 4;
+				if(code >= 0xD800 && code <= 0xDBFF){
+					unsigned int low;
+					if(end - c < 7 || c[1] != '\\' || c[2] != 'u' || !read_hex4(c + 3, &low) ||
+					   low < 0xDC00 || low > 0xDFFF){
+						return false;
+					}
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					c += 6;
+				}
+				append_utf8(_key_buffer, code);
+				break;
+			}
+			default:
+				return false;
+		}
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool json_scanner::read_literal(const char *literal){
+	size_t length = strlen(literal);
+	if((size_t)(_end - _curr) < length || memcmp(_curr, literal, length) != 0){
+		return false;
+	}
+	_curr += length;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool json_scanner::read_number(float *value){
+	const char *begin = _curr;
+
+	if(_curr < _end && *_curr == '-'){
+		_curr++;
+	}
+	if(_curr < _end && *_curr == '0'){
+		_curr++;
+	}
+	else if(_curr < _end && is_digit(*_curr)){
+		while(_curr < _end && is_digit(*_curr)) _curr++;
+	}
+	else{
+		return false;
+	}
+
+	if(_curr < _end && *_curr == '.'){
+		_curr++;
+		if(_curr >= _end || !is_digit(*_curr)){
+			return false;
+		}
+		while(_curr < _end && is_digit(*_curr)) _curr++;
+	}
+
+	if(_curr < _end && (*_curr == 'e' || *_curr == 'E')){
+		_curr++;
+		if(_curr < _end && (*_curr == '+' || *_curr == '-')){
+			_curr++;
+		}
+		if(_curr >= _end || !is_digit(*_curr)){
+			return false;
+		}
+		while(_curr < _end && is_digit(*_curr)) _curr++;
+	}
+
+	if(value == nullptr){
+		return true;
+	}
+
+	// strtod needs a terminated string, and the message may continue with characters strtod would accept.
+	char number[64];
+	size_t length = _curr - begin;
+	if(length >= sizeof(number)){
+		*value = (float)strtod(std::string(begin, length).c_str(), nullptr);
+		return true;
+	}
+	memcpy(number, begin, length);
+	number[length] = '\0';
+	*value = (float)strtod(number, nullptr);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool json_scanner::skip_value(){
+	// Containers are skipped by tracking their nesting, with one bit per level telling if it is an object.
+	unsigned char is_object[JSON_SCANNER_MAX_DEPTH / 8] = {0};
+	int depth = 0;
+	bool expect_key = false;
+
+	while(true){
+		skip_whitespace();
+		if(_curr >= _end){
+			return false;
+		}
+
+		if(expect_key){
+			const char *key;
+			size_t length;
+			bool is_escaped;
+			if(!read_string(&key, &length, &is_escaped)){
+				return false;
+			}
+			skip_whitespace();
+			if(_curr >= _end || *_curr != ':'){
+				return false;
+			}
+			_curr++;
+			skip_whitespace();
+			if(_curr >= _end){
+				return false;
+			}
+			expect_key = false;
+		}
+
+		char c = *_curr;
+		bool opened = false;
+		if(c == '{' || c == '['){
+			if(depth >= JSON_SCANNER_MAX_DEPTH){
+				return false;
+			}
+			if(c == '{'){
+				is_object[depth / 8] |= (1 << (depth % 8));
+			}
+			else{
+				is_object[depth / 8] &= ~(1 << (depth % 8));
+			}
+			depth++;
+			_curr++;
+			skip_whitespace();
+			char closing = (c == '{') ? '}' : ']';
+			if(_curr < _end && *_curr == closing){
+				_curr++;
+				depth--;
+			}
+			else{
+				expect_key = (c == '{');
+				opened = true;
+			}
+		}
+		else if(c == '"'){
+			const char *begin;
+			size_t length;
+			bool is_escaped;
+			if(!read_string(&begin, &length, &is_escaped)){
+				return false;
+			}
+		}
+		else if(c == 't'){
+			if(!read_literal("true")) return false;
+		}
+		else if(c == 'f'){
+			if(!read_literal("false")) return false;
+		}
+		else if(c == 'n'){
+			if(!read_literal("null")) return false;
+		}
+		else if(c == '-' || is_digit(c)){
+			if(!read_number(nullptr)) return false;
+		}
+		else{
+			return false;
+		}
+
+		if(opened){
+			continue;
+		}
+
+		// A value was completed. Close all containers ending after it.
+		while(true){
+			if(depth == 0){
+				return true;
+			}
+			skip_whitespace();
+			if(_curr >= _end){
+				return false;
+			}
+			bool in_object = is_object[(depth - 1) / 8] & (1 << ((depth - 1) % 8));
+			if(*_curr == ','){
+				_curr++;
+				expect_key = in_object;
+				break;
+			}
+			if(*_curr != (in_object ? '}' : ']')){
+				return false;
+			}
+			_curr++;
+			depth--;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool json_scanner::read_array(int index){
+	const char *begin = _curr;
+	float *values = &_values[_offsets[index]];
+	int length = 0;
+
+	_curr++;
+	skip_whitespace();
+	if(_curr < _end && *_curr == ']'){
+		_curr++;
+		_lengths[index] = 0;
+		_contained[index] = true;
+		return true;
+	}
+
+	while(_curr < _end){
+		// Elements beyond the width are checked, but not stored
+		float *value = (length < _widths[index]) ? &values[length] : nullptr;
+		float ignored;
+		if(*_curr == '-' || is_digit(*_curr)){
+			if(!read_number(value != nullptr ? value : &ignored)){
+				return false;
+			}
+		}
+		else if(*_curr == 't' || *_curr == 'f'){
+			bool is_true = (*_curr == 't');
+			if(!read_literal(is_true ? "true" : "false")){
+				return false;
+			}
+			if(value != nullptr){
+				*value = is_true ? 1.0f : 0.0f;
+			}
+		}
+		else{
+			// Not a flat array of numbers, so it is skipped like the value of an unregistered key
+			_curr = begin;
+			_contained[index] = false;
+			return skip_value();
+		}
+		length++;
+
+		skip_whitespace();
+		if(_curr < _end && *_curr == ','){
+			_curr++;
+			skip_whitespace();
+		}
+		else if(_curr < _end && *_curr == ']'){
+			_curr++;
+			_lengths[index] = std::min(length, _widths[index]);
+			_contained[index] = true;
+			return true;
+		}
+		else{
+			return false;
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int json_scanner::find_key(const char *key, size_t length){
+	for(unsigned int i=0; i < _keys.size(); i++){
+		if(_keys[i].size() == length && memcmp(_keys[i].data(), key, length) == 0){
+			return i;
+		}
+	}
+	return -1;
+}
+
+} //namespace utils
@@ -0,0 +1,100 @@
+/**
+ * @file latency_histogram.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of latency_histogram class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "latency_histogram.hpp"
+
+namespace utils{
+
+latency_histogram::latency_histogram(){
+	clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void latency_histogram::record(int64_t latency_ns){
+	if(latency_ns < 0){
+		latency_ns = 0;
+	}
+
+	int bucket = 0;
+	if(latency_ns > 0){
+		bucket = 64 - __builtin_clzll((unsigned long long)latency_ns);
+	}
+	if(bucket >= BUCKET_NUMBER){
+		bucket = BUCKET_NUMBER - 1;
+	}
+
+	_buckets[bucket]++;
+	_count++;
+	_sum += latency_ns;
+	if(latency_ns > _max){
+		_max = latency_ns;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long latency_histogram::get_count() const{
+	return _count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int64_t latency_histogram::get_percentile(double percentile) const{
+	if(_count == 0){
+		return 0;
+	}
+
+	unsigned long long rank = (unsigned long long)(percentile * _count);
+	if(rank >= _count){
+		rank = _count - 1;
+	}
+
+	unsigned long long counted = 0;
+	for(int bucket=0; bucket < BUCKET_NUMBER; bucket++){
+		counted += _buckets[bucket];
+		if(counted > rank){
+			if(bucket == BUCKET_NUMBER - 1){
+				return _max;
+			}
+			int64_t upper_bound = (int64_t)1 << bucket;
+			return upper_bound < _max ? upper_bound : _max;
+		}
+	}
+	return _max;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int64_t latency_histogram::get_mean() const{
+	if(_count == 0){
+		return 0;
+	}
+	return _sum / (int64_t)_count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int64_t latency_histogram::get_max() const{
+	return _max;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void latency_histogram::clear(){
+	for(int bucket=0; bucket < BUCKET_NUMBER; bucket++){
+		_buckets[bucket] = 0;
+	}
+	_count = 0;
+	_sum = 0;
+	_max = 0;
+}
+
+} //namespace utils
@@ -0,0 +1,101 @@
+/**
+ * @file message_exchange.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of message_exchange class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "message_exchange.hpp"
+
+namespace utils{
+
+message_exchange::message_exchange(int policy, size_t capacity){
+	_policy = policy;
+	if(_policy == EXCHANGE_QUEUE){
+		_buffers.resize(capacity > 0 ? capacity : 1);
+	}
+	else{
+		_buffers.resize(3);
+	}
+
+	_middle.store(0);
+	_back = 1;
+	_front = 2;
+	_head.store(0);
+	_tail.store(0);
+	_is_holding = false;
+	_dropped.store(0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool message_exchange::publish(const char *data, size_t size, int64_t arrival){
+	if(_policy == EXCHANGE_QUEUE){
+		size_t head = _head.load(std::memory_order_relaxed);
+		if(head - _tail.load(std::memory_order_acquire) >= _buffers.size()){
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		_buffers[head % _buffers.size()].data.assign(data, size);
+		_buffers[head % _buffers.size()].arrival = arrival;
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	_buffers[_back].data.assign(data, size);
+	_buffers[_back].arrival = arrival;
+	unsigned int previous = _middle.exchange(_back | FRESH_FLAG, std::memory_order_acq_rel);
+	_back = previous & ~FRESH_FLAG;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const exchange_message* message_exchange::consume(size_t published){
+	if(_policy == EXCHANGE_QUEUE){
+		size_t tail = _tail.load(std::memory_order_relaxed);
+		if(_is_holding){
+			tail++;
+			_tail.store(tail, std::memory_order_release);
+			_is_holding = false;
+		}
+		if(tail == _head.load(std::memory_order_acquire) || tail >= published){
+			return nullptr;
+		}
+		_is_holding = true;
+		return &_buffers[tail % _buffers.size()];
+	}
+
+	if((_middle.load(std::memory_order_relaxed) & FRESH_FLAG) == 0){
+		return nullptr;
+	}
+	unsigned int previous = _middle.exchange(_front, std::memory_order_acq_rel);
+	_front = previous & ~FRESH_FLAG;
+	return &_buffers[_front];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+size_t message_exchange::get_published(){
+	if(_policy == EXCHANGE_QUEUE){
+		return _head.load(std::memory_order_acquire);
+	}
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int message_exchange::get_policy(){
+	return _policy;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long message_exchange::get_dropped(){
+	return _dropped.load(std::memory_order_relaxed);
+}
+
+} //namespace utils
@@ -9,68 +9,831 @@
  */
 
 #include "networking_client.hpp"
+#include "relay_table.hpp"
+#include "binary_protocol.hpp"
+#include "frame_protocol.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <stdexcept>
+#include <netinet/in.h>
+#include <netinet/udp.h>
 
-#ifndef BUFFER_SIZE
-#define BUFFER_SIZE 1024
-#endif //BUFFER_SIZE
+#ifndef RECEIVE_BATCH_SIZE
+#define RECEIVE_BATCH_SIZE 32
+#endif //RECEIVE_BATCH_SIZE
+
+#ifndef RECEIVE_SLOT_SIZE
+#define RECEIVE_SLOT_SIZE 65536		// Holds the largest possible UDP payload or 64 KiB of coalesced datagrams
+#endif //RECEIVE_SLOT_SIZE
+
+#ifndef RECEIVE_MIN_SLOT_SIZE
+#define RECEIVE_MIN_SLOT_SIZE 1024
+#endif //RECEIVE_MIN_SLOT_SIZE
+
+#ifndef RECEIVE_QUEUE_SIZE
+#define RECEIVE_QUEUE_SIZE 64
+#endif //RECEIVE_QUEUE_SIZE
+
+static const size_t RECEIVE_CONTROL_SIZE = CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(int));
 
 namespace utils{
 
-networking_client::networking_client(std::string ip, int port, bool is_json){
-	_receiver = new udp_client_server::udp_server(ip, port);
+/**
+ * Returns the arrival stamped by the kernel on a received datagram, or the fallback if it is not stamped.
+ */
+static int64_t datagram_arrival(struct msghdr *header, int64_t fallback){
+	for(struct cmsghdr *control = CMSG_FIRSTHDR(header); control != NULL; control = CMSG_NXTHDR(header, control)){
+		if(control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS){
+			struct timespec stamp;
+			memcpy(&stamp, CMSG_DATA(control), sizeof(stamp));
+			return (int64_t)stamp.tv_sec * 1000000000 + stamp.tv_nsec;
+		}
+	}
+	return fallback;
+}
+
+/**
+ * Returns the size of the datagrams the kernel coalesced into one received buffer, or 0 if it did not.
+ */
+static size_t datagram_segment_size(struct msghdr *header){
+	for(struct cmsghdr *control = CMSG_FIRSTHDR(header); control != NULL; control = CMSG_NXTHDR(header, control)){
+		if(control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO){
+			int segment_size;
+			memcpy(&segment_size, CMSG_DATA(control), sizeof(segment_size));
+			return segment_size > 0 ? (size_t)segment_size : 0;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Returns a hash of the sender address of a received datagram, which tells the frames of different senders apart.
+ */
+static uint64_t datagram_source(struct msghdr *header){
+	uint64_t hash = 14695981039346656037ULL;
+	const unsigned char *address = (const unsigned char*)header->msg_name;
+	for(socklen_t i=0; i < header->msg_namelen; i++){
+		hash = (hash ^ address[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+ * Checks cheaply if a datagram is a delta message. Json messages are only checked for the key, so a message
+ * may be taken as delta needlessly, which is harmless.
+ */
+static bool is_delta_datagram(const char *data, size_t size){
+	if(is_binary_message(data, size)){
+		return is_binary_delta(data, size);
+	}
+	static const char DELTA_KEY[] = "\"delta\"";
+	return std::search(data, data + size, DELTA_KEY, DELTA_KEY + sizeof(DELTA_KEY) - 1) != data + size;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+networking_client::networking_client(std::string ip, int port, bool is_json, int policy, int queues){
+	init(is_json, policy);
+	if(queues < 1){
+		queues = 1;
+	}
+
+	try{
+		for(int i=0; i < queues; i++){
+			_queues.push_back(create_queue(ip, port, queues > 1));
+		}
+	}
+	catch(...){
+		for(unsigned int i=0; i < _queues.size(); i++){
+			delete _queues[i]->receiver;
+			delete _queues[i]->exchange;
+			delete _queues[i]->delta_exchange;
+			delete _queues[i];
+		}
+		throw;
+	}
+	// The delta exchanges come last, so a message of the main exchange with the same arrival is applied first
+	for(int i=0; i < queues; i++){
+		_exchanges.push_back(_queues[i]->exchange);
+	}
+	for(int i=0; i < queues; i++){
+		if(_queues[i]->delta_exchange != nullptr){
+			_exchanges.push_back(_queues[i]->delta_exchange);
+		}
+	}
+	_queue_messages.assign(_exchanges.size(), nullptr);
+	_queue_published.assign(_exchanges.size(), 0);
+	_aggregator.set_producer_number(queues);
+	set_receive_buffer_size(RECEIVE_SLOT_SIZE);
+}
+
+networking_client::networking_client(std::string shm_name, bool is_json, int policy){
+	init(is_json, policy);
+	_local_ring = new shm_ring();
+	if(_local_ring->open(shm_name) != 0){
+		delete _local_ring;
+		throw std::runtime_error("could not attach to shared memory ring " + shm_name);
+	}
+	_local_queue = create_queue("", 0, false);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::init(bool is_json, int policy){
+	_local_ring = nullptr;
+	_local_queue = nullptr;
+	_watched_head = 0;
+	_input_signal = nullptr;
+	_relay = nullptr;
+	_receive_slot_size = 0;
+	_is_coalescing = false;
+	_local_message.arrival = 0;
+	_policy = policy;
+	_is_aggregating = false;
 	_is_json = is_json;
+	_is_hashtable_parsed = true;
+	_is_snapshot_cleared = true;
+	_is_delta_stream = false;
+	_is_tick_cleared = false;
+	_stored_arrival = 0;
+
+	// Delta messages only contain changed channels, the others keep their value
+	_delta_key = _scanner.add_key("delta");
+	_scanner_slots.resize(_delta_key + 1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+networking_client::receive_queue* networking_client::create_queue(const std::string &ip, int port, bool is_shared){
+	receive_queue *queue = new receive_queue();
+	queue->index = _queues.size();
+	queue->receiver = nullptr;
+	queue->exchange = nullptr;
+	queue->delta_exchange = nullptr;
+	queue->is_delta_stream = false;
+	queue->pending_data = nullptr;
+	queue->pending_size = 0;
+	queue->pending_arrival = 0;
+	// The keys of both scanners must have the same indices, so the queue starts with the keys registered so far
+	queue->scanner = _scanner;
+	if(ip.empty()){
+		return queue;
+	}
+
+	try{
+		queue->receiver = new udp_client_server::udp_server(ip, port, is_shared);
+	}
+	catch(...){
+		delete queue;
+		throw;
+	}
+	queue->exchange = new message_exchange(_policy, RECEIVE_QUEUE_SIZE);
+	if(_policy == EXCHANGE_LATEST){
+		queue->delta_exchange = new message_exchange(EXCHANGE_QUEUE, RECEIVE_QUEUE_SIZE);
+	}
+	queue->vectors.resize(RECEIVE_BATCH_SIZE);
+	queue->headers.resize(RECEIVE_BATCH_SIZE);
+	queue->controls.resize(RECEIVE_BATCH_SIZE * RECEIVE_CONTROL_SIZE);
+	queue->sources.resize(RECEIVE_BATCH_SIZE);
+	memset(queue->headers.data(), 0, queue->headers.size() * sizeof(struct mmsghdr));
+
+	// Let the kernel stamp every datagram on arrival. Without it the receiving thread stamps them.
+	int enable = 1;
+	setsockopt(queue->receiver->get_socket(), SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable));
+	return queue;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
 networking_client::~networking_client(){
-	delete _receiver;
+	for(unsigned int i=0; i < _queues.size(); i++){
+		delete _queues[i]->receiver;
+		delete _queues[i]->exchange;
+		delete _queues[i]->delta_exchange;
+		delete _queues[i];
+	}
+	delete _local_queue;
+	delete _local_ring;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
 std::string networking_client::get_ip(){
-	return _receiver->get_addr();
+	if(_local_ring != nullptr){
+		return "shm:" + _local_ring->get_name();
+	}
+	return _queues[0]->receiver->get_addr();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
 int networking_client::get_port(){
-	return _receiver->get_port();
+	if(_local_ring != nullptr){
+		return 0;
+	}
+	return _queues[0]->receiver->get_port();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool networking_client::is_local(){
+	return _local_ring != nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+std::string networking_client::get_shm_name(){
+	if(_local_ring != nullptr){
+		return _local_ring->get_name();
+	}
+	return "";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_client::set_receive_buffer_size(size_t size){
+	if(_queues.empty()){
+		return 0;
+	}
+	if(size < RECEIVE_MIN_SLOT_SIZE || size > RECEIVE_SLOT_SIZE){
+		std::cout << "[ERROR] Receive buffer size of port " << get_port() << " must be between "
+				  << RECEIVE_MIN_SLOT_SIZE << " and " << RECEIVE_SLOT_SIZE << " bytes." << std::endl;
+		return -1;
+	}
+
+	_receive_slot_size = size;
+	// Coalesced datagrams can fill up to 64 KiB, so smaller buffers would truncate them.
+	int enable = (_receive_slot_size >= RECEIVE_SLOT_SIZE) ? 1 : 0;
+	_is_coalescing = (enable == 1);
+	for(unsigned int q=0; q < _queues.size(); q++){
+		receive_queue *queue = _queues[q];
+		queue->ring.assign(RECEIVE_BATCH_SIZE * _receive_slot_size, 0);
+		for(unsigned int i=0; i < RECEIVE_BATCH_SIZE; i++){
+			queue->vectors[i].iov_base = &queue->ring[i * _receive_slot_size];
+			queue->vectors[i].iov_len = _receive_slot_size;
+			queue->headers[i].msg_hdr.msg_iov = &queue->vectors[i];
+			queue->headers[i].msg_hdr.msg_iovlen = 1;
+			queue->headers[i].msg_hdr.msg_control = &queue->controls[i * RECEIVE_CONTROL_SIZE];
+			queue->headers[i].msg_hdr.msg_controllen = RECEIVE_CONTROL_SIZE;
+			queue->headers[i].msg_hdr.msg_name = &queue->sources[i];
+			queue->headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+		}
+
+		if(setsockopt(queue->receiver->get_socket(), SOL_UDP, UDP_GRO, &enable, sizeof(enable)) != 0){
+			_is_coalescing = false;
+		}
+	}
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+size_t networking_client::get_receive_buffer_size(){
+	return _receive_slot_size;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool networking_client::is_coalescing(){
+	return _is_coalescing;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_client::get_queue_number(){
+	return _queues.size();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::receive_message(int queue){
+	if(queue < 0 || (unsigned int)queue >= _queues.size()){
+		return;
+	}
+
+	receive_queue *current = _queues[queue];
+	while(true){
+		int received = current->receiver->recv_batch(current->headers.data(), RECEIVE_BATCH_SIZE);
+		if(received <= 0){
+			continue;
+		}
+		publish_batch(current, received);
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
-void networking_client::receive_message(){
+int networking_client::receive_pending(int queue){
+	if(queue < 0 || (unsigned int)queue >= _queues.size()){
+		return 0;
+	}
+
+	receive_queue *current = _queues[queue];
+	int total = 0;
 	while(true){
-		char *temp_msg = (char*)malloc(BUFFER_SIZE);
-		_receiver->recv(temp_msg, BUFFER_SIZE);
-		_msg = temp_msg;
-		free(temp_msg);
-		temp_msg = NULL;
+		int received = current->receiver->recv_batch(current->headers.data(), RECEIVE_BATCH_SIZE, MSG_DONTWAIT);
+		if(received <= 0){
+			return total;
+		}
+		publish_batch(current, received);
+		total += received;
 	}
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::publish_batch(receive_queue *queue, int received){
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	int64_t receive_time = (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+
+	if(_is_aggregating){
+		_aggregator.begin_batch(queue->index);
+	}
+
+	for(int i=0; i < received; i++){
+		struct msghdr *header = &queue->headers[i].msg_hdr;
+		const char *data = (const char*)header->msg_iov->iov_base;
+		size_t size = queue->headers[i].msg_len;
+		int64_t arrival = datagram_arrival(header, receive_time);
+		uint64_t source = datagram_source(header);
+
+		// With segmentation offload the kernel coalesces datagrams of the same size into one buffer.
+		size_t segment_size = datagram_segment_size(header);
+		if(segment_size == 0 || segment_size >= size){
+			deliver_datagram(queue, data, size, arrival, source);
+		}
+		else{
+			for(size_t offset=0; offset < size; offset += segment_size){
+				deliver_datagram(queue, data + offset, std::min(segment_size, size - offset), arrival, source);
+			}
+		}
+
+		// The kernel shrinks the control and address lengths to what it filled in.
+		header->msg_controllen = RECEIVE_CONTROL_SIZE;
+		header->msg_namelen = sizeof(struct sockaddr_storage);
+	}
+
+	if(_is_aggregating){
+		_aggregator.end_batch(queue->index);
+	}
+	if(queue->pending_data != nullptr){
+		queue->exchange->publish(queue->pending_data, queue->pending_size, queue->pending_arrival);
+		queue->pending_data = nullptr;
+	}
+
+	if(_input_signal != nullptr){
+		_input_signal->notify();
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::deliver_datagram(receive_queue *queue, const char *data, size_t size, int64_t arrival,
+										 uint64_t source){
+	bool is_reassembled = false;
+	if(is_frame(data, size)){
+		if(!queue->assembler.add(data, size, source)){
+			return;
+		}
+		data = queue->assembler.get_message().data();
+		size = queue->assembler.get_message().size();
+		is_reassembled = true;
+	}
+
+	if(_is_aggregating || _relay != nullptr){
+		extract_channels(queue, data, size, arrival);
+	}
+
+	// A delta only contains the changed channels, so none may be overwritten. From the first delta on, the
+	// queue publishes every message in order to its delta exchange, after the messages published so far.
+	if(queue->delta_exchange != nullptr && (queue->is_delta_stream || is_delta_datagram(data, size))){
+		if(!queue->is_delta_stream && queue->pending_data != nullptr){
+			queue->exchange->publish(queue->pending_data, queue->pending_size, queue->pending_arrival);
+			queue->pending_data = nullptr;
+		}
+		queue->is_delta_stream = true;
+		queue->delta_exchange->publish(data, size, arrival);
+		return;
+	}
+
+	// With EXCHANGE_LATEST only the newest message of a batch is published, as older ones would be overwritten
+	// anyway. Reassembled messages are published at once, because the next frame reuses their buffer.
+	if(queue->exchange->get_policy() == EXCHANGE_QUEUE || is_reassembled){
+		queue->exchange->publish(data, size, arrival);
+		queue->pending_data = nullptr;
+		return;
+	}
+	queue->pending_data = data;
+	queue->pending_size = size;
+	queue->pending_arrival = arrival;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::set_input_signal(input_signal *signal){
+	_input_signal = signal;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+input_signal* networking_client::get_input_signal(){
+	return _input_signal;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::set_relay(relay_table *relay){
+	_relay = relay;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::watch_local(int timeout_ms){
+	if(_local_ring == nullptr){
+		return;
+	}
+
+	if(_local_ring->wait_beyond(&_watched_head, timeout_ms) && _input_signal != nullptr){
+		_input_signal->notify();
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_client::get_socket(int queue){
+	if(queue < 0 || (unsigned int)queue >= _queues.size()){
+		return -1;
+	}
+	return _queues[queue]->receiver->get_socket();
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 void networking_client::store_message(){
-	if(_is_json){
-		try{
-			_hashtable = nlohmann::json::parse(_msg);
+	if(_local_ring != nullptr){
+		store_local_messages();
+		return;
+	}
+
+	apply_queued_messages();
+	if(_is_aggregating){
+		_aggregator.collect(_slot_values, _slot_arrivals);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool networking_client::apply_queued_messages(){
+	// Only messages published before this point are applied, the rest is left for the next tick.
+	// The delta exchanges are counted first. A message published to a main exchange before a counted
+	// delta is then counted as well, so a stale message is never applied after a newer delta.
+	for(unsigned int q=_exchanges.size(); q > 0; q--){
+		_queue_published[q - 1] = _exchanges[q - 1]->get_published();
+		_queue_messages[q - 1] = _exchanges[q - 1]->consume(_queue_published[q - 1]);
+	}
+
+	bool is_applied = false;
+	while(true){
+		int next = -1;
+		for(unsigned int q=0; q < _exchanges.size(); q++){
+			if(_queue_messages[q] != nullptr &&
+			   (next == -1 || _queue_messages[q]->arrival < _queue_messages[next]->arrival)){
+				next = q;
+			}
 		}
-		catch(...){
-			// std::cout << "[ERROR] Could not parse message to json hashtable." << std::endl;
+		if(next == -1){
+			return is_applied;
+		}
+
+		if(!is_applied){
+			_is_snapshot_cleared = false;
+			is_applied = true;
+		}
+		apply_message(*_queue_messages[next]);
+		// EXCHANGE_LATEST only hands over one message per call
+		if(_exchanges[next]->get_policy() == EXCHANGE_QUEUE){
+			_queue_messages[next] = _exchanges[next]->consume(_queue_published[next]);
+		}
+		else{
+			_queue_messages[next] = nullptr;
 		}
 	}
+}
 
-	_stored_message = _msg;
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::store_local_messages(){
+	if(_is_aggregating){
+		_aggregator.begin_batch();
+		while(_local_ring->read(_local_message.data, &_local_message.arrival, false)){
+			extract_channels(_local_queue, _local_message.data.data(), _local_message.data.size(),
+							  _local_message.arrival);
+			apply_message(_local_message);
+		}
+		_aggregator.end_batch();
+		_aggregator.collect(_slot_values, _slot_arrivals);
+		return;
+	}
+
+	bool is_newest = (_policy != EXCHANGE_QUEUE && !_is_delta_stream);
+	if(!_local_ring->read(_local_message.data, &_local_message.arrival, is_newest)){
+		return;
+	}
+
+	_is_snapshot_cleared = false;
+	do{
+		apply_message(_local_message);
+	} while(!is_newest && _local_ring->read(_local_message.data, &_local_message.arrival, false));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::extract_channels(receive_queue *queue, const char *data, size_t size, int64_t arrival){
+	queue->relayed_slots.clear();
+	queue->relayed_values.clear();
+	if(is_binary_message(data, size)){
+		binary_header header;
+		if(decode_binary_message(data, size, &header, queue->binary_values, &queue->binary_contained) != 0){
+			return;
+		}
+		for(unsigned int slot=0; slot < _slot_formats.size(); slot++){
+			unsigned int channel_index = _slot_indices[slot];
+			if(_slot_formats[slot] != FORMAT_JSON && channel_index < queue->binary_contained.size() &&
+			   queue->binary_contained[channel_index]){
+				if(_is_aggregating){
+					_aggregator.add_sample(slot, queue->binary_values[channel_index], arrival, queue->index);
+				}
+				if(_relay != nullptr){
+					queue->relayed_slots.push_back(slot);
+					queue->relayed_values.push_back(queue->binary_values[channel_index]);
+				}
+			}
+		}
+	}
+	else if(_is_json){
+		queue->scanner.scan(data, size);
+		for(int key=0; key < queue->scanner.get_key_number(); key++){
+			if(!queue->scanner.is_contained(key)){
+				continue;
+			}
+			const float *values = queue->scanner.get_values(key);
+			for(unsigned int i=0; i < _scanner_slots[key].size(); i++){
+				int slot = _scanner_slots[key][i];
+				int length = std::min(queue->scanner.get_length(key), _slot_widths[slot]);
+				for(int element=0; element < length; element++){
+					if(_is_aggregating){
+						_aggregator.add_sample(slot + element, values[element], arrival, queue->index);
+					}
+					if(_relay != nullptr){
+						queue->relayed_slots.push_back(slot + element);
+						queue->relayed_values.push_back(values[element]);
+					}
+				}
+			}
+		}
+	}
+
+	if(!queue->relayed_slots.empty()){
+		_relay->forward_received(this, queue->relayed_slots.data(), queue->relayed_values.data(),
+								 queue->relayed_slots.size(), arrival);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::apply_message(const exchange_message &message){
+	_stored_message.assign(message.data);
+	_stored_arrival = message.arrival;
+
+	if(is_binary_message(_stored_message.data(), _stored_message.size())){
+		binary_header header;
+		header.is_delta = false;
+		_hashtable.clear();
+		_is_hashtable_parsed = true;
+		if(decode_binary_message(_stored_message.data(), _stored_message.size(), &header,
+								 _binary_values, &_binary_contained) != 0){
+			std::fill(_binary_values.begin(), _binary_values.end(), 0.0f);
+			std::fill(_binary_contained.begin(), _binary_contained.end(), false);
+		}
+		if(!_is_aggregating){
+			if(header.is_delta){
+				restore_tick_slots();
+			}
+			else{
+				clear_slots();
+			}
+			update_slots(true);
+		}
+		return;
+	}
+
+	std::fill(_binary_values.begin(), _binary_values.end(), 0.0f);
+
+	if(!_is_json){
+		clear_slots();
+		return;
+	}
+
+	_is_hashtable_parsed = false;
+	if(!_is_aggregating){
+		_scanner.scan(_stored_message.data(), _stored_message.size());
+		if(!_scanner.is_contained(_delta_key) || _scanner.get_value(_delta_key) == 0.0f){
+			clear_slots();
+		}
+		else{
+			restore_tick_slots();
+		}
+		update_slots(false);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::clear_slots(){
+	if(_is_snapshot_cleared){
+		return;
+	}
+
+	std::fill(_slot_values.begin(), _slot_values.end(), 0.0f);
+	std::fill(_slot_arrivals.begin(), _slot_arrivals.end(), 0);
+	_is_snapshot_cleared = true;
+	_is_tick_cleared = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::restore_tick_slots(){
+	_is_delta_stream = true;
+	if(!_is_tick_cleared){
+		return;
+	}
+
+	// The first delta builds on the channels of the message before, which clear_message() set to 0
+	_slot_values = _tick_values;
+	_slot_arrivals = _tick_arrivals;
+	_is_tick_cleared = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::parse_hashtable(){
+	if(_is_hashtable_parsed){
+		return;
+	}
+
+	_is_hashtable_parsed = true;
+	try{
+		_hashtable = nlohmann::json::parse(_stored_message);
+	}
+	catch(...){
+		// std::cout << "[ERROR] Could not parse message to json hashtable." << std::endl;
+		_hashtable.clear();
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_client::update_slots(bool is_binary){
+	if(!is_binary){
+		for(int key=0; key < _scanner.get_key_number(); key++){
+			if(!_scanner.is_contained(key)){
+				continue;
+			}
+			// The elements of a vector channel are consecutive slots, so they are copied at once
+			const float *values = _scanner.get_values(key);
+			for(unsigned int i=0; i < _scanner_slots[key].size(); i++){
+				int slot = _scanner_slots[key][i];
+				int length = std::min(_scanner.get_length(key), _slot_widths[slot]);
+				std::copy(values, values + length, _slot_values.begin() + slot);
+				std::fill(_slot_arrivals.begin() + slot, _slot_arrivals.begin() + slot + length, _stored_arrival);
+			}
+		}
+		return;
+	}
+
+	for(unsigned int slot=0; slot < _slot_values.size(); slot++){
+		if(_slot_formats[slot] != FORMAT_JSON){
+			unsigned int channel_index = _slot_indices[slot];
+			if(channel_index < _binary_contained.size() && _binary_contained[channel_index]){
+				_slot_values[slot] = _binary_values[channel_index];
+				_slot_arrivals[slot] = _stored_arrival;
+			}
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_client::register_channel(std::string key, int format, int channel_index, int aggregation, int width){
+	bool is_json = (format == FORMAT_JSON);
+	if(width < 1){
+		width = 1;
+	}
+	for(unsigned int slot=0; slot < _slot_keys.size(); slot++){
+		bool slot_is_json = (_slot_formats[slot] == FORMAT_JSON);
+		if(is_json == slot_is_json && _slot_aggregations[slot] == aggregation && _slot_widths[slot] == width &&
+		   ((is_json && _slot_keys[slot] == key) || (!is_json && _slot_indices[slot] == channel_index))){
+			return slot;
+		}
+	}
+
+	// A vector channel takes one slot per element. Only the first one carries the width, the others 0.
+	int first_slot = _slot_values.size();
+	for(int element=0; element < width; element++){
+		_slot_keys.push_back(element == 0 ? key : key + "[" + std::to_string(element) + "]");
+		_slot_formats.push_back(format);
+		_slot_indices.push_back(channel_index + element);
+		_slot_widths.push_back(element == 0 ? width : 0);
+		_slot_values.push_back(0.0f);
+		_slot_arrivals.push_back(0);
+		_slot_aggregations.push_back(aggregation);
+		_aggregator.add_channel(aggregation);
+	}
+	if(aggregation != AGGREGATE_LAST){
+		_is_aggregating = true;
+	}
+	if(is_json){
+		unsigned int key_index = _scanner.add_key(key, width);
+		for(unsigned int q=0; q < _queues.size(); q++){
+			_queues[q]->scanner.add_key(key, width);
+		}
+		if(_local_queue != nullptr){
+			_local_queue->scanner.add_key(key, width);
+		}
+		if(key_index >= _scanner_slots.size()){
+			_scanner_slots.resize(key_index + 1);
+		}
+		_scanner_slots[key_index].push_back(first_slot);
+	}
+	return first_slot;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+float networking_client::get_slot_value(int slot){
+	return _slot_values[slot];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int64_t networking_client::get_slot_arrival(int slot){
+	return _slot_arrivals[slot];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const float* networking_client::get_slot_values(int slot){
+	return &_slot_values[slot];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const int64_t* networking_client::get_slot_arrivals(int slot){
+	return &_slot_arrivals[slot];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool networking_client::get_sequence(int64_t *sequence){
+	if(_stored_message.empty()){
+		return false;
+	}
+	if(is_binary_message(_stored_message.data(), _stored_message.size())){
+		*sequence = get_binary_sequence(_stored_message.data(), _stored_message.size());
+		return true;
+	}
+
+	// The json scanner reads floats, which cannot hold every sequence number
+	static const char SEQUENCE_KEY[] = "\"sequence\"";
+	size_t position = _stored_message.find(SEQUENCE_KEY);
+	if(position == std::string::npos){
+		return false;
+	}
+	const char *value = _stored_message.c_str() + position + sizeof(SEQUENCE_KEY) - 1;
+	while(*value == ' ' || *value == '\t' || *value == '\r' || *value == '\n'){
+		value++;
+	}
+	if(*value != ':'){
+		return false;
+	}
+	char *end = nullptr;
+	long long number = strtoll(value + 1, &end, 10);
+	if(end == value + 1 || number < 0){
+		return false;
+	}
+	*sequence = number;
+	return true;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
 std::string networking_client::get_message(int indent){
 	if(_is_json && indent > -1){
+		parse_hashtable();
 		try{
 			return _hashtable.dump(indent);
 		}
@@ -86,6 +849,7 @@ std::string networking_client::get_message(int indent){
 //
 nlohmann::json networking_client::get_json_value(std::string key){
 	if(_is_json){
+		parse_hashtable();
 		auto return_value = _hashtable[key];
 		if(return_value.is_null()){
 			return_value = 0;
@@ -96,22 +860,70 @@ nlohmann::json networking_client::get_json_value(std::string key){
 	return 0;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+float networking_client::get_binary_value(int channel_index){
+	if(channel_index >= 0 && (unsigned int)channel_index < _binary_values.size()){
+		return _binary_values[channel_index];
+	}
+
+	return 0.0f;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 nlohmann::json networking_client::get_hashtable(){
 	if(_is_json){
+		parse_hashtable();
 		return _hashtable;
 	}
 
 	return NULL;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long networking_client::get_dropped_messages(){
+	if(_local_ring != nullptr){
+		return _local_ring->get_lost();
+	}
+	unsigned long long dropped = 0;
+	for(unsigned int q=0; q < _exchanges.size(); q++){
+		dropped += _exchanges[q]->get_dropped();
+	}
+	return dropped;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long networking_client::get_incomplete_messages(){
+	unsigned long long incomplete = 0;
+	for(unsigned int q=0; q < _queues.size(); q++){
+		incomplete += _queues[q]->assembler.get_incomplete() + _queues[q]->assembler.get_malformed();
+	}
+	return incomplete;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 void networking_client::clear_message(){
 	_hashtable.clear();
-	_stored_message = "";
-	_msg = "";
+	_is_hashtable_parsed = true;
+	std::fill(_binary_values.begin(), _binary_values.end(), 0.0f);
+	std::fill(_binary_contained.begin(), _binary_contained.end(), false);
+	_stored_message.clear();
+	if(_is_delta_stream){
+		return;
+	}
+
+	// Until the first delta arrives, it is unknown whether the sender sends deltas
+	if(!_is_tick_cleared){
+		_tick_values = _slot_values;
+		_tick_arrivals = _slot_arrivals;
+		_is_tick_cleared = true;
+	}
+	std::fill(_slot_values.begin(), _slot_values.end(), 0.0f);
+	std::fill(_slot_arrivals.begin(), _slot_arrivals.end(), 0);
 }
 
 } //namespace utils
@@ -9,8 +9,16 @@
  */
 
 #include "networking_sender.hpp"
+#include "binary_protocol.hpp"
+#include "frame_protocol.hpp"
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <stdexcept>
 
 #ifndef BUFFER_SIZE
 #define BUFFER_SIZE 1024
@@ -18,28 +26,181 @@
 
 namespace utils{
 
+const int JSON_FIELD_CHANNEL = 0;
+const int JSON_FIELD_TIME = 1;
+const int JSON_FIELD_SEQUENCE = 2;
+const int JSON_FIELD_DELTA = 3;
+const int JSON_FIELD_REPLY = 4;
+
+// Frame message ids are unique within the process, so senders sharing a source address never reuse one,
+// e.g. an output node and its immediate relay sending through the same unix socket
+static std::atomic<uint32_t> frame_message_ids(0);
+
+/**
+ * @brief Appends an integer like the json library writes it.
+ */
+static void append_integer(std::string &out, long long value){
+	char digits[24];
+	int length = 0;
+	unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+	do{
+		digits[length++] = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	} while(magnitude > 0);
+	if(value < 0){
+		out.push_back('-');
+	}
+	while(length > 0){
+		out.push_back(digits[--length]);
+	}
+}
+
+/**
+ * @brief Appends a float like the json library writes it, which stores it as double.
+ */
+static void append_float(std::string &out, float value){
+	double number = value;
+	if(!std::isfinite(number)){
+		out.append("null", 4);
+		return;
+	}
+	char digits[64];
+	char *end = nlohmann::detail::to_chars(digits, digits + sizeof(digits), number);
+	out.append(digits, end - digits);
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 networking_sender::networking_sender(std::string ip, int port){
 	_sender = new udp_client_server::udp_client(ip, port);
+	try{
+		_destinations.push_back(new udp_client_server::udp_address(ip, port));
+	}
+	catch(...){
+		delete _sender;
+		throw;
+	}
+	warn_multicast(*_destinations[0]);
+	_local_ring = nullptr;
+	_format = FORMAT_JSON;
+	_sequence = 0;
+	_reply_sequence = -1;
+	_is_delta = false;
+	_is_partial = false;
+	_delta_epsilon = 0.0f;
+	_keyframe_interval = 1;
+	_ticks_since_keyframe = 0;
+	_is_keyframe = true;
+	_has_changes = false;
+	_max_datagram_size = UDP_MAX_PAYLOAD;
+	_json_field_slots = 0;
+	_is_json_templated = false;
+}
+
+networking_sender::networking_sender(std::string shm_name){
+	_sender = nullptr;
+	_local_ring = new shm_ring();
+	_format = FORMAT_JSON;
+	_sequence = 0;
+	_reply_sequence = -1;
+	_is_delta = false;
+	_is_partial = false;
+	_delta_epsilon = 0.0f;
+	_keyframe_interval = 1;
+	_ticks_since_keyframe = 0;
+	_is_keyframe = true;
+	_has_changes = false;
+	_max_datagram_size = UDP_MAX_PAYLOAD;
+	_json_field_slots = 0;
+	_is_json_templated = false;
+	if(_local_ring->open(shm_name) != 0){
+		delete _local_ring;
+		throw std::runtime_error("could not attach to shared memory ring " + shm_name);
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
 networking_sender::~networking_sender(){
+	for(unsigned int i=0; i < _destinations.size(); i++){
+		delete _destinations[i];
+	}
 	delete _sender;
+	delete _local_ring;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
-std::string networking_sender::get_ip(){
-	return _sender->get_addr();
+std::string networking_sender::get_ip(int destination){
+	if(_local_ring != nullptr){
+		return "shm:" + _local_ring->get_name();
+	}
+	return _destinations[destination]->get_addr();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 //
-int networking_sender::get_port(){
-	return _sender->get_port();
+int networking_sender::get_port(int destination){
+	if(_local_ring != nullptr){
+		return 0;
+	}
+	return _destinations[destination]->get_port();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_sender::add_destination(std::string ip, int port){
+	if(_local_ring != nullptr){
+		std::cout << "[ERROR] A shared memory ring cannot have further destinations." << std::endl;
+		return -1;
+	}
+	for(unsigned int i=0; i < _destinations.size(); i++){
+		if(_destinations[i]->get_addr() == ip && _destinations[i]->get_port() == port){
+			return 0;
+		}
+	}
+
+	udp_client_server::udp_address *destination = nullptr;
+	try{
+		destination = new udp_client_server::udp_address(ip, port);
+	}
+	catch(...){
+		std::cout << "[ERROR] Invalid destination " << ip << ":" << port << "." << std::endl;
+		return -1;
+	}
+	// The batch_sender sends all datagrams of a sender through the socket of one address family
+	if(destination->get_addrinfo()->ai_family != _sender->get_addrinfo()->ai_family){
+		std::cout << "[ERROR] Destination " << ip << ":" << port << " uses another address family than "
+				  << get_ip() << ":" << get_port() << "." << std::endl;
+		delete destination;
+		return -1;
+	}
+
+	warn_multicast(*destination);
+	_destinations.push_back(destination);
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::warn_multicast(const udp_client_server::udp_address &destination){
+	if(destination.is_multicast()){
+		std::cout << "[WARNING] Multicast destination " << destination.get_addr() << ":" << destination.get_port()
+				  << " is sent with a TTL of 1 through the default interface, so it is only reached within the local network."
+				  << std::endl;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_sender::get_destination_number(){
+	return _destinations.size();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool networking_sender::is_local(){
+	return _local_ring != nullptr;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -67,6 +228,336 @@ void networking_sender::add_data(std::string key, std::string value){
 	_payload[key] = value;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::add_binary_data(int channel_index, float value){
+	if(channel_index < 0 || (unsigned int)channel_index >= BINARY_MAX_CHANNELS){
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(_payload_mutex);
+	if((unsigned int)channel_index >= _binary_values.size()){
+		_binary_values.resize(channel_index + 1, 0.0f);
+		_binary_is_set.resize(channel_index + 1, false);
+	}
+	_binary_values[channel_index] += value;
+	_binary_is_set[channel_index] = true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_sender::register_channel(std::string key, int channel_index){
+	for(unsigned int slot=0; slot < _slot_keys.size(); slot++){
+		if(_slot_keys[slot] == key && _slot_indices[slot] == channel_index){
+			return slot;
+		}
+	}
+
+	_slot_keys.push_back(key);
+	_slot_indices.push_back(channel_index);
+	_slot_values.push_back(0.0f);
+	_slot_is_set.push_back(false);
+	_slot_arrivals.push_back(0);
+	_slot_latencies.push_back(latency_histogram());
+	_slot_sent_values.push_back(0.0f);
+	_slot_was_sent.push_back(false);
+	return _slot_values.size() - 1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::add_slot_data(int slot, float value, int64_t arrival){
+	std::lock_guard<std::mutex> guard(_payload_mutex);
+	_slot_values[slot] += value;
+	_slot_is_set[slot] = true;
+	if(arrival > _slot_arrivals[slot]){
+		_slot_arrivals[slot] = arrival;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_sender::register_writer(int slot){
+	writer_buffer writer;
+	memset(&writer, 0, sizeof(writer));
+	writer.slot = slot;
+	_writers.push_back(writer);
+	return _writers.size() - 1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::add_writer_data(int writer, float value, int64_t arrival){
+	writer_buffer &buffer = _writers[writer];
+	buffer.value += value;
+	buffer.is_set = true;
+	if(arrival > buffer.arrival){
+		buffer.arrival = arrival;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::merge_writers(){
+	for(unsigned int i=0; i < _writers.size(); i++){
+		writer_buffer &buffer = _writers[i];
+		if(!buffer.is_set){
+			continue;
+		}
+
+		_slot_values[buffer.slot] += buffer.value;
+		_slot_is_set[buffer.slot] = true;
+		if(buffer.arrival > _slot_arrivals[buffer.slot]){
+			_slot_arrivals[buffer.slot] = buffer.arrival;
+		}
+		buffer.value = 0.0f;
+		buffer.is_set = false;
+		buffer.arrival = 0;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_sender::get_channel_number(){
+	return _slot_keys.size();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+std::string networking_sender::get_channel_key(int slot){
+	return _slot_keys[slot];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_sender::get_channel_index(int slot){
+	return _slot_indices[slot];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const latency_histogram& networking_sender::get_channel_latency(int slot){
+	return _slot_latencies[slot];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::flush_slots(int64_t time_in_ns){
+	merge_writers();
+	_is_keyframe = (_ticks_since_keyframe == 0);
+	_ticks_since_keyframe = (_ticks_since_keyframe + 1) % _keyframe_interval;
+	_has_changes = false;
+
+	for(unsigned int slot=0; slot < _slot_values.size(); slot++){
+		if(_is_delta){
+			// A keyframe repeats the last sent value of channels without new data
+			if(!_slot_is_set[slot] && _is_keyframe && _slot_was_sent[slot]){
+				_slot_values[slot] = _slot_sent_values[slot];
+				_slot_is_set[slot] = true;
+			}
+			if(_slot_is_set[slot] && !_is_keyframe && _slot_was_sent[slot] &&
+			   std::fabs(_slot_values[slot] - _slot_sent_values[slot]) <= _delta_epsilon){
+				_slot_values[slot] = 0.0f;
+				_slot_is_set[slot] = false;
+				_slot_arrivals[slot] = 0;
+			}
+			if(_slot_is_set[slot]){
+				_slot_sent_values[slot] = _slot_values[slot];
+				_slot_was_sent[slot] = true;
+			}
+		}
+		if(!_slot_is_set[slot]){
+			continue;
+		}
+
+		_has_changes = true;
+		if(_slot_arrivals[slot] > 0){
+			_slot_latencies[slot].record(time_in_ns - _slot_arrivals[slot]);
+			_slot_arrivals[slot] = 0;
+		}
+
+		// Json channels stay in their slots until the payload is written
+		if(_format != FORMAT_JSON){
+			add_binary_data(_slot_indices[slot], _slot_values[slot]);
+			_slot_values[slot] = 0.0f;
+			_slot_is_set[slot] = false;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::build_json_fields(){
+	// Sorted like the keys of a json object, so that the payload does not change
+	std::map<std::string, json_field> fields;
+	_is_json_templated = true;
+	for(unsigned int slot=0; slot < _slot_keys.size(); slot++){
+		const std::string &key = _slot_keys[slot];
+		if(key == "time" || key == "sequence" || key == "delta" || key == "reply"){
+			_is_json_templated = false;
+		}
+		fields[key].kind = JSON_FIELD_CHANNEL;
+		fields[key].slots.push_back(slot);
+	}
+	fields["time"].kind = JSON_FIELD_TIME;
+	fields["sequence"].kind = JSON_FIELD_SEQUENCE;
+	fields["delta"].kind = JSON_FIELD_DELTA;
+	fields["reply"].kind = JSON_FIELD_REPLY;
+
+	_json_fields.clear();
+	for(std::map<std::string, json_field>::iterator it = fields.begin(); it != fields.end(); it++){
+		it->second.prefix = nlohmann::json(it->first).dump() + ":";
+		_json_fields.push_back(it->second);
+	}
+	_json_field_slots = _slot_keys.size();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::write_json_payload(int64_t time_in_ms){
+	_send_buffer.clear();
+	_send_buffer.push_back('{');
+	bool is_first = true;
+	for(unsigned int i=0; i < _json_fields.size(); i++){
+		const json_field &field = _json_fields[i];
+		if((field.kind == JSON_FIELD_SEQUENCE && !_is_delta && !_is_partial) ||
+		   (field.kind == JSON_FIELD_DELTA && !_is_partial && (!_is_delta || _is_keyframe)) ||
+		   (field.kind == JSON_FIELD_REPLY && _reply_sequence < 0)){
+			continue;
+		}
+
+		float value = 0.0f;
+		bool is_set = false;
+		if(field.kind == JSON_FIELD_CHANNEL){
+			for(unsigned int j=0; j < field.slots.size(); j++){
+				int slot = field.slots[j];
+				if(_slot_is_set[slot]){
+					value = is_set ? value + _slot_values[slot] : _slot_values[slot];
+					is_set = true;
+				}
+			}
+			if(!is_set){
+				continue;
+			}
+		}
+
+		if(!is_first){
+			_send_buffer.push_back(',');
+		}
+		is_first = false;
+		_send_buffer.append(field.prefix);
+		switch(field.kind){
+			case JSON_FIELD_CHANNEL:
+				append_float(_send_buffer, value);
+				break;
+			case JSON_FIELD_TIME:
+				append_integer(_send_buffer, (long long)time_in_ms);
+				break;
+			case JSON_FIELD_SEQUENCE:
+				append_integer(_send_buffer, (long long)_sequence);
+				break;
+			case JSON_FIELD_REPLY:
+				append_integer(_send_buffer, (long long)_reply_sequence);
+				break;
+			default:
+				_send_buffer.append("true", 4);
+				break;
+		}
+	}
+	_send_buffer.push_back('}');
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::set_format(int format){
+	_format = format;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_sender::get_format(){
+	return _format;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::set_delta_mode(float epsilon, int keyframe_interval){
+	_is_delta = true;
+	_delta_epsilon = epsilon > 0.0f ? epsilon : 0.0f;
+	_keyframe_interval = keyframe_interval > 0 ? keyframe_interval : 1;
+	_ticks_since_keyframe = 0;
+	_is_keyframe = true;
+	_has_changes = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::set_reply_sequence(int64_t sequence){
+	_reply_sequence = sequence >= 0 ? sequence : -1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::set_partial(bool is_partial){
+	_is_partial = is_partial;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool networking_sender::is_partial(){
+	return _is_partial;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool networking_sender::is_delta(){
+	return _is_delta;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+float networking_sender::get_delta_epsilon(){
+	return _delta_epsilon;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_sender::get_keyframe_interval(){
+	return _keyframe_interval;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int networking_sender::set_max_datagram_size(size_t size){
+	if(size == 0){
+		size = UDP_MAX_PAYLOAD;
+	}
+	if(size <= FRAME_HEADER_SIZE || size > UDP_MAX_PAYLOAD){
+		std::cout << "[ERROR] Maximum datagram size must be between " << FRAME_HEADER_SIZE + 1 << " and "
+				  << UDP_MAX_PAYLOAD << " bytes." << std::endl;
+		return -1;
+	}
+	_max_datagram_size = size;
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+size_t networking_sender::get_max_datagram_size(){
+	return _max_datagram_size;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const std::string& networking_sender::frame_payload(const std::string &payload, int *frame_number){
+	*frame_number = encode_frames(_frame_buffer, frame_message_ids++, payload.data(), payload.size(), _max_datagram_size);
+	if(*frame_number < 0){
+		*frame_number = 0;
+		_frame_buffer.clear();
+	}
+	return _frame_buffer;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //
 void networking_sender::remove_data(std::string key){
@@ -77,6 +568,16 @@ void networking_sender::remove_data(std::string key){
 //
 void networking_sender::clear_payload(){
 	_payload.clear();
+	std::fill(_binary_values.begin(), _binary_values.end(), 0.0f);
+	std::fill(_binary_is_set.begin(), _binary_is_set.end(), false);
+	std::fill(_slot_values.begin(), _slot_values.end(), 0.0f);
+	std::fill(_slot_is_set.begin(), _slot_is_set.end(), false);
+	std::fill(_slot_arrivals.begin(), _slot_arrivals.end(), 0);
+	for(unsigned int i=0; i < _writers.size(); i++){
+		_writers[i].value = 0.0f;
+		_writers[i].is_set = false;
+		_writers[i].arrival = 0;
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -87,12 +588,118 @@ std::string networking_sender::stringify_payload(int indent){
 
 //----------------------------------------------------------------------------------------------------------------------
 //
-void networking_sender::send_payload(){
-	auto time_in_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-	_payload["time"] = (long long)time_in_ms;
-	std::string stringified_payload = _payload.dump();
-	_sender->send(stringified_payload.c_str(), stringified_payload.size());
+const std::string& networking_sender::serialize_payload(int64_t time_in_ns){
+	int64_t time_in_ms = time_in_ns / 1000000;
+	flush_slots(time_in_ns);
+	bool is_partial_payload = _is_partial || (_is_delta && !_is_keyframe);
+
+	if(is_partial_payload && !_has_changes && _payload.empty()){
+		clear_payload();
+		_send_buffer.clear();
+		return _send_buffer;
+	}
+
+	if(_format == FORMAT_BINARY_PAIRS){
+		encode_binary_pairs(_send_buffer, _sequence, time_in_ms, _binary_values, _binary_is_set,
+							is_partial_payload);
+		_sequence++;
+	}
+	else if(_format == FORMAT_BINARY_DENSE){
+		encode_binary_dense(_send_buffer, _sequence, time_in_ms, _binary_values);
+		_sequence++;
+	}
+	else{
+		if(_json_fields.empty() || _json_field_slots != _slot_keys.size()){
+			build_json_fields();
+		}
+
+		if(_is_json_templated && _payload.empty()){
+			write_json_payload(time_in_ms);
+		}
+		else{
+			// Data added by key is only known at runtime, so the whole object is serialized
+			for(unsigned int slot=0; slot < _slot_keys.size(); slot++){
+				if(_slot_is_set[slot]){
+					add_data(_slot_keys[slot], _slot_values[slot]);
+				}
+			}
+			_payload["time"] = (long long)time_in_ms;
+			if(_reply_sequence >= 0){
+				_payload["reply"] = (long long)_reply_sequence;
+			}
+			if(_is_delta || _is_partial){
+				_payload["sequence"] = _sequence;
+				if(is_partial_payload){
+					_payload["delta"] = true;
+				}
+			}
+			_send_buffer = _payload.dump();
+		}
+		if(_is_delta || _is_partial){
+			_sequence++;
+		}
+	}
+
 	clear_payload();
+	return _send_buffer;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+const struct addrinfo* networking_sender::get_addrinfo(int destination){
+	if(_local_ring != nullptr){
+		return nullptr;
+	}
+	return _destinations[destination]->get_addrinfo();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void networking_sender::send_payload(){
+	auto time_in_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	send_payload((int64_t)time_in_ns);
+}
+
+bool networking_sender::send_payload(int64_t time_in_ns){
+	const std::string &datagram = serialize_payload(time_in_ns);
+	if(datagram.empty()){
+		return false;
+	}
+	if(_local_ring != nullptr){
+		return _local_ring->write(datagram.data(), datagram.size(), time_in_ns);
+	}
+	if(datagram.size() <= _max_datagram_size){
+		bool is_sent = true;
+		for(unsigned int d=0; d < _destinations.size(); d++){
+			is_sent = (_sender->send(datagram.data(), datagram.size(), *_destinations[d]) >= 0) && is_sent;
+		}
+		return is_sent;
+	}
+
+	int frame_number = 0;
+	const std::string &frames = frame_payload(datagram, &frame_number);
+	bool is_sent = frame_number > 0;
+	for(unsigned int d=0; d < _destinations.size(); d++){
+		// A destination missing a frame cannot assemble the message, but the other destinations still can
+		for(int i=0; i < frame_number; i++){
+			size_t offset = i * _max_datagram_size;
+			size_t length = std::min(_max_datagram_size, frames.size() - offset);
+			if(_sender->send(frames.data() + offset, length, *_destinations[d]) < 0){
+				is_sent = false;
+				break;
+			}
+		}
+	}
+	return is_sent;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long networking_sender::get_dropped_payloads(){
+	if(_local_ring != nullptr){
+		return _local_ring->get_dropped();
+	}
+	return 0;
 }
 
 } //namespace utils
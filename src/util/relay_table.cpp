@@ -0,0 +1,184 @@
+/**
+ * @file relay_table.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of relay_table class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "relay_table.hpp"
+#include "binary_protocol.hpp"
+#include <iostream>
+#include <algorithm>
+
+namespace utils{
+
+int parse_relay_mode(const std::string &name){
+	if(name == "tick"){
+		return RELAY_TICK;
+	}
+	else if(name == "immediate"){
+		return RELAY_IMMEDIATE;
+	}
+	return -1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+relay_table::relay_table(bool is_tracing_latency){
+	_is_tracing_latency = is_tracing_latency;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+relay_table::~relay_table(){
+	for(unsigned int i=0; i < _relays.size(); i++){
+		delete _relays[i]->sender;
+		delete _relays[i];
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int relay_table::add_route(networking_client *client, int client_slot, networking_sender *sender, int sender_slot,
+						   int mode){
+	for(unsigned int i=0; i < _routes.size(); i++){
+		if(_routes[i].client == client && _routes[i].client_slot == client_slot &&
+		   _routes[i].sender == sender && _routes[i].sender_slot == sender_slot){
+			return i;
+		}
+	}
+
+	route current;
+	current.client = client;
+	current.client_slot = client_slot;
+	current.sender = sender;
+	current.sender_slot = sender_slot;
+	current.mode = mode;
+	current.writer = -1;
+	current.relay = -1;
+	current.relay_slot = -1;
+
+	if(mode == RELAY_IMMEDIATE){
+		current.relay = get_relay(sender);
+		if(current.relay < 0){
+			return -1;
+		}
+		current.relay_slot = _relays[current.relay]->sender->register_channel(sender->get_channel_key(sender_slot),
+																			   sender->get_channel_index(sender_slot));
+		immediate_client &immediate = _immediate_routes[client];
+		if((int)immediate.slot_routes.size() <= client_slot){
+			immediate.slot_routes.resize(client_slot + 1);
+		}
+		immediate.slot_routes[client_slot].push_back(_routes.size());
+		if(std::find(immediate.relays.begin(), immediate.relays.end(), current.relay) == immediate.relays.end()){
+			immediate.relays.push_back(current.relay);
+		}
+		client->set_relay(this);
+	}
+	else{
+		current.writer = sender->register_writer(sender_slot);
+	}
+
+	_routes.push_back(current);
+	return _routes.size() - 1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int relay_table::get_relay(networking_sender *output){
+	for(unsigned int i=0; i < _relays.size(); i++){
+		if(_relays[i]->output == output){
+			return i;
+		}
+	}
+
+	if(output->is_local() || output->get_format() == FORMAT_BINARY_DENSE){
+		std::cout << "[ERROR] Cannot relay immediately to " << output->get_ip() << ". "
+				  << "Immediate relays need a udp destination and format json or binary." << std::endl;
+		return -1;
+	}
+
+	networking_sender *sender = new networking_sender(output->get_ip(), output->get_port());
+	for(int destination=1; destination < output->get_destination_number(); destination++){
+		if(sender->add_destination(output->get_ip(destination), output->get_port(destination)) != 0){
+			delete sender;
+			return -1;
+		}
+	}
+	sender->set_format(output->get_format());
+	if(sender->set_max_datagram_size(output->get_max_datagram_size()) != 0){
+		delete sender;
+		return -1;
+	}
+	sender->set_partial(true);
+
+	relay_sender *relay = new relay_sender();
+	relay->output = output;
+	relay->sender = sender;
+	_relays.push_back(relay);
+	return _relays.size() - 1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void relay_table::forward(){
+	for(unsigned int i=0; i < _routes.size(); i++){
+		const route &current = _routes[i];
+		if(current.mode != RELAY_TICK){
+			continue;
+		}
+
+		float value = current.client->get_slot_value(current.client_slot);
+		if(value > 0){
+			int64_t arrival = _is_tracing_latency ? current.client->get_slot_arrival(current.client_slot) : 0;
+			current.sender->add_writer_data(current.writer, value, arrival);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void relay_table::forward_received(networking_client *client, const int *client_slots, const float *values, int number,
+								   int64_t arrival){
+	std::unordered_map<networking_client*, immediate_client>::iterator it = _immediate_routes.find(client);
+	if(it == _immediate_routes.end()){
+		return;
+	}
+	const immediate_client &immediate = it->second;
+
+	// The payload of a relay sender must not mix in values of another message, so it is locked until sent
+	for(unsigned int r=0; r < immediate.relays.size(); r++){
+		relay_sender *relay = _relays[immediate.relays[r]];
+		std::unique_lock<std::mutex> guard(relay->mutex, std::defer_lock);
+		for(int i=0; i < number; i++){
+			if(values[i] <= 0 || (unsigned int)client_slots[i] >= immediate.slot_routes.size()){
+				continue;
+			}
+			const std::vector<int> &routes = immediate.slot_routes[client_slots[i]];
+			for(unsigned int k=0; k < routes.size(); k++){
+				const route &current = _routes[routes[k]];
+				if(current.relay != immediate.relays[r]){
+					continue;
+				}
+				if(!guard.owns_lock()){
+					guard.lock();
+				}
+				relay->sender->add_slot_data(current.relay_slot, values[i], _is_tracing_latency ? arrival : 0);
+			}
+		}
+		if(guard.owns_lock()){
+			relay->sender->send_payload();
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int relay_table::get_route_number(){
+	return _routes.size();
+}
+
+} //namespace utils
@@ -0,0 +1,286 @@
+/**
+ * @file shm_ring.cpp
+ * @author Cyril Marx (https://github.com/cycrus)
+ *
+ * @brief Implementation of shm_ring class.
+ *
+ * @date 2026-10-19
+ *
+ */
+
+#include "shm_ring.hpp"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <climits>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace utils{
+
+const uint32_t SHM_RING_MAGIC = 0x52474e43;		// "CNGR"
+const uint32_t SHM_RING_VERSION = 1;
+const int SHM_RING_ATTACH_TIMEOUT_MS = 1000;
+
+shm_ring::shm_ring(){
+	_memory = nullptr;
+	_memory_size = 0;
+	_header = nullptr;
+	_slots = nullptr;
+	_slot_stride = 0;
+	_next_read = 0;
+	_next_write = 0;
+	_lost = 0;
+	_dropped = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+shm_ring::~shm_ring(){
+	if(_memory != nullptr){
+		munmap(_memory, _memory_size);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+int shm_ring::open(const std::string &name, uint32_t slot_size, uint32_t slot_number){
+	_name = name;
+	bool is_creator = true;
+	int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+	if(fd < 0 && errno == EEXIST){
+		is_creator = false;
+		fd = shm_open(name.c_str(), O_RDWR, 0666);
+	}
+	if(fd < 0){
+		std::cout << "[ERROR] Could not open shared memory " << name << ": " << strerror(errno) << std::endl;
+		return -1;
+	}
+
+	if(is_creator){
+		if(slot_size == 0 || slot_number == 0){
+			std::cout << "[ERROR] Shared memory ring " << name << " needs slots." << std::endl;
+			close(fd);
+			shm_unlink(name.c_str());
+			return -1;
+		}
+		_slot_stride = (sizeof(slot_header) + slot_size + 63) / 64 * 64;
+		_memory_size = sizeof(ring_header) + _slot_stride * slot_number;
+		if(ftruncate(fd, _memory_size) < 0){
+			std::cout << "[ERROR] Could not size shared memory " << name << ": " << strerror(errno) << std::endl;
+			close(fd);
+			shm_unlink(name.c_str());
+			return -1;
+		}
+	}
+	else{
+		// The creator might still be sizing and initializing the ring
+		struct stat status;
+		int waited_ms = 0;
+		while(fstat(fd, &status) == 0 && (size_t)status.st_size < sizeof(ring_header) &&
+			  waited_ms < SHM_RING_ATTACH_TIMEOUT_MS){
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			waited_ms++;
+		}
+		if(fstat(fd, &status) < 0 || (size_t)status.st_size < sizeof(ring_header)){
+			std::cout << "[ERROR] Shared memory " << name << " is not a ring." << std::endl;
+			close(fd);
+			return -1;
+		}
+		_memory_size = status.st_size;
+	}
+
+	_memory = mmap(nullptr, _memory_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if(_memory == MAP_FAILED){
+		std::cout << "[ERROR] Could not map shared memory " << name << ": " << strerror(errno) << std::endl;
+		_memory = nullptr;
+		return -1;
+	}
+	_header = (ring_header*)_memory;
+	_slots = (char*)_memory + sizeof(ring_header);
+
+	if(is_creator){
+		_header->version = SHM_RING_VERSION;
+		_header->slot_size = slot_size;
+		_header->slot_number = slot_number;
+		_header->head.store(0, std::memory_order_relaxed);
+		_header->signal.store(0, std::memory_order_relaxed);
+		_header->waiters.store(0, std::memory_order_relaxed);
+		__atomic_store_n(&_header->magic, SHM_RING_MAGIC, __ATOMIC_RELEASE);
+	}
+	else{
+		int waited_ms = 0;
+		while(__atomic_load_n(&_header->magic, __ATOMIC_ACQUIRE) != SHM_RING_MAGIC &&
+			  waited_ms < SHM_RING_ATTACH_TIMEOUT_MS){
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			waited_ms++;
+		}
+		_slot_stride = (sizeof(slot_header) + _header->slot_size + 63) / 64 * 64;
+		if(__atomic_load_n(&_header->magic, __ATOMIC_ACQUIRE) != SHM_RING_MAGIC ||
+		   _header->version != SHM_RING_VERSION || _header->slot_number == 0 ||
+		   sizeof(ring_header) + _slot_stride * _header->slot_number > _memory_size){
+			std::cout << "[ERROR] Shared memory " << name << " is not a compatible ring." << std::endl;
+			munmap(_memory, _memory_size);
+			_memory = nullptr;
+			_header = nullptr;
+			return -1;
+		}
+	}
+
+	// Readers start with the next message, a writer continues after the last one
+	_next_read = _header->head.load(std::memory_order_acquire);
+	_next_write = _next_read;
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+shm_ring::slot_header* shm_ring::slot(uint64_t index){
+	return (slot_header*)(_slots + (index % _header->slot_number) * _slot_stride);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool shm_ring::write(const char *data, size_t size, int64_t timestamp){
+	if(_header == nullptr || size > _header->slot_size){
+		_dropped++;
+		return false;
+	}
+
+	slot_header *current = slot(_next_write);
+	current->sequence.store(_next_write * 2 + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	current->length = (uint32_t)size;
+	current->timestamp = timestamp;
+	memcpy((char*)current + sizeof(slot_header), data, size);
+	current->sequence.store((_next_write + 1) * 2, std::memory_order_release);
+
+	_next_write++;
+	_header->head.store(_next_write, std::memory_order_seq_cst);
+	if(_header->waiters.load(std::memory_order_seq_cst) > 0){
+		_header->signal.fetch_add(1, std::memory_order_release);
+		syscall(SYS_futex, (uint32_t*)&_header->signal, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+	}
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool shm_ring::read(std::string &out, int64_t *timestamp, bool newest){
+	if(_header == nullptr){
+		return false;
+	}
+
+	uint64_t head = _header->head.load(std::memory_order_acquire);
+	while(_next_read < head){
+		if(newest){
+			_next_read = head - 1;
+		}
+		else if(head - _next_read > _header->slot_number){
+			_lost += head - _header->slot_number - _next_read;
+			_next_read = head - _header->slot_number;
+		}
+
+		slot_header *current = slot(_next_read);
+		uint64_t sequence = current->sequence.load(std::memory_order_acquire);
+		if(sequence == (_next_read + 1) * 2){
+			uint32_t length = current->length;
+			if(length > _header->slot_size){
+				length = _header->slot_size;
+			}
+			out.assign((char*)current + sizeof(slot_header), length);
+			if(timestamp != nullptr){
+				*timestamp = current->timestamp;
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(current->sequence.load(std::memory_order_relaxed) == sequence){
+				_next_read++;
+				return true;
+			}
+		}
+
+		// The writer overwrote the message before or while it was copied
+		_lost++;
+		_next_read++;
+		head = _header->head.load(std::memory_order_acquire);
+	}
+
+	return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool shm_ring::wait(int timeout_ms){
+	uint64_t head = _next_read;
+	return wait_beyond(&head, timeout_ms);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+bool shm_ring::wait_beyond(uint64_t *head, int timeout_ms){
+	if(_header == nullptr){
+		return false;
+	}
+
+	struct timespec deadline;
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	int64_t deadline_ns = (int64_t)deadline.tv_sec * 1000000000 + deadline.tv_nsec + (int64_t)timeout_ms * 1000000;
+
+	// The futex returns early on a signal for an older message, on interrupts or spuriously
+	_header->waiters.fetch_add(1, std::memory_order_seq_cst);
+	uint32_t signal = _header->signal.load(std::memory_order_seq_cst);
+	uint64_t current = _header->head.load(std::memory_order_seq_cst);
+	while(current <= *head){
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		int64_t remaining_ns = deadline_ns - ((int64_t)now.tv_sec * 1000000000 + now.tv_nsec);
+		if(remaining_ns <= 0){
+			break;
+		}
+		struct timespec timeout;
+		timeout.tv_sec = remaining_ns / 1000000000;
+		timeout.tv_nsec = remaining_ns % 1000000000;
+		syscall(SYS_futex, (uint32_t*)&_header->signal, FUTEX_WAIT, signal, &timeout, nullptr, 0);
+		signal = _header->signal.load(std::memory_order_seq_cst);
+		current = _header->head.load(std::memory_order_seq_cst);
+	}
+	_header->waiters.fetch_sub(1, std::memory_order_seq_cst);
+
+	bool is_beyond = current > *head;
+	*head = current;
+	return is_beyond;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long shm_ring::get_lost(){
+	return _lost;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+unsigned long long shm_ring::get_dropped(){
+	return _dropped;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+std::string shm_ring::get_name(){
+	return _name;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//
+void shm_ring::unlink(const std::string &name){
+	shm_unlink(name.c_str());
+}
+
+} //namespace utils
@@ -0,0 +1,90 @@
+#include "binary_protocol.hpp"
+#include "networking_client.hpp"
+#include "networking_sender.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Sends a dense datagram through a shared memory ring and checks the channels the client reads from it.
+ */
+int check_dense_client(){
+	std::string name = "/cogna_dense_client_test";
+	utils::networking_sender sender(name);
+	utils::networking_client client(name, false);
+	utils::networking_client summing(name, false);
+	sender.set_format(utils::FORMAT_BINARY_DENSE);
+	int first = sender.register_channel("first", 0);
+	int second = sender.register_channel("second", 1);
+	int received = client.register_channel("second", utils::FORMAT_BINARY_DENSE, 1);
+	int summed = summing.register_channel("second", utils::FORMAT_BINARY_DENSE, 1, utils::AGGREGATE_SUM);
+
+	int errors = 0;
+	for(int i=0; i < 2; i++){
+		sender.add_slot_data(first, 1.0f);
+		sender.add_slot_data(second, 2.5f);
+		sender.send_payload(1000000000LL * (i + 1));
+	}
+	client.store_message();
+	summing.store_message();
+	if(client.get_slot_value(received) != 2.5f || summing.get_slot_value(summed) != 5.0f){
+		std::cout << "[ERROR] Dense channel was read as " << client.get_slot_value(received) << " and summed to "
+				  << summing.get_slot_value(summed) << std::endl;
+		errors++;
+	}
+
+	utils::shm_ring::unlink(name);
+	return errors;
+}
+
+int main(){
+	std::vector<float> values = {0.5f, 0.0f, 2.25f, -1.0f};
+	std::vector<bool> is_set = {true, false, true, true};
+	std::string datagram;
+	std::vector<float> decoded;
+	utils::binary_header header;
+	int errors = 0;
+
+	utils::encode_binary_pairs(datagram, 7, 1234, values, is_set);
+	std::cout << "Pairs datagram has " << datagram.size() << " bytes." << std::endl;
+	if(utils::decode_binary_message(datagram.data(), datagram.size(), &header, decoded) != 0 ||
+	   header.sequence != 7 || header.timestamp != 1234 || header.count != 3 || decoded.size() != 4 ||
+	   decoded[0] != 0.5f || decoded[1] != 0.0f || decoded[2] != 2.25f || decoded[3] != -1.0f ||
+	   header.layout != utils::BINARY_LAYOUT_PAIRS || header.is_delta){
+		std::cout << "[ERROR] Pairs datagram decoded wrongly." << std::endl;
+		errors++;
+	}
+
+	utils::encode_binary_pairs(datagram, 9, 1234, values, is_set, true);
+	if(utils::decode_binary_message(datagram.data(), datagram.size(), &header, decoded) != 0 ||
+	   header.layout != utils::BINARY_LAYOUT_PAIRS || !header.is_delta || decoded[3] != -1.0f){
+		std::cout << "[ERROR] Delta datagram decoded wrongly." << std::endl;
+		errors++;
+	}
+
+	utils::encode_binary_dense(datagram, 8, 5678, values);
+	std::cout << "Dense datagram has " << datagram.size() << " bytes." << std::endl;
+	if(utils::decode_binary_message(datagram.data(), datagram.size(), &header, decoded) != 0 ||
+	   header.sequence != 8 || header.count != 4 || decoded[2] != 2.25f){
+		std::cout << "[ERROR] Dense datagram decoded wrongly." << std::endl;
+		errors++;
+	}
+
+	if(utils::decode_binary_message(datagram.data(), datagram.size() - 1, &header, decoded) == 0){
+		std::cout << "[ERROR] Truncated datagram was accepted." << std::endl;
+		errors++;
+	}
+
+	std::string json_message = "{\"channel\": 1.0}";
+	if(utils::is_binary_message(json_message.data(), json_message.size())){
+		std::cout << "[ERROR] Json message detected as binary." << std::endl;
+		errors++;
+	}
+
+	errors += check_dense_client();
+
+	if(errors == 0){
+		std::cout << "Binary protocol works." << std::endl;
+	}
+	return errors;
+}
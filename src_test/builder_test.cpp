@@ -26,7 +26,12 @@ int main(int argc, char** argv){
     COGNA::CognaLauncher *cluster_launcher = new COGNA::CognaLauncher(cluster_builder->get_network_list(),
                                                                       cluster_builder->get_client_list(),
                                                                       cluster_builder->get_sender_list(),
-                                                                      cluster_builder->get_frequency());
+                                                                      cluster_builder->get_frequency(),
+                                                                      cluster_builder->get_io_threads(),
+                                                                      cluster_builder->get_tick_mode(),
+                                                                      cluster_builder->get_min_tick_interval(),
+                                                                      cluster_builder->get_relay_table(),
+                                                                      cluster_builder->get_ticks_per_request());
 
     delete cluster_builder;
     cluster_builder = nullptr;
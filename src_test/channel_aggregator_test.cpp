@@ -0,0 +1,125 @@
+#include "channel_aggregator.hpp"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+const int SAMPLE_NUMBER = 200000;
+const int BATCH_SIZE = 7;
+
+/**
+ * Adds the samples 1 to SAMPLE_NUMBER to every channel in small batches, like a receiving thread.
+ */
+void produce(utils::channel_aggregator *aggregator, std::atomic<bool> *is_done, int producer){
+	int sample = 1;
+	while(sample <= SAMPLE_NUMBER){
+		aggregator->begin_batch(producer);
+		for(int i=0; i < BATCH_SIZE && sample <= SAMPLE_NUMBER; i++, sample++){
+			for(int channel=0; channel < aggregator->get_channel_number(); channel++){
+				aggregator->add_sample(channel, (float)sample, sample, producer);
+			}
+		}
+		aggregator->end_batch(producer);
+	}
+	is_done->store(true);
+}
+
+/**
+ * Lets two producers add the same samples at the same time and checks, that the merged sums are complete.
+ */
+int check_producers(){
+	utils::channel_aggregator aggregator(2);
+	int sum = aggregator.add_channel(utils::AGGREGATE_SUM);
+	int max = aggregator.add_channel(utils::AGGREGATE_MAX);
+
+	std::vector<float> values(2, 0.0f);
+	std::vector<int64_t> arrivals(2, 0);
+	std::atomic<bool> is_first_done(false);
+	std::atomic<bool> is_second_done(false);
+	std::thread first(produce, &aggregator, &is_first_done, 0);
+	std::thread second(produce, &aggregator, &is_second_done, 1);
+
+	unsigned long long collected = 0;
+	double total = 0.0;
+	float largest = 0.0f;
+	while(!is_first_done.load() || !is_second_done.load() || collected < (unsigned long long)SAMPLE_NUMBER * 4){
+		unsigned long long samples = aggregator.collect(values, arrivals);
+		if(samples == 0){
+			std::this_thread::yield();
+			continue;
+		}
+		collected += samples;
+		total += values[sum];
+		if(values[max] > largest){
+			largest = values[max];
+		}
+	}
+	first.join();
+	second.join();
+
+	double expected = (double)SAMPLE_NUMBER * (SAMPLE_NUMBER + 1);
+	if(largest != SAMPLE_NUMBER || total < expected * 0.9999 || total > expected * 1.0001){
+		std::cout << "[ERROR] Collected sum " << total << " and max " << largest << " of two producers instead of "
+				  << expected << " and " << SAMPLE_NUMBER << "." << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+int main(){
+	utils::channel_aggregator aggregator;
+	int last = aggregator.add_channel(utils::AGGREGATE_LAST);
+	int sum = aggregator.add_channel(utils::AGGREGATE_SUM);
+	int mean = aggregator.add_channel(utils::AGGREGATE_MEAN);
+	int max = aggregator.add_channel(utils::AGGREGATE_MAX);
+
+	std::vector<float> values(4, 0.0f);
+	std::vector<int64_t> arrivals(4, 0);
+	std::atomic<bool> is_done(false);
+	std::thread producer(produce, &aggregator, &is_done, 0);
+
+	int errors = 0;
+	unsigned long long collected = 0;
+	double total = 0.0;
+	float previous_max = 0.0f;
+	int collections = 0;
+	while(!is_done.load() || collected < (unsigned long long)SAMPLE_NUMBER * 4){
+		unsigned long long samples = aggregator.collect(values, arrivals);
+		if(samples == 0){
+			std::this_thread::yield();
+			continue;
+		}
+		collected += samples;
+		collections++;
+
+		// Every channel got the same samples, so the aggregates must fit together
+		unsigned long long count = samples / 4;
+		double first = values[max] - count + 1;
+		double expected_mean = (first + values[max]) / 2.0;
+		if(values[last] != values[max] || values[max] <= previous_max || arrivals[last] != (int64_t)values[max] ||
+		   values[mean] < expected_mean - 0.01 || values[mean] > expected_mean + 0.01){
+			std::cout << "[ERROR] Inconsistent aggregates: last=" << values[last] << " max=" << values[max]
+					  << " mean=" << values[mean] << " samples=" << count << std::endl;
+			errors++;
+			break;
+		}
+		previous_max = values[max];
+		total += values[sum];
+	}
+	producer.join();
+
+	double expected = (double)SAMPLE_NUMBER * (SAMPLE_NUMBER + 1) / 2.0;
+	if(errors == 0 && (previous_max != SAMPLE_NUMBER || total < expected * 0.9999 || total > expected * 1.0001)){
+		std::cout << "[ERROR] Collected sum " << total << " and max " << previous_max << " instead of "
+				  << expected << " and " << SAMPLE_NUMBER << "." << std::endl;
+		errors++;
+	}
+
+	errors += check_producers();
+
+	std::cout << "Collected " << collected / 4 << " samples per channel in " << collections << " collections." << std::endl;
+	if(errors == 0){
+		std::cout << "Channel aggregator works." << std::endl;
+	}
+	return errors;
+}
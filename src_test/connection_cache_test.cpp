@@ -0,0 +1,82 @@
+#include "NeuralNetwork.hpp"
+#include "Constants.hpp"
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace COGNA;
+
+const long CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Returns the offset of a field in a connection in bytes.
+ */
+static long field_offset(const Connection *con, const void *field){
+    return (const char*)field - (const char*)con;
+}
+
+int main(){
+    int errors = 0;
+
+    NeuralNetwork *nn = new NeuralNetwork();
+    nn->add_neuron(1.0f);
+    nn->add_neuron(100.0f);
+    nn->add_neuron(100.0f);
+    Connection *con = nn->add_neuron_connection(1, 2, 1.0f, INHIBITORY, FUNCTION_RELU, LEARNING_NONE);
+    nn->add_neuron_connection(1, 3, 1.0f, EXCITATORY, FUNCTION_RELU, LEARNING_NONE);
+
+    // Everything the firing loop reads lies in the first cache line of a connection
+    long hot_end = field_offset(con, &con->last_presynaptic_activated_step) + sizeof(con->last_presynaptic_activated_step);
+    std::cout << "Fields read while firing take " << hot_end << " bytes of " << sizeof(Connection) << "." << std::endl;
+    if(hot_end > CACHE_LINE_SIZE || field_offset(con, &con->fire_threshold) >= CACHE_LINE_SIZE){
+        std::cout << "[ERROR] Fields read while firing do not fit into one cache line." << std::endl;
+        errors++;
+    }
+
+    // The copies follow the parameters they are taken from once the network is set up
+    nn->get_neuron(1)->_parameter->activation_threshold = 3.0f;
+    nn->setup_network();
+    if(con->fire_threshold != 3.0f || con->activation_type != INHIBITORY || con->transmitter_type != STD_TRANSMITTER){
+        std::cout << "[ERROR] Connection caches threshold " << con->fire_threshold << " and activation type "
+                  << (int)con->activation_type << "." << std::endl;
+        errors++;
+    }
+
+    // The source neuron fires with the cached threshold
+    std::vector<NeuralNetwork*> network_list = {nn};
+    float activations[] = {2.0f, 4.0f};
+    bool should_fire[] = {false, true};
+    fflush(stdout);
+    int output = dup(STDOUT_FILENO);
+    int silence = open("/dev/null", O_WRONLY);
+    dup2(silence, STDOUT_FILENO);
+    int fire_errors = 0;
+    for(int i=0; i < 2; i++){
+        nn->init_activation(1, activations[i]);
+        nn->feed_forward(network_list);
+        nn->feed_forward(network_list);
+        if((nn->get_neuron(3)->_activation > 0.0f) != should_fire[i]){
+            fire_errors++;
+        }
+        nn->get_neuron(1)->_activation = 0.0f;
+        nn->get_neuron(3)->_activation = 0.0f;
+    }
+    std::cout.flush();
+    fflush(stdout);
+    dup2(output, STDOUT_FILENO);
+    close(output);
+    close(silence);
+    if(fire_errors != 0){
+        std::cout << "[ERROR] Neuron did not fire by its activation threshold." << std::endl;
+        errors++;
+    }
+
+    delete nn;
+
+    if(errors == 0){
+        std::cout << "Connection cache works." << std::endl;
+    }
+    return errors;
+}
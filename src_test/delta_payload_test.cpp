@@ -0,0 +1,113 @@
+#include "networking_sender.hpp"
+#include "networking_client.hpp"
+#include "binary_protocol.hpp"
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+/**
+ * Sends delta payloads through a shared memory ring and checks what the receiving client sees.
+ */
+int test_format(int format, std::string name){
+	utils::networking_sender sender(name);
+	utils::networking_client client(name, true);
+	sender.set_format(format);
+	sender.set_delta_mode(0.1f, 3);
+	int sent_a = sender.register_channel("a", 0);
+	int sent_b = sender.register_channel("b", 1);
+	int received_a = client.register_channel("a", format, 0);
+	int received_b = client.register_channel("b", format, 1);
+
+	// Every row is one tick: the values added to both channels, if they should be sent, and what the client holds afterwards
+	const int TICKS = 5;
+	float added[TICKS][2] = {{1.0f, 2.0f}, {1.05f, 3.0f}, {1.05f, 3.0f}, {-1.0f, -1.0f}, {1.0f, 5.0f}};
+	bool is_sent[TICKS] = {true, true, false, true, true};
+	float expected[TICKS][2] = {{1.0f, 2.0f}, {1.0f, 3.0f}, {1.0f, 3.0f}, {1.0f, 3.0f}, {1.0f, 5.0f}};
+
+	int errors = 0;
+	int64_t sent_number = 0;
+	for(int tick=0; tick < TICKS; tick++){
+		if(added[tick][0] >= 0.0f){
+			sender.add_slot_data(sent_a, added[tick][0]);
+			sender.add_slot_data(sent_b, added[tick][1]);
+		}
+		bool was_sent = sender.send_payload(1000000000LL * (tick + 1));
+		client.store_message();
+
+		if(was_sent != is_sent[tick] || client.get_slot_value(received_a) != expected[tick][0] ||
+		   client.get_slot_value(received_b) != expected[tick][1]){
+			std::cout << "[ERROR] Tick " << tick << ": sent=" << was_sent << " a=" << client.get_slot_value(received_a)
+					  << " b=" << client.get_slot_value(received_b) << std::endl;
+			errors++;
+		}
+		if(format == utils::FORMAT_JSON && was_sent){
+			std::cout << client.get_message() << std::endl;
+		}
+		// The sequence number of the stored message is readable until the end of the tick
+		int64_t sequence = -1;
+		if(client.get_sequence(&sequence) != was_sent || (was_sent && sequence != sent_number)){
+			std::cout << "[ERROR] Tick " << tick << ": read sequence " << sequence << " of " << sent_number
+					  << " sent messages." << std::endl;
+			errors++;
+		}
+		sent_number += was_sent;
+		// Like at the end of every tick of the network, which must not lose the channels of a delta stream
+		client.clear_message();
+	}
+
+	utils::shm_ring::unlink(name);
+	return errors;
+}
+
+/**
+ * Sends a keyframe and two deltas over udp, which are received in one batch by a client storing only the newest message.
+ */
+int test_batched_deltas(int format, int port){
+	utils::networking_sender sender("127.0.0.1", port);
+	utils::networking_client client("127.0.0.1", port, true, utils::EXCHANGE_LATEST);
+	sender.set_format(format);
+	sender.set_delta_mode(0.1f, 100);
+	int sent_a = sender.register_channel("a", 0);
+	int sent_b = sender.register_channel("b", 1);
+	int received_a = client.register_channel("a", format, 0);
+	int received_b = client.register_channel("b", format, 1);
+
+	sender.add_slot_data(sent_a, 1.0f);
+	sender.add_slot_data(sent_b, 2.0f);
+	sender.send_payload(1000000000LL);
+	sender.add_slot_data(sent_a, 4.0f);
+	sender.add_slot_data(sent_b, 2.0f);
+	sender.send_payload(2000000000LL);
+	sender.add_slot_data(sent_a, 4.0f);
+	sender.add_slot_data(sent_b, 6.0f);
+	sender.send_payload(3000000000LL);
+	usleep(100000);
+
+	int errors = 0;
+	int received = client.receive_pending();
+	client.store_message();
+	if(received != 3 || client.get_slot_value(received_a) != 4.0f || client.get_slot_value(received_b) != 6.0f){
+		std::cout << "[ERROR] Received " << received << " deltas in one batch: a=" << client.get_slot_value(received_a)
+				  << " b=" << client.get_slot_value(received_b) << std::endl;
+		errors++;
+	}
+	return errors;
+}
+
+int main(){
+	int errors = 0;
+
+	std::cout << "Testing json delta payloads." << std::endl;
+	errors += test_format(utils::FORMAT_JSON, "/cogna_delta_json_test");
+	std::cout << "Testing binary delta payloads." << std::endl;
+	errors += test_format(utils::FORMAT_BINARY_PAIRS, "/cogna_delta_binary_test");
+	std::cout << "Testing batched json deltas." << std::endl;
+	errors += test_batched_deltas(utils::FORMAT_JSON, 40150);
+	std::cout << "Testing batched binary deltas." << std::endl;
+	errors += test_batched_deltas(utils::FORMAT_BINARY_PAIRS, 40151);
+
+	if(errors == 0){
+		std::cout << "Delta payloads work." << std::endl;
+	}
+	return errors;
+}
@@ -0,0 +1,194 @@
+#include "frame_protocol.hpp"
+#include "binary_protocol.hpp"
+#include "networking_client.hpp"
+#include "networking_sender.hpp"
+#include "batch_sender.hpp"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <sys/socket.h>
+
+const size_t DATAGRAM_SIZE = 1000;
+const int CHANNEL_NUMBER = 2000;
+
+/**
+ * Returns the frame with the given index out of frames encoded back to back.
+ */
+std::string get_frame(const std::string &frames, int index){
+	size_t offset = index * DATAGRAM_SIZE;
+	return frames.substr(offset, std::min(DATAGRAM_SIZE, frames.size() - offset));
+}
+
+int main(){
+	int errors = 0;
+
+	std::string message;
+	for(int i=0; i < 5000; i++){
+		message.push_back((char)('a' + i % 26));
+	}
+
+	// Frames arriving out of order and twice are reassembled
+	std::string frames;
+	int frame_number = utils::encode_frames(frames, 7, message.data(), message.size(), DATAGRAM_SIZE);
+	if(frame_number != 6 || !utils::is_frame(frames.data(), frames.size())){
+		std::cout << "[ERROR] Message was split into " << frame_number << " frames." << std::endl;
+		errors++;
+	}
+	utils::frame_assembler assembler;
+	int order[] = {5, 0, 2, 2, 1, 4, 3};
+	for(int i=0; i < 7; i++){
+		std::string frame = get_frame(frames, order[i]);
+		bool is_complete = assembler.add(frame.data(), frame.size());
+		if(is_complete != (i == 6)){
+			std::cout << "[ERROR] Frame " << order[i] << " completed the message: " << is_complete << std::endl;
+			errors++;
+		}
+	}
+	if(assembler.get_message() != message){
+		std::cout << "[ERROR] Reassembled message differs." << std::endl;
+		errors++;
+	}
+
+	// Messages are reassembled interleaved, even from two sources using the same message id
+	std::string other_frames;
+	std::string short_frames;
+	utils::encode_frames(frames, 8, message.data(), message.size(), DATAGRAM_SIZE);
+	utils::encode_frames(other_frames, 8, message.data() + 1, message.size() - 1, DATAGRAM_SIZE);
+	utils::encode_frames(short_frames, 9, message.data(), 10, DATAGRAM_SIZE);
+	for(int i=0; i < frame_number - 1; i++){
+		std::string frame = get_frame(frames, i);
+		std::string other_frame = get_frame(other_frames, i);
+		assembler.add(frame.data(), frame.size(), 1);
+		assembler.add(other_frame.data(), other_frame.size(), 2);
+	}
+	if(!assembler.add(short_frames.data(), short_frames.size(), 1) || assembler.get_message() != message.substr(0, 10)){
+		std::cout << "[ERROR] Message between the frames of another one was not reassembled." << std::endl;
+		errors++;
+	}
+	std::string last_frame = get_frame(frames, frame_number - 1);
+	std::string other_last_frame = get_frame(other_frames, frame_number - 1);
+	if(!assembler.add(other_last_frame.data(), other_last_frame.size(), 2) || assembler.get_message() != message.substr(1) ||
+	   !assembler.add(last_frame.data(), last_frame.size(), 1) || assembler.get_message() != message ||
+	   assembler.get_incomplete() != 0){
+		std::cout << "[ERROR] Interleaved messages of two sources were not reassembled." << std::endl;
+		errors++;
+	}
+
+	// A lost frame discards its message once FRAME_MAX_PENDING newer messages are reassembled
+	for(uint32_t id=10; id < 10 + FRAME_MAX_PENDING + 1; id++){
+		utils::encode_frames(frames, id, message.data(), message.size(), DATAGRAM_SIZE);
+		std::string frame = get_frame(frames, 0);
+		assembler.add(frame.data(), frame.size(), 1);
+	}
+	if(assembler.get_incomplete() != 1){
+		std::cout << "[ERROR] " << assembler.get_incomplete() << " incomplete messages were discarded." << std::endl;
+		errors++;
+	}
+
+	// A payload of many channels is sent in frames and reassembled by the client
+	utils::networking_client client("127.0.0.1", 40021, true, utils::EXCHANGE_QUEUE);
+	utils::networking_sender *sender = new utils::networking_sender("127.0.0.1", 40021);
+	sender->set_max_datagram_size(DATAGRAM_SIZE);
+	std::vector<int> client_slots;
+	std::vector<int> sender_slots;
+	for(int i=0; i < CHANNEL_NUMBER; i++){
+		std::string key = "channel_" + std::to_string(i);
+		client_slots.push_back(client.register_channel(key, utils::FORMAT_JSON, i));
+		sender_slots.push_back(sender->register_channel(key, i));
+	}
+	utils::batch_sender batch(std::vector<utils::networking_sender*>{sender});
+	if(batch.open_sockets() != 0){
+		errors++;
+	}
+	for(int i=0; i < CHANNEL_NUMBER; i++){
+		sender->add_slot_data(sender_slots[i], (float)i);
+	}
+	int sent = batch.flush();
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	client.receive_pending();
+	client.store_message();
+
+	int wrong = 0;
+	for(int i=0; i < CHANNEL_NUMBER; i++){
+		if(client.get_slot_value(client_slots[i]) != (float)i){
+			wrong++;
+		}
+	}
+	if(wrong > 0 || sent < 2 || batch.get_dropped() > 0){
+		std::cout << "[ERROR] " << wrong << " channels were not received from " << sent << " datagrams." << std::endl;
+		errors++;
+	}
+
+	delete sender;
+
+	// Two senders framing their payloads towards one unix socket are reassembled separately
+	utils::networking_client unix_client("unix:@cogna_frame_protocol_test", 0, true, utils::EXCHANGE_QUEUE);
+	std::vector<utils::networking_sender*> unix_senders;
+	std::vector<std::vector<int>> unix_slots(2);
+	for(int s=0; s < 2; s++){
+		unix_senders.push_back(new utils::networking_sender("unix:@cogna_frame_protocol_test", 0));
+		unix_senders[s]->set_max_datagram_size(DATAGRAM_SIZE);
+		for(int i=0; i < CHANNEL_NUMBER / 4; i++){
+			std::string key = "sender_" + std::to_string(s) + "_" + std::to_string(i);
+			unix_slots[s].push_back(unix_client.register_channel(key, utils::FORMAT_JSON, i));
+			unix_senders[s]->add_slot_data(unix_senders[s]->register_channel(key, i), (float)(s + 1));
+		}
+	}
+	// A unix socket only queues a few datagrams, so the frames of every sender are received before the next sends
+	for(int s=0; s < 2; s++){
+		unix_senders[s]->send_payload();
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		unix_client.receive_pending();
+	}
+	unix_client.store_message();
+	int unix_wrong = 0;
+	for(int s=0; s < 2; s++){
+		for(unsigned int i=0; i < unix_slots[s].size(); i++){
+			if(unix_client.get_slot_value(unix_slots[s][i]) != (float)(s + 1)){
+				unix_wrong++;
+			}
+		}
+		delete unix_senders[s];
+	}
+	if(unix_wrong > 0 || unix_client.get_incomplete_messages() > 0){
+		std::cout << "[ERROR] " << unix_wrong << " channels of two unix senders were not received, "
+				  << unix_client.get_incomplete_messages() << " messages were incomplete." << std::endl;
+		errors++;
+	}
+
+	// A destination failing to take a frame does not keep the frames from the other destinations
+	utils::networking_client reachable_client("unix:@cogna_frame_protocol_reachable", 0, true, utils::EXCHANGE_QUEUE);
+	utils::networking_sender fan_out("unix:@cogna_frame_protocol_unreachable", 0);
+	fan_out.set_max_datagram_size(DATAGRAM_SIZE);
+	if(fan_out.add_destination("unix:@cogna_frame_protocol_reachable", 0) != 0){
+		errors++;
+	}
+	std::vector<int> reachable_slots;
+	for(int i=0; i < CHANNEL_NUMBER / 4; i++){
+		std::string key = "fan_out_" + std::to_string(i);
+		reachable_slots.push_back(reachable_client.register_channel(key, utils::FORMAT_JSON, i));
+		fan_out.add_slot_data(fan_out.register_channel(key, i), 3.0f);
+	}
+	bool is_fan_out_sent = fan_out.send_payload((int64_t)0);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	reachable_client.receive_pending();
+	reachable_client.store_message();
+	int reachable_wrong = 0;
+	for(unsigned int i=0; i < reachable_slots.size(); i++){
+		if(reachable_client.get_slot_value(reachable_slots[i]) != 3.0f){
+			reachable_wrong++;
+		}
+	}
+	if(is_fan_out_sent || reachable_wrong > 0){
+		std::cout << "[ERROR] " << reachable_wrong << " channels behind an unreachable destination were not received, "
+				  << "sending " << (is_fan_out_sent ? "succeeded" : "failed") << "." << std::endl;
+		errors++;
+	}
+
+	if(errors == 0){
+		std::cout << "Frame protocol works (segmentation offload " << (batch.is_segmenting(AF_INET) ? "on" : "off")
+				  << ", coalescing " << (client.is_coalescing() ? "on" : "off") << ")." << std::endl;
+	}
+	return errors;
+}
@@ -0,0 +1,78 @@
+#include "NeuralNetwork.hpp"
+#include "Constants.hpp"
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace COGNA;
+
+const int64_t ARRIVAL = 1000;
+
+int main(){
+    int errors = 0;
+
+    // Neuron 1 fires into neuron 2 and 3 without making them fire. Neuron 4 inhibits neuron 3.
+    NeuralNetwork *nn = new NeuralNetwork();
+    nn->_parameter->activation_backfall_curvature = 1.0f;
+    nn->_parameter->activation_backfall_steepness = 0.1f;
+    nn->add_neuron(1.0f);
+    nn->add_neuron(100.0f);
+    nn->add_neuron(100.0f);
+    nn->add_neuron(1.0f);
+    nn->add_neuron_connection(1, 2, 0.5f, EXCITATORY, FUNCTION_RELU, LEARNING_NONE);
+    nn->add_neuron_connection(1, 3, 0.5f, EXCITATORY, FUNCTION_RELU, LEARNING_NONE);
+    nn->add_neuron_connection(4, 3, 2.0f, INHIBITORY, FUNCTION_RELU, LEARNING_NONE);
+    nn->set_latency_tracing(true);
+    nn->setup_network();
+    std::vector<NeuralNetwork*> network_list = {nn};
+
+    fflush(stdout);
+    int output = dup(STDOUT_FILENO);
+    int silence = open("/dev/null", O_WRONLY);
+    dup2(silence, STDOUT_FILENO);
+
+    // A traced input reaches neuron 2 and 3
+    nn->get_neuron(1)->_input_arrival = ARRIVAL;
+    nn->init_activation(1, 2.0f);
+    nn->feed_forward(network_list);
+    int64_t reached_2 = nn->get_neuron(2)->_input_arrival;
+    int64_t reached_3 = nn->get_neuron(3)->_input_arrival;
+
+    // Neuron 3 is inhibited back to its minimum, neuron 2 fades
+    nn->init_activation(4, 2.0f);
+    nn->feed_forward(network_list);
+    for(int step=0; step < 20; step++){
+        nn->feed_forward(network_list);
+    }
+
+    // An untraced input must not report the old arrival
+    nn->init_activation(1, 2.0f);
+    nn->feed_forward(network_list);
+    std::cout.flush();
+    fflush(stdout);
+    dup2(output, STDOUT_FILENO);
+    close(output);
+    close(silence);
+
+    if(reached_2 != ARRIVAL || reached_3 != ARRIVAL){
+        std::cout << "[ERROR] Arrival was not passed on, neuron 2 got " << reached_2 << " and neuron 3 got "
+                  << reached_3 << "." << std::endl;
+        errors++;
+    }
+    for(int n=1; n <= 3; n++){
+        if(nn->get_neuron(n)->_input_arrival != 0){
+            std::cout << "[ERROR] N-" << n << " kept the arrival " << nn->get_neuron(n)->_input_arrival
+                      << " with activation " << nn->get_neuron(n)->_activation << "." << std::endl;
+            errors++;
+        }
+    }
+
+    delete nn;
+
+    if(errors == 0){
+        std::cout << "Input arrivals work." << std::endl;
+    }
+    return errors;
+}
@@ -0,0 +1,61 @@
+#include "input_signal.hpp"
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+const int NOTIFY_NUMBER = 10000;
+
+int main(){
+	utils::input_signal signal;
+	int errors = 0;
+
+	uint32_t seen = signal.get_counter();
+	if(signal.wait(&seen, 1000)){
+		std::cout << "[ERROR] Waiting without notification was signalled." << std::endl;
+		errors++;
+	}
+
+	// A notification before waiting must not be missed
+	signal.notify();
+	if(!signal.wait(&seen, 0)){
+		std::cout << "[ERROR] Earlier notification was missed." << std::endl;
+		errors++;
+	}
+
+	// A waiting thread must be woken up by a notification of another thread
+	auto start = std::chrono::steady_clock::now();
+	std::thread notifier([&signal](){
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		signal.notify();
+	});
+	bool is_signalled = signal.wait(&seen, -1);
+	notifier.join();
+	auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+	if(!is_signalled || waited.count() > 1000){
+		std::cout << "[ERROR] Waiting thread was not woken up." << std::endl;
+		errors++;
+	}
+
+	// Every burst of notifications wakes the waiting thread up, none is lost at the end
+	std::atomic<bool> is_done(false);
+	std::thread burst([&signal, &is_done](){
+		for(int i=0; i < NOTIFY_NUMBER; i++){
+			signal.notify();
+		}
+		is_done.store(true);
+	});
+	while(!is_done.load() || signal.get_counter() != seen){
+		if(!signal.wait(&seen, 100000) && !is_done.load()){
+			std::cout << "[ERROR] Burst of notifications was missed." << std::endl;
+			errors++;
+			break;
+		}
+	}
+	burst.join();
+
+	if(errors == 0){
+		std::cout << "Input signal works." << std::endl;
+	}
+	return errors;
+}
@@ -0,0 +1,326 @@
+#include "io_reactor.hpp"
+#include "batch_sender.hpp"
+#include "relay_table.hpp"
+#include "networking_client.hpp"
+#include "networking_sender.hpp"
+#include "binary_protocol.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/socket.h>
+
+/**
+ * Returns the number of file descriptors open in the process.
+ */
+int count_open_files(){
+	int count = 0;
+	DIR *directory = opendir("/proc/self/fd");
+	if(directory == nullptr){
+		return -1;
+	}
+	while(readdir(directory) != nullptr){
+		count++;
+	}
+	closedir(directory);
+	return count;
+}
+
+int main(){
+	const int client_number = 4;
+	std::vector<utils::networking_client*> clients;
+	std::vector<utils::networking_sender*> senders;
+	for(int i=0; i < client_number; i++){
+		clients.push_back(new utils::networking_client("127.0.0.1", 40100 + i, true));
+		clients[i]->register_channel("value", utils::FORMAT_JSON, 0);
+		senders.push_back(new utils::networking_sender("127.0.0.1", 40100 + i));
+	}
+
+	utils::io_reactor reactor(clients, 2);
+	if(reactor.start() != 0){
+		return 1;
+	}
+	std::cout << "Receiving " << client_number << " ports with " << reactor.get_thread_number() << " threads."
+			  << std::endl;
+
+	utils::batch_sender batch(senders);
+	if(batch.open_sockets() != 0){
+		return 1;
+	}
+	for(int i=0; i < client_number; i++){
+		senders[i]->add_data("value", (float)(i + 1));
+	}
+
+	int errors = 0;
+	if(batch.flush() != client_number || batch.get_dropped() != 0){
+		std::cout << "[ERROR] Batch sender sent " << batch.get_sent() << " and dropped " << batch.get_dropped()
+				  << " messages." << std::endl;
+		errors++;
+	}
+	usleep(100000);
+
+	for(int i=0; i < client_number; i++){
+		clients[i]->store_message();
+		if(clients[i]->get_slot_value(0) != (float)(i + 1)){
+			std::cout << "[ERROR] Port " << 40100 + i << " received " << clients[i]->get_slot_value(0) << std::endl;
+			errors++;
+		}
+	}
+
+	// The arrival stamp is handed on to an output, which records the latency when it is sent.
+	int64_t arrival = clients[0]->get_slot_arrival(0);
+	int output_slot = senders[0]->register_channel("latency", 0);
+	senders[0]->add_slot_data(output_slot, 1.0f, arrival);
+	batch.flush();
+	const utils::latency_histogram &latency = senders[0]->get_channel_latency(output_slot);
+	std::cout << "Input to output latency: " << latency.get_max() / 1000 << " us." << std::endl;
+	if(arrival <= 0 || latency.get_count() != 1 || latency.get_max() < 100000000 || latency.get_max() > 1000000000){
+		std::cout << "[ERROR] Arrival of input was not traced." << std::endl;
+		errors++;
+	}
+
+	auto begin = std::chrono::steady_clock::now();
+	reactor.stop();
+	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+	std::cout << "Stopped io reactor in " << duration.count() << " ms." << std::endl;
+	if(duration.count() > 100){
+		std::cout << "[ERROR] Stopping the io reactor took too long." << std::endl;
+		errors++;
+	}
+
+	for(int i=0; i < client_number; i++){
+		delete clients[i];
+		delete senders[i];
+	}
+
+	// One port received by several queues. Every sender has its own source port, so they are spread over the queues.
+	const int queue_number = 4;
+	const int sender_number = 16;
+	utils::networking_client shared("127.0.0.1", 40110, true, utils::EXCHANGE_LATEST, queue_number);
+	int count_slot = shared.register_channel("count", utils::FORMAT_JSON, 0, utils::AGGREGATE_SUM);
+	std::vector<utils::networking_sender*> shared_senders;
+	for(int i=0; i < sender_number; i++){
+		shared_senders.push_back(new utils::networking_sender("127.0.0.1", 40110));
+		shared_senders[i]->add_data("count", 1.0f);
+	}
+	std::vector<utils::networking_client*> shared_clients(1, &shared);
+	utils::io_reactor shared_reactor(shared_clients, queue_number);
+	if(shared_reactor.start() != 0){
+		return 1;
+	}
+	for(int i=0; i < sender_number; i++){
+		shared_senders[i]->send_payload();
+	}
+	usleep(100000);
+	shared.store_message();
+	std::cout << "Received " << shared.get_slot_value(count_slot) << " messages with " << shared.get_queue_number()
+			  << " queues and " << shared_reactor.get_thread_number() << " threads on one port." << std::endl;
+	if(shared.get_queue_number() != queue_number || shared_reactor.get_thread_number() != queue_number ||
+	   shared.get_slot_value(count_slot) != (float)sender_number){
+		std::cout << "[ERROR] Receive queues lost messages." << std::endl;
+		errors++;
+	}
+	shared_reactor.stop();
+	for(int i=0; i < sender_number; i++){
+		delete shared_senders[i];
+	}
+
+	// One sender fanning its payload out to several destinations, serialized once.
+	const int destination_number = 3;
+	std::vector<utils::networking_client*> consumers;
+	utils::networking_sender fan_out("127.0.0.1", 40120);
+	for(int i=0; i < destination_number; i++){
+		consumers.push_back(new utils::networking_client("127.0.0.1", 40120 + i, true));
+		consumers[i]->register_channel("fan", utils::FORMAT_JSON, 0);
+	}
+	// Destinations only hold their address and are sent through the socket of the sender
+	int open_files = count_open_files();
+	for(int i=0; i < destination_number; i++){
+		if(fan_out.add_destination("127.0.0.1", 40120 + i) != 0){
+			errors++;
+		}
+	}
+	if(count_open_files() != open_files){
+		std::cout << "[ERROR] Adding destinations opened " << count_open_files() - open_files << " files." << std::endl;
+		errors++;
+	}
+	udp_client_server::udp_address group("239.255.0.1", 40125);
+	udp_client_server::udp_address group_ipv6("ff02::1", 40125);
+	udp_client_server::udp_address host("127.0.0.1", 40125);
+	if(!group.is_multicast() || !group_ipv6.is_multicast() || host.is_multicast()){
+		std::cout << "[ERROR] Multicast groups are not recognized." << std::endl;
+		errors++;
+	}
+	if(fan_out.add_destination("::1", 40120) == 0 || fan_out.get_destination_number() != destination_number){
+		std::cout << "[ERROR] Sender has " << fan_out.get_destination_number() << " destinations." << std::endl;
+		errors++;
+	}
+	utils::io_reactor consumer_reactor(consumers, 1);
+	std::vector<utils::networking_sender*> fan_out_senders(1, &fan_out);
+	utils::batch_sender fan_out_batch(fan_out_senders);
+	if(consumer_reactor.start() != 0 || fan_out_batch.open_sockets() != 0){
+		return 1;
+	}
+	fan_out.add_slot_data(fan_out.register_channel("fan", 0), 7.0f);
+	if(fan_out_batch.flush() != destination_number){
+		std::cout << "[ERROR] Batch sender sent " << fan_out_batch.get_sent() << " datagrams to "
+				  << destination_number << " destinations." << std::endl;
+		errors++;
+	}
+	usleep(100000);
+	for(int i=0; i < destination_number; i++){
+		consumers[i]->store_message();
+		if(consumers[i]->get_slot_value(0) != 7.0f){
+			std::cout << "[ERROR] Destination " << 40120 + i << " received " << consumers[i]->get_slot_value(0) << std::endl;
+			errors++;
+		}
+	}
+	consumer_reactor.stop();
+	for(int i=0; i < destination_number; i++){
+		delete consumers[i];
+	}
+
+	// Input channels linked directly to an output, forwarded once per tick or by the receiving thread on arrival.
+	utils::networking_client relay_input("127.0.0.1", 40130, true);
+	utils::networking_client relay_consumer("127.0.0.1", 40131, true);
+	utils::networking_sender relay_output("127.0.0.1", 40131);
+	utils::networking_sender relay_feeder("127.0.0.1", 40130);
+	utils::relay_table relay;
+	int tick_in = relay_input.register_channel("tick_in", utils::FORMAT_JSON, 0);
+	int fast_in = relay_input.register_channel("fast_in", utils::FORMAT_JSON, 1);
+	int tick_out = relay_consumer.register_channel("tick_out", utils::FORMAT_JSON, 0);
+	int fast_out = relay_consumer.register_channel("fast_out", utils::FORMAT_JSON, 1);
+	int other_out = relay_consumer.register_channel("other", utils::FORMAT_JSON, 2);
+	int other_slot = relay_output.register_channel("other", 2);
+	if(relay.add_route(&relay_input, tick_in, &relay_output, relay_output.register_channel("tick_out", 0)) != 0 ||
+	   relay.add_route(&relay_input, fast_in, &relay_output, relay_output.register_channel("fast_out", 1),
+					   utils::RELAY_IMMEDIATE) != 1 || relay.get_route_number() != 2){
+		std::cout << "[ERROR] Could not add relay routes." << std::endl;
+		errors++;
+	}
+	// Two immediate routes of the same message towards a probe, which counts the relayed datagrams
+	udp_client_server::udp_server relay_probe("127.0.0.1", 40133);
+	utils::networking_sender relay_probe_output("127.0.0.1", 40133);
+	int second_in = relay_input.register_channel("second_in", utils::FORMAT_JSON, 2);
+	relay.add_route(&relay_input, fast_in, &relay_probe_output, relay_probe_output.register_channel("fast_out", 0),
+					utils::RELAY_IMMEDIATE);
+	relay.add_route(&relay_input, second_in, &relay_probe_output, relay_probe_output.register_channel("second_out", 1),
+					utils::RELAY_IMMEDIATE);
+	std::vector<utils::networking_client*> relay_clients = {&relay_input, &relay_consumer};
+	utils::io_reactor relay_reactor(relay_clients, 1);
+	if(relay_reactor.start() != 0){
+		return 1;
+	}
+
+	relay_output.add_slot_data(other_slot, 5.0f);
+	relay_output.send_payload();
+	usleep(100000);
+	relay_consumer.store_message();
+	relay_feeder.add_data("tick_in", 2.0f);
+	relay_feeder.add_data("fast_in", 3.0f);
+	relay_feeder.send_payload();
+	usleep(100000);
+
+	// The immediate route is sent before any tick. Its payload only contains the relayed channel.
+	relay_consumer.store_message();
+	if(relay_consumer.get_slot_value(fast_out) != 3.0f || relay_consumer.get_slot_value(tick_out) != 0.0f ||
+	   relay_consumer.get_slot_value(other_out) != 5.0f){
+		std::cout << "[ERROR] Immediate relay delivered fast_out=" << relay_consumer.get_slot_value(fast_out)
+				  << " tick_out=" << relay_consumer.get_slot_value(tick_out)
+				  << " other=" << relay_consumer.get_slot_value(other_out) << std::endl;
+		errors++;
+	}
+	relay_input.store_message();
+	relay.forward();
+	relay_output.send_payload();
+	usleep(100000);
+	relay_consumer.store_message();
+	if(relay_consumer.get_slot_value(tick_out) != 2.0f){
+		std::cout << "[ERROR] Tick relay delivered " << relay_consumer.get_slot_value(tick_out) << std::endl;
+		errors++;
+	}
+
+	// A payload of the output node and a relayed payload arriving in the same tick are both applied
+	relay_output.add_slot_data(other_slot, 6.0f);
+	relay_output.send_payload();
+	relay_feeder.add_data("fast_in", 4.0f);
+	relay_feeder.add_data("second_in", 8.0f);
+	char probe_buffer[1024];
+	while(recv(relay_probe.get_socket(), probe_buffer, sizeof(probe_buffer), MSG_DONTWAIT) > 0){
+	}
+	relay_feeder.send_payload();
+	usleep(100000);
+	relay_consumer.store_message();
+	if(relay_consumer.get_slot_value(other_out) != 6.0f || relay_consumer.get_slot_value(fast_out) != 4.0f){
+		std::cout << "[ERROR] Payloads of the same tick delivered other=" << relay_consumer.get_slot_value(other_out)
+				  << " fast_out=" << relay_consumer.get_slot_value(fast_out) << std::endl;
+		errors++;
+	}
+
+	// All routes of one received message towards the same output node are sent in one datagram
+	int probe_datagrams = 0;
+	std::string probe_message;
+	int probe_size = 0;
+	while((probe_size = recv(relay_probe.get_socket(), probe_buffer, sizeof(probe_buffer), MSG_DONTWAIT)) > 0){
+		probe_message.assign(probe_buffer, probe_size);
+		probe_datagrams++;
+	}
+	if(probe_datagrams != 1 || probe_message.find("\"fast_out\":4") == std::string::npos ||
+	   probe_message.find("\"second_out\":8") == std::string::npos){
+		std::cout << "[ERROR] Immediate relay sent " << probe_datagrams << " datagrams, the last one "
+				  << probe_message << std::endl;
+		errors++;
+	}
+	relay_reactor.stop();
+
+	// Unix domain sockets, by path and in the abstract namespace, are batched together with udp senders.
+	std::vector<std::string> unix_addresses = {"unix:/tmp/cogna_io_reactor_test.sock", "unix:@cogna_io_reactor_test"};
+	std::vector<utils::networking_client*> unix_clients;
+	std::vector<utils::networking_sender*> unix_senders;
+	for(unsigned int i=0; i < unix_addresses.size(); i++){
+		unix_clients.push_back(new utils::networking_client(unix_addresses[i], 0, true));
+		unix_clients[i]->register_channel("value", utils::FORMAT_JSON, 0);
+		unix_senders.push_back(new utils::networking_sender(unix_addresses[i], 0));
+	}
+	unix_clients.push_back(new utils::networking_client("127.0.0.1", 40132, true));
+	unix_clients.back()->register_channel("value", utils::FORMAT_JSON, 0);
+	unix_senders.push_back(new utils::networking_sender("127.0.0.1", 40132));
+	utils::io_reactor unix_reactor(unix_clients, 1);
+	utils::batch_sender unix_batch(unix_senders);
+	if(unix_reactor.start() != 0 || unix_batch.open_sockets() != 0){
+		return 1;
+	}
+	for(unsigned int i=0; i < unix_senders.size(); i++){
+		unix_senders[i]->add_data("value", 20.0f + i);
+	}
+	if(unix_batch.flush() != (int)unix_senders.size() || unix_batch.get_dropped() != 0){
+		std::cout << "[ERROR] Batch sender sent " << unix_batch.get_sent() << " and dropped "
+				  << unix_batch.get_dropped() << " messages to unix sockets." << std::endl;
+		errors++;
+	}
+	usleep(100000);
+	for(unsigned int i=0; i < unix_clients.size(); i++){
+		unix_clients[i]->store_message();
+		if(unix_clients[i]->get_slot_value(0) != 20.0f + i){
+			std::cout << "[ERROR] " << unix_clients[i]->get_ip() << " received " << unix_clients[i]->get_slot_value(0)
+					  << std::endl;
+			errors++;
+		}
+	}
+	unix_reactor.stop();
+	for(unsigned int i=0; i < unix_clients.size(); i++){
+		delete unix_clients[i];
+		delete unix_senders[i];
+	}
+	if(access("/tmp/cogna_io_reactor_test.sock", F_OK) == 0){
+		std::cout << "[ERROR] The unix socket file was not removed." << std::endl;
+		errors++;
+	}
+
+	if(errors == 0){
+		std::cout << "Io reactor works." << std::endl;
+	}
+	return errors;
+}
@@ -0,0 +1,76 @@
+#include "json_scanner.hpp"
+#include <iostream>
+#include <string>
+
+int check(utils::json_scanner &scanner, std::string message, bool valid, int key, bool contained, float value){
+	bool is_valid = scanner.scan(message.data(), message.size());
+	if(is_valid != valid || scanner.is_contained(key) != contained || (contained && scanner.get_value(key) != value)){
+		std::cout << "[ERROR] Wrong result for message " << message << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+int check_array(utils::json_scanner &scanner, std::string message, int key, int length, const float *values){
+	bool is_valid = scanner.scan(message.data(), message.size());
+	if(!is_valid || !scanner.is_contained(key) || scanner.get_length(key) != length){
+		std::cout << "[ERROR] Wrong result for message " << message << std::endl;
+		return 1;
+	}
+	for(int i=0; i < length; i++){
+		if(scanner.get_values(key)[i] != values[i]){
+			std::cout << "[ERROR] Wrong element " << i << " for message " << message << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int main(){
+	utils::json_scanner scanner;
+	int speed = scanner.add_key("speed");
+	int light = scanner.add_key("light");
+	int quoted = scanner.add_key("a\"b");
+	int errors = 0;
+
+	errors += check(scanner, "{\"speed\": 1.5, \"light\": 2}", true, speed, true, 1.5f);
+	errors += check(scanner, "{\"speed\": 1.5, \"light\": 2}", true, light, true, 2.0f);
+	errors += check(scanner, " {\"other\": {\"x\": [1, {\"y\": \"}\"}, []], \"z\": {}}, \"light\": -2.5e1}\n",
+					true, light, true, -25.0f);
+	errors += check(scanner, "{\"speed\": true}", true, speed, true, 1.0f);
+	errors += check(scanner, "{\"speed\": \"fast\"}", true, speed, false, 0.0f);
+	errors += check(scanner, "{\"speed\": 1, \"speed\": null}", true, speed, false, 0.0f);
+	errors += check(scanner, "{\"a\\\"b\": 3}", true, quoted, true, 3.0f);
+	errors += check(scanner, "{\"sp\\u0065ed\": 4}", true, speed, true, 4.0f);
+	errors += check(scanner, "{}", true, speed, false, 0.0f);
+	errors += check(scanner, "{\"speed\": 1.5, \"light\": 2", false, speed, false, 0.0f);
+	errors += check(scanner, "{\"speed\": 1.5}}", false, speed, false, 0.0f);
+	errors += check(scanner, "{\"speed\": 0x10}", false, speed, false, 0.0f);
+	errors += check(scanner, "{\"other\": [1, 2}, \"speed\": 1}", false, speed, false, 0.0f);
+	errors += check(scanner, "[1, 2]", false, speed, false, 0.0f);
+	errors += check(scanner, "hello", false, speed, false, 0.0f);
+	errors += check(scanner, "{\"speed\": [1, 2]}", true, speed, false, 0.0f);
+
+	int sensors = scanner.add_key("sensors", 3);
+	const float elements[] = {1.0f, -2.5f, 1.0f};
+	errors += check_array(scanner, "{\"sensors\": [1, -2.5, true], \"speed\": 2}", sensors, 3, elements);
+	errors += check_array(scanner, "{\"sensors\": [ 1 , -2.5 ]}", sensors, 2, elements);
+	errors += check_array(scanner, "{\"sensors\": [1, -2.5, 1, 7, 8]}", sensors, 3, elements);
+	errors += check_array(scanner, "{\"sensors\": []}", sensors, 0, elements);
+	errors += check_array(scanner, "{\"sensors\": 1}", sensors, 1, elements);
+	errors += check(scanner, "{\"sensors\": [1, [2], 3], \"speed\": 2}", true, sensors, false, 0.0f);
+	errors += check(scanner, "{\"sensors\": [1, {\"x\": 2}], \"speed\": 2}", true, speed, true, 2.0f);
+	errors += check(scanner, "{\"sensors\": [1, 2,]}", false, sensors, false, 0.0f);
+	errors += check(scanner, "{\"sensors\": [1, 2}", false, sensors, false, 0.0f);
+	if(scanner.add_key("speed", 2) != speed){
+		std::cout << "[ERROR] Widening a key changed its index." << std::endl;
+		errors++;
+	}
+	const float speeds[] = {4.0f, 5.0f};
+	errors += check_array(scanner, "{\"speed\": [4, 5]}", speed, 2, speeds);
+
+	if(errors == 0){
+		std::cout << "Json scanner works." << std::endl;
+	}
+	return errors;
+}
@@ -0,0 +1,78 @@
+#include "latency_histogram.hpp"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+int errors = 0;
+
+/**
+ * Compares a value of the histogram with the expected one.
+ */
+void expect(const char *name, long long value, long long expected){
+	if(value != expected){
+		std::cout << "[ERROR] " << name << " is " << value << " instead of " << expected << "." << std::endl;
+		errors++;
+	}
+}
+
+int main(){
+	utils::latency_histogram histogram;
+	expect("Empty count", histogram.get_count(), 0);
+	expect("Empty p50", histogram.get_percentile(0.5), 0);
+	expect("Empty mean", histogram.get_mean(), 0);
+
+	// Bucket b holds the latencies below 2^b, percentiles report that bound but never more than the maximum.
+	histogram.record(0);
+	expect("p50 of 0", histogram.get_percentile(0.5), 0);
+	histogram.record(-5);
+	expect("Negative latency count", histogram.get_count(), 2);
+	expect("Negative latency max", histogram.get_max(), 0);
+	histogram.clear();
+	histogram.record(1024);
+	histogram.record(1023);
+	expect("p0 of 1023 and 1024", histogram.get_percentile(0.0), 1024);
+	expect("p99 of 1023 and 1024", histogram.get_percentile(0.99), 1024);
+	histogram.record(1025);
+	expect("p99 of 1023 to 1025", histogram.get_percentile(0.99), 1025);
+	histogram.record((long long)1 << 50);
+	expect("p100 above the last bucket", histogram.get_percentile(1.0), (long long)1 << 50);
+	histogram.clear();
+	expect("Cleared count", histogram.get_count(), 0);
+	expect("Cleared max", histogram.get_max(), 0);
+
+	for(int latency=1; latency <= 1000; latency++){
+		histogram.record(latency);
+	}
+	expect("Count", histogram.get_count(), 1000);
+	expect("Mean", histogram.get_mean(), 500);
+	expect("Max", histogram.get_max(), 1000);
+	expect("p50", histogram.get_percentile(0.5), 512);
+	expect("p10", histogram.get_percentile(0.1), 128);
+	expect("p99", histogram.get_percentile(0.99), 1000);
+
+	// Every percentile lies within a factor of two above the exact one.
+	histogram.clear();
+	std::vector<long long> latencies;
+	srand(3);
+	for(int i=0; i < 10000; i++){
+		latencies.push_back((long long)rand() % 5000000);
+		histogram.record(latencies.back());
+	}
+	std::sort(latencies.begin(), latencies.end());
+	const double percentiles[] = {0.01, 0.25, 0.5, 0.9, 0.99, 0.999};
+	for(int i=0; i < 6; i++){
+		long long exact = latencies[(size_t)(percentiles[i] * latencies.size())];
+		long long reported = histogram.get_percentile(percentiles[i]);
+		if(reported <= exact || reported > 2 * exact + 1){
+			std::cout << "[ERROR] p" << percentiles[i] * 100 << " is " << reported << ", the exact one is " << exact
+					  << "." << std::endl;
+			errors++;
+		}
+	}
+
+	if(errors == 0){
+		std::cout << "Latency histogram works." << std::endl;
+	}
+	return errors;
+}
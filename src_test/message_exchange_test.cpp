@@ -0,0 +1,123 @@
+#include "message_exchange.hpp"
+#include <iostream>
+#include <string>
+#include <thread>
+
+const int MESSAGE_NUMBER = 200000;
+
+/**
+ * Publishes numbered messages, whose payload repeats the number many times, so that torn messages can be detected.
+ */
+void produce(utils::message_exchange *exchange){
+	std::string message;
+	for(int i=1; i <= MESSAGE_NUMBER; i++){
+		message.clear();
+		for(int j=0; j < 32; j++){
+			message += std::to_string(i) + ",";
+		}
+		while(!exchange->publish(message.data(), message.size())){
+			std::this_thread::yield();
+		}
+	}
+}
+
+int check_message(const std::string *message, int *previous){
+	size_t end = message->find(',');
+	int number = std::stoi(message->substr(0, end));
+	std::string expected;
+	for(int j=0; j < 32; j++){
+		expected += std::to_string(number) + ",";
+	}
+
+	if(*message != expected){
+		std::cout << "[ERROR] Torn message " << number << "." << std::endl;
+		return 1;
+	}
+	if(number <= *previous){
+		std::cout << "[ERROR] Message " << number << " received after " << *previous << "." << std::endl;
+		return 1;
+	}
+	*previous = number;
+	return 0;
+}
+
+int test_policy(int policy){
+	utils::message_exchange exchange(policy, 16);
+	std::thread producer(produce, &exchange);
+	int previous = 0;
+	int received = 0;
+	int errors = 0;
+
+	while(previous < MESSAGE_NUMBER && errors == 0){
+		const utils::exchange_message *message = exchange.consume();
+		while(message != nullptr && errors == 0){
+			int last = previous;
+			errors += check_message(&message->data, &previous);
+			if(policy == utils::EXCHANGE_QUEUE && previous != last + 1){
+				std::cout << "[ERROR] Queue skipped messages after " << last << "." << std::endl;
+				errors++;
+			}
+			received++;
+			message = exchange.consume();
+		}
+	}
+
+	producer.join();
+	std::cout << "Received " << received << " of " << MESSAGE_NUMBER << " messages." << std::endl;
+	return errors;
+}
+
+/**
+ * Consumes up to a snapshot of the queue while more messages are published.
+ */
+int test_published_limit(){
+	utils::message_exchange exchange(utils::EXCHANGE_QUEUE, 16);
+	int errors = 0;
+	for(int i=0; i < 3; i++){
+		exchange.publish("before", 6);
+	}
+	size_t published = exchange.get_published();
+	exchange.publish("after", 5);
+
+	int before = 0;
+	const utils::exchange_message *message = exchange.consume(published);
+	while(message != nullptr){
+		if(message->data != "before"){
+			std::cout << "[ERROR] Message <" << message->data << "> was published after the snapshot." << std::endl;
+			errors++;
+		}
+		before++;
+		exchange.publish("after", 5);
+		message = exchange.consume(published);
+	}
+	if(before != 3 || published != 3){
+		std::cout << "[ERROR] Consumed " << before << " of " << published << " messages before the snapshot." << std::endl;
+		errors++;
+	}
+
+	int after = 0;
+	for(message = exchange.consume(); message != nullptr; message = exchange.consume()){
+		after++;
+	}
+	if(after != 4){
+		std::cout << "[ERROR] Only " << after << " of 4 messages after the snapshot were kept." << std::endl;
+		errors++;
+	}
+	return errors;
+}
+
+int main(){
+	int errors = 0;
+
+	std::cout << "Testing latest policy." << std::endl;
+	errors += test_policy(utils::EXCHANGE_LATEST);
+	std::cout << "Testing queue policy." << std::endl;
+	errors += test_policy(utils::EXCHANGE_QUEUE);
+	std::cout << "Testing consuming up to a snapshot." << std::endl;
+	errors += test_published_limit();
+
+	if(errors == 0){
+		std::cout << "Message exchange works." << std::endl;
+	}
+	return errors;
+}
@@ -0,0 +1,117 @@
+#include "NeuralNetwork.hpp"
+#include "Constants.hpp"
+#include <iostream>
+#include <vector>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace COGNA;
+
+const int NEURON_NUMBER = 12;
+const int STEP_NUMBER = 200;
+const int INPUTS[] = {1, 4, 7};
+const int INPUT_NUMBER = 3;
+
+/**
+ * @brief Builds the same network with the IDs of the network file, renumbered or not.
+ *
+ * Every neuron n is connected to the neurons 5n and 7n modulo the neuron number, so that
+ * renumbering moves the neurons apart from their file IDs.
+ */
+static NeuralNetwork *build_network(int ordering){
+    NeuralNetwork *nn = new NeuralNetwork();
+    for(int n=1; n <= NEURON_NUMBER; n++){
+        nn->add_neuron(1.0f);
+    }
+    for(int n=1; n <= NEURON_NUMBER; n++){
+        nn->add_neuron_connection(n, (n * 5) % NEURON_NUMBER + 1, 0.7f, EXCITATORY, FUNCTION_RELU, LEARNING_NONE);
+        if((n * 7) % NEURON_NUMBER + 1 != (n * 5) % NEURON_NUMBER + 1){
+            nn->add_neuron_connection(n, (n * 7) % NEURON_NUMBER + 1, 0.5f, (n % 3 == 0) ? INHIBITORY : EXCITATORY,
+                                      FUNCTION_RELU, LEARNING_NONE);
+        }
+    }
+    nn->set_random_neuron_activation(10, 200, 2.0f);
+    nn->set_random_seed(5);
+    nn->reorder_neurons(ordering);
+    nn->setup_network();
+    return nn;
+}
+
+int main(){
+    int errors = 0;
+
+    NeuralNetwork *original = build_network(NEURON_ORDERING_NONE);
+    NeuralNetwork *renumbered = build_network(NEURON_ORDERING_RCM);
+    // Networks are found in the list by their ID
+    std::vector<NeuralNetwork*> network_list = {original, renumbered};
+    if(original->_id != 0 || renumbered->_id != 1){
+        std::cout << "[ERROR] Networks must be the first of the process." << std::endl;
+        return 1;
+    }
+
+    // Every neuron is still found by its file ID
+    int moved_neurons = 0;
+    for(int n=1; n <= NEURON_NUMBER; n++){
+        Neuron *neuron = renumbered->get_neuron(n);
+        if(neuron == NULL || neuron->_json_id != n){
+            std::cout << "[ERROR] Neuron with file ID " << n << " was not found." << std::endl;
+            errors++;
+        }
+        else if(neuron->_id != n){
+            moved_neurons++;
+        }
+    }
+    std::cout << "Renumbered " << moved_neurons << " of " << NEURON_NUMBER << " neurons." << std::endl;
+    if(moved_neurons == 0){
+        std::cout << "[ERROR] Reordering did not renumber any neuron." << std::endl;
+        errors++;
+    }
+
+    // Both networks get the same inputs by file ID and show the same activity per file ID
+    int diverging_steps = 0;
+    int active_steps = 0;
+    fflush(stdout);
+    int output = dup(STDOUT_FILENO);
+    int silence = open("/dev/null", O_WRONLY);
+    dup2(silence, STDOUT_FILENO);
+    for(int step=0; step < STEP_NUMBER; step++){
+        if(step % 9 == 0){
+            original->init_activation(INPUTS[(step / 9) % INPUT_NUMBER], 1.5f);
+            renumbered->init_activation(INPUTS[(step / 9) % INPUT_NUMBER], 1.5f);
+        }
+        original->feed_forward(network_list);
+        renumbered->feed_forward(network_list);
+        bool is_diverging = false;
+        for(int n=1; n <= NEURON_NUMBER; n++){
+            is_diverging = is_diverging ||
+                           original->neuron_is_active(n) != renumbered->neuron_is_active(n) ||
+                           original->get_neuron_activation(n) != renumbered->get_neuron_activation(n);
+            active_steps += original->neuron_is_active(n) ? 1 : 0;
+        }
+        diverging_steps += is_diverging ? 1 : 0;
+    }
+    std::cout.flush();
+    fflush(stdout);
+    dup2(output, STDOUT_FILENO);
+    close(output);
+    close(silence);
+
+    std::cout << "Neurons were active " << active_steps << " times." << std::endl;
+    if(active_steps == 0){
+        std::cout << "[ERROR] The network did not fire." << std::endl;
+        errors++;
+    }
+    if(diverging_steps != 0){
+        std::cout << "[ERROR] Renumbered network diverged in " << diverging_steps << " steps." << std::endl;
+        errors++;
+    }
+
+    delete renumbered;
+    delete original;
+
+    if(errors == 0){
+        std::cout << "Neuron ordering works." << std::endl;
+    }
+    return errors;
+}
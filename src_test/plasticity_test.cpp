@@ -0,0 +1,183 @@
+#include "NeuralNetwork.hpp"
+#include "Constants.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace COGNA;
+
+const int STEP_NUMBER = 300;
+const float PATTERN[] = {0.0f, 1.0f, 3.0f, 6.0f, 0.7f, 9.0f, 2.5f};
+const int PATTERN_LENGTH = 7;
+
+/**
+ * @brief Builds a small network whose learning connections are fired and conditioned by input neurons only.
+ *
+ * Neurons 1, 3 and 5 receive the inputs. The connection 1~2 learns by itself and is conditioned
+ * by 3 and 5, the other connections learn by themselves.
+ */
+static NeuralNetwork *build_network(bool is_deferring){
+    NeuralNetwork *nn = new NeuralNetwork();
+    nn->_parameter->short_habituation_curvature = 0.65f;
+    nn->_parameter->short_habituation_steepness = 0.07f;
+    nn->_parameter->short_sensitization_curvature = 0.65f;
+    nn->_parameter->short_sensitization_steepness = 0.07f;
+    nn->_parameter->long_habituation_curvature = 0.35f;
+    nn->_parameter->long_habituation_steepness = 0.005f;
+    nn->_parameter->long_sensitization_curvature = 1.02f;
+    nn->_parameter->long_sensitization_steepness = 0.01f;
+    nn->_parameter->short_dehabituation_curvature = 1.00f;
+    nn->_parameter->short_dehabituation_steepness = 0.0005f;
+    nn->_parameter->short_desensitization_curvature = 1.00f;
+    nn->_parameter->short_desensitization_steepness = 0.0005f;
+    nn->_parameter->long_dehabituation_curvature = 1.00f;
+    nn->_parameter->long_dehabituation_steepness = 0.00001f;
+    nn->_parameter->long_desensitization_curvature = 1.00f;
+    nn->_parameter->long_desensitization_steepness = 0.00001f;
+    nn->_parameter->presynaptic_potential_curvature = 0.60f;
+    nn->_parameter->presynaptic_potential_steepness = 0.3f;
+    nn->_parameter->presynaptic_backfall_curvature = 1.00f;
+    nn->_parameter->presynaptic_backfall_steepness = 0.0002f;
+    nn->_parameter->long_learning_weight_reduction_curvature = 0.5f;
+    nn->_parameter->long_learning_weight_reduction_steepness = 0.05f;
+    nn->_parameter->long_learning_weight_backfall_curvature = 1.0f;
+    nn->_parameter->long_learning_weight_backfall_steepness = 0.0006f;
+    nn->_parameter->habituation_threshold = 2.0f;
+    nn->_parameter->sensitization_threshold = 5.0f;
+    for(int i=1; i <= 6; i++){
+        nn->add_neuron((i % 2 == 1) ? 0.5f : 100.0f);
+    }
+    nn->add_neuron_connection(1, 2, 1.0f, EXCITATORY, FUNCTION_RELU, LEARNING_HABISENS);
+    nn->add_synaptic_connection(3, 1, 2, 1.0f, EXCITATORY, FUNCTION_RELU, LEARNING_NONE);
+    nn->add_synaptic_connection(5, 1, 2, 1.0f, INHIBITORY, FUNCTION_RELU, LEARNING_NONE);
+    nn->add_neuron_connection(1, 4, 0.8f, EXCITATORY, FUNCTION_RELU, LEARNING_HABITUATION);
+    nn->add_neuron_connection(3, 6, 0.6f, EXCITATORY, FUNCTION_RELU, LEARNING_SENSITIZATION);
+    nn->add_neuron_connection(5, 6, 0.5f, EXCITATORY, FUNCTION_RELU, LEARNING_HABISENS);
+    nn->set_deferred_plasticity(is_deferring);
+    nn->setup_network();
+    return nn;
+}
+
+/**
+ * @brief Compares the weights of all connections of two networks built the same way.
+ *
+ * @return The number of connections with different weights.
+ */
+static int compare_weights(NeuralNetwork *deferred, NeuralNetwork *immediate){
+    int errors = 0;
+    for(unsigned int con=0; con < deferred->_connections.size(); con++){
+        Connection *a = deferred->_connections[con];
+        Connection *b = immediate->_connections[con];
+        if(std::fabs((float)a->short_weight - (float)b->short_weight) > 1e-6f ||
+           std::fabs((float)a->long_weight - (float)b->long_weight) > 1e-6f ||
+           std::fabs((float)a->long_learning_weight - (float)b->long_learning_weight) > 1e-6f){
+            std::cout << "[ERROR] Connection of N-" << a->prev_neuron->_id << " learned short " << (float)a->short_weight
+                      << " long " << (float)a->long_weight << " deferred, but short " << (float)b->short_weight
+                      << " long " << (float)b->long_weight << " immediately." << std::endl;
+            errors++;
+        }
+    }
+    return errors;
+}
+
+int main(){
+    int errors = 0;
+
+    NeuralNetwork *deferred = build_network(true);
+    NeuralNetwork *immediate = build_network(false);
+    // Neuron 1 fires in every step and is conditioned by 3 and 5 in some of them
+    NeuralNetwork *conditioned_deferred = build_network(true);
+    NeuralNetwork *conditioned_immediate = build_network(false);
+    NeuralNetwork *unconditioned = build_network(true);
+    // Networks are found in the list by their ID
+    std::vector<NeuralNetwork*> network_list = {deferred, immediate, conditioned_deferred, conditioned_immediate,
+                                                unconditioned};
+    for(unsigned int net=0; net < network_list.size(); net++){
+        if(network_list[net]->_id != (int)net){
+            std::cout << "[ERROR] Networks must be the first of the process." << std::endl;
+            return 1;
+        }
+    }
+
+    // The networks print every firing, which is silenced while stepping
+    fflush(stdout);
+    int output = dup(STDOUT_FILENO);
+    int silence = open("/dev/null", O_WRONLY);
+    dup2(silence, STDOUT_FILENO);
+    for(int step=0; step < STEP_NUMBER; step++){
+        float inputs[3] = {PATTERN[step % PATTERN_LENGTH],
+                           PATTERN[(step * 3 + 1) % PATTERN_LENGTH],
+                           PATTERN[(step * 5 + 2) % PATTERN_LENGTH]};
+        for(int i=0; i < 3; i++){
+            if(inputs[i] > 0.0f){
+                deferred->init_activation(2 * i + 1, inputs[i]);
+                immediate->init_activation(2 * i + 1, inputs[i]);
+            }
+        }
+        deferred->feed_forward(network_list);
+        immediate->feed_forward(network_list);
+
+        // Below both thresholds, so 1~2 only sensitizes when 3 conditions it and habituates when 5 does
+        float conditioned_inputs[3] = {1.0f, (step % 2 == 0) ? 3.0f : 0.0f, (step % 3 == 0) ? 4.0f : 0.0f};
+        for(int i=0; i < 3; i++){
+            if(conditioned_inputs[i] > 0.0f){
+                conditioned_deferred->init_activation(2 * i + 1, conditioned_inputs[i]);
+                conditioned_immediate->init_activation(2 * i + 1, conditioned_inputs[i]);
+            }
+        }
+        unconditioned->init_activation(1, conditioned_inputs[0]);
+        conditioned_deferred->feed_forward(network_list);
+        conditioned_immediate->feed_forward(network_list);
+        unconditioned->feed_forward(network_list);
+    }
+    std::cout.flush();
+    fflush(stdout);
+    dup2(output, STDOUT_FILENO);
+    close(output);
+    close(silence);
+
+    // Learning in batches after the step gives the same weights as learning while firing
+    errors += compare_weights(deferred, immediate);
+    int changed_weights = 0;
+    for(unsigned int con=0; con < deferred->_connections.size(); con++){
+        if((float)deferred->_connections[con]->short_weight != (float)deferred->_connections[con]->base_weight){
+            changed_weights++;
+        }
+    }
+    std::cout << "Learned " << changed_weights << " of " << deferred->_connections.size() << " weights." << std::endl;
+    if(changed_weights < 4){
+        std::cout << "[ERROR] The learning connections did not learn." << std::endl;
+        errors++;
+    }
+
+    // Conditioning events are recorded for 1~2 in the same steps it fires itself and are batched with them
+    errors += compare_weights(conditioned_deferred, conditioned_immediate);
+    Connection *conditioned_connection = conditioned_deferred->_connections[0];
+    Connection *unconditioned_connection = unconditioned->_connections[0];
+    if(conditioned_connection->next_neuron == nullptr || conditioned_connection->next_neuron->_id != 2){
+        std::cout << "[ERROR] The first connection is not 1~2." << std::endl;
+        errors++;
+    }
+    else{
+        std::cout << "Conditioned weight " << (float)conditioned_connection->short_weight << ", unconditioned weight "
+                  << (float)unconditioned_connection->short_weight << "." << std::endl;
+        if(std::fabs((float)conditioned_connection->short_weight - (float)unconditioned_connection->short_weight) < 1e-3f){
+            std::cout << "[ERROR] Conditioning did not change the learning of 1~2." << std::endl;
+            errors++;
+        }
+    }
+
+    delete unconditioned;
+    delete conditioned_immediate;
+    delete conditioned_deferred;
+    delete immediate;
+    delete deferred;
+
+    if(errors == 0){
+        std::cout << "Deferred plasticity works." << std::endl;
+    }
+    return errors;
+}
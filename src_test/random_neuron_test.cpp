@@ -0,0 +1,120 @@
+#include "NeuralNetwork.hpp"
+#include "RandomGenerator.hpp"
+#include "Constants.hpp"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace COGNA;
+
+const int STEP_NUMBER = 50000;
+const int CHANCES[] = {10, 100, 500};
+const int RANDOM_NEURON_NUMBER = 3;
+
+/**
+ * @brief Builds a network of unconnected random neurons, one per chance.
+ */
+static NeuralNetwork *build_network(uint64_t seed){
+    NeuralNetwork *nn = new NeuralNetwork();
+    for(int i=0; i < RANDOM_NEURON_NUMBER; i++){
+        nn->add_neuron(1.0f);
+        nn->set_random_neuron_activation(i + MIN_NEURON_ID, CHANCES[i], 2.0f);
+    }
+    nn->set_random_seed(seed);
+    nn->setup_network();
+    return nn;
+}
+
+int main(){
+    int errors = 0;
+
+    // Equal seeds give equal sequences, different seeds do not.
+    RandomGenerator first(42), second(42), other(43);
+    bool is_equal = true, is_other = false;
+    for(int i=0; i < 1000; i++){
+        uint64_t value = first.next();
+        is_equal = is_equal && value == second.next();
+        is_other = is_other || value != other.next();
+    }
+    if(!is_equal || !is_other){
+        std::cout << "[ERROR] Random generator is not deterministic per seed." << std::endl;
+        errors++;
+    }
+
+    // The skips of a bernoulli experiment with chance p are 1/p long on average.
+    double probability = 0.05;
+    double sum = 0.0;
+    for(int i=0; i < 100000; i++){
+        int64_t skip = first.next_geometric(probability);
+        if(skip < 1){
+            std::cout << "[ERROR] Geometric skip " << skip << " is below 1." << std::endl;
+            errors++;
+            break;
+        }
+        sum += skip;
+    }
+    if(std::fabs(sum / 100000 - 1.0 / probability) > 0.02 / probability){
+        std::cout << "[ERROR] Mean geometric skip is " << sum / 100000 << " instead of " << 1.0 / probability << std::endl;
+        errors++;
+    }
+
+    // Random neurons fire with their chance per step, and networks with the same seed fire in the same steps.
+    NeuralNetwork *nn = build_network(7);
+    NeuralNetwork *twin = build_network(7);
+    // Networks are found in the list by their ID
+    std::vector<NeuralNetwork*> network_list = {nn, twin};
+    if(nn->_id != 0 || twin->_id != 1){
+        std::cout << "[ERROR] Networks must be the first of the process." << std::endl;
+        return 1;
+    }
+
+    int firings[RANDOM_NEURON_NUMBER] = {0, 0, 0};
+    int diverging_steps = 0;
+    // The networks print every firing, which is silenced while stepping
+    fflush(stdout);
+    int output = dup(STDOUT_FILENO);
+    int silence = open("/dev/null", O_WRONLY);
+    dup2(silence, STDOUT_FILENO);
+    for(int step=0; step < STEP_NUMBER; step++){
+        nn->feed_forward(network_list);
+        twin->feed_forward(network_list);
+        for(int i=0; i < RANDOM_NEURON_NUMBER; i++){
+            bool is_fired = nn->get_neuron(i + MIN_NEURON_ID)->_last_fired_step == nn->get_step_count();
+            bool is_twin_fired = twin->get_neuron(i + MIN_NEURON_ID)->_last_fired_step == twin->get_step_count();
+            firings[i] += is_fired ? 1 : 0;
+            diverging_steps += (is_fired != is_twin_fired) ? 1 : 0;
+        }
+    }
+    std::cout.flush();
+    fflush(stdout);
+    dup2(output, STDOUT_FILENO);
+    close(output);
+    close(silence);
+
+    for(int i=0; i < RANDOM_NEURON_NUMBER; i++){
+        double chance = (double)CHANCES[i] / MAX_CHANCE;
+        double expected = STEP_NUMBER * chance;
+        double deviation = std::sqrt(STEP_NUMBER * chance * (1.0 - chance));
+        std::cout << "Neuron with chance " << chance << " fired " << firings[i] << " times, expected "
+                  << expected << "." << std::endl;
+        if(std::fabs(firings[i] - expected) > 5.0 * deviation){
+            std::cout << "[ERROR] Firing rate does not match the chance." << std::endl;
+            errors++;
+        }
+    }
+    if(diverging_steps != 0){
+        std::cout << "[ERROR] Networks with the same seed diverged in " << diverging_steps << " steps." << std::endl;
+        errors++;
+    }
+
+    delete twin;
+    delete nn;
+
+    if(errors == 0){
+        std::cout << "Random neurons work." << std::endl;
+    }
+    return errors;
+}
@@ -0,0 +1,165 @@
+#include "networking_sender.hpp"
+#include "aligned_allocator.hpp"
+#include "json.hpp"
+#include <iostream>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int THREAD_NUMBER = 4;
+const int TICK_NUMBER = 1000;
+const int ADDS_PER_TICK = 100;
+
+/**
+ * Adds 1 to its writer ADDS_PER_TICK times, like a network worker adding to its output nodes.
+ */
+void write_tick(utils::networking_sender *sender, int writer){
+	for(int i=0; i < ADDS_PER_TICK; i++){
+		sender->add_writer_data(writer, 1.0f);
+	}
+}
+
+/**
+ * Checks that the payloads written from the json template are exactly what serializing the json object gives.
+ */
+int check_serialization(){
+	const int VALUE_NUMBER = 8;
+	float values[VALUE_NUMBER] = {0.0f, 2.5e10f, 1.0f, 0.1f, -3.75f, 1e-7f, 123456.789f,
+								  std::numeric_limits<float>::infinity()};
+	utils::networking_sender sender("127.0.0.1", 40003);
+	int motor = sender.register_channel("motor", 0);
+	int arm = sender.register_channel("arm \"left\"", 1);
+	int twice = sender.register_channel("motor", 2);
+
+	int errors = 0;
+	for(int i=0; i < VALUE_NUMBER; i++){
+		nlohmann::json expected;
+		sender.add_slot_data(motor, values[i]);
+		expected["motor"] = values[i];
+		if(i % 2 == 0){
+			sender.add_slot_data(twice, 0.5f);
+			expected["motor"] = (float)expected["motor"] + 0.5f;
+			sender.add_slot_data(arm, values[VALUE_NUMBER - 1 - i]);
+			expected["arm \"left\""] = values[VALUE_NUMBER - 1 - i];
+		}
+		expected["time"] = (long long)(1000 + i);
+
+		std::string sent = sender.serialize_payload(1000000000LL + i * 1000000LL);
+		if(sent != expected.dump()){
+			std::cout << "[ERROR] Sent " << sent << " instead of " << expected.dump() << std::endl;
+			errors++;
+		}
+	}
+
+	// Data added by key is serialized together with the channels
+	nlohmann::json expected = {{"extra", 2}, {"motor", 1.5f}, {"time", 2000}};
+	sender.add_data("extra", 2);
+	sender.add_slot_data(motor, 1.5f);
+	std::string sent = sender.serialize_payload(2000000000LL);
+	if(sent != expected.dump()){
+		std::cout << "[ERROR] Sent " << sent << " instead of " << expected.dump() << std::endl;
+		errors++;
+	}
+
+	// Deltas carry a sequence and all but keyframes are marked
+	utils::networking_sender delta_sender("127.0.0.1", 40003);
+	delta_sender.set_delta_mode(0.0f, 3);
+	int delta_motor = delta_sender.register_channel("motor", 0);
+	for(int i=0; i < VALUE_NUMBER; i++){
+		nlohmann::json expected_delta = {{"motor", i + 0.25f}, {"time", 3000 + i}, {"sequence", i}};
+		if(i % 3 != 0){
+			expected_delta["delta"] = true;
+		}
+		delta_sender.add_slot_data(delta_motor, i + 0.25f);
+		std::string sent_delta = delta_sender.serialize_payload(3000000000LL + i * 1000000LL);
+		if(sent_delta != expected_delta.dump()){
+			std::cout << "[ERROR] Sent " << sent_delta << " instead of " << expected_delta.dump() << std::endl;
+			errors++;
+		}
+	}
+
+	// Outputs answering a request echo its sequence number until it is reset
+	utils::networking_sender reply_sender("127.0.0.1", 40003);
+	int reply_motor = reply_sender.register_channel("motor", 0);
+	for(int i=0; i < 3; i++){
+		nlohmann::json expected_reply = {{"motor", 1.0f}, {"time", 4000 + i}};
+		if(i < 2){
+			expected_reply["reply"] = 4294967301LL + i;
+			reply_sender.set_reply_sequence(4294967301LL + i);
+		}
+		else{
+			reply_sender.set_reply_sequence(-1);
+		}
+		reply_sender.add_slot_data(reply_motor, 1.0f);
+		std::string sent_reply = reply_sender.serialize_payload(4000000000LL + i * 1000000LL);
+		if(sent_reply != expected_reply.dump()){
+			std::cout << "[ERROR] Sent " << sent_reply << " instead of " << expected_reply.dump() << std::endl;
+			errors++;
+		}
+	}
+	return errors;
+}
+
+/**
+ * A buffer like the one of a writer, which must start its own cache line.
+ */
+struct alignas(64) line_buffer{
+	float value;
+};
+
+/**
+ * Checks that the allocator of the writer buffers keeps every element on its own cache line, even after growing.
+ */
+int check_alignment(){
+	std::vector<line_buffer, utils::aligned_allocator<line_buffer>> buffers;
+	for(int i=0; i < 33; i++){
+		buffers.push_back(line_buffer());
+		for(unsigned int b=0; b < buffers.size(); b++){
+			if((uintptr_t)&buffers[b] % 64 != 0){
+				std::cout << "[ERROR] Buffer " << b << " of " << buffers.size() << " is not aligned to a cache line."
+						  << std::endl;
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+int main(){
+	utils::networking_sender sender("127.0.0.1", 40003);
+	int shared = sender.register_channel("shared", 0);
+	int single = sender.register_channel("single", 1);
+
+	// All threads but the last one write to the same channel, whose values are summed up
+	std::vector<int> writers;
+	for(int i=0; i < THREAD_NUMBER; i++){
+		writers.push_back(sender.register_writer(i < THREAD_NUMBER - 1 ? shared : single));
+	}
+
+	int errors = 0;
+	for(int tick=0; tick < TICK_NUMBER && errors == 0; tick++){
+		std::vector<std::thread> threads;
+		for(int i=0; i < THREAD_NUMBER; i++){
+			threads.push_back(std::thread(write_tick, &sender, writers[i]));
+		}
+		for(int i=0; i < THREAD_NUMBER; i++){
+			threads[i].join();
+		}
+
+		nlohmann::json payload = nlohmann::json::parse(sender.serialize_payload(0));
+		if((float)payload["shared"] != (THREAD_NUMBER - 1) * ADDS_PER_TICK || (float)payload["single"] != ADDS_PER_TICK){
+			std::cout << "[ERROR] Tick " << tick << " sent " << payload.dump() << std::endl;
+			errors++;
+		}
+	}
+
+	errors += check_serialization();
+	errors += check_alignment();
+
+	if(errors == 0){
+		std::cout << "Sender writers work." << std::endl;
+	}
+	return errors;
+}
@@ -0,0 +1,69 @@
+#include "shm_ring.hpp"
+#include "json_scanner.hpp"
+#include <iostream>
+#include <string>
+
+/**
+ * Reads the messages of shm_writer_test from a shared memory ring and checks them.
+ *
+ * Usage: shm_reader_test [name] [count] [timeout_ms] [print]
+ * Stops after the message with sequence count-1 or when nothing arrives for timeout_ms.
+ * Every message must be complete and newer than the previous one, and every message
+ * must either be read or be counted as lost. With print, the messages are printed instead.
+ */
+int main(int argc, char **argv){
+	std::string name = argc > 1 ? argv[1] : "/cogna_shm_test";
+	int count = argc > 2 ? std::stoi(argv[2]) : 1000;
+	int timeout_ms = argc > 3 ? std::stoi(argv[3]) : 3000;
+	bool is_printing = argc > 4 && std::string(argv[4]) == "print";
+
+	utils::shm_ring ring;
+	if(ring.open(name) != 0){
+		return 1;
+	}
+
+	utils::json_scanner scanner;
+	scanner.add_key("sequence");
+
+	std::string message;
+	int64_t timestamp = 0;
+	int received = 0;
+	int previous = -1;
+	int errors = 0;
+	while(previous < count - 1 && errors == 0){
+		if(!ring.read(message, &timestamp, false)){
+			if(!ring.wait(timeout_ms)){
+				std::cout << "[ERROR] Nothing arrived for " << timeout_ms << " ms." << std::endl;
+				errors++;
+			}
+			continue;
+		}
+
+		received++;
+		if(is_printing){
+			std::cout << message << std::endl;
+			previous = received - 1;
+			continue;
+		}
+
+		scanner.scan(message.data(), message.size());
+		int sequence = (int)scanner.get_value(0);
+		if(!scanner.is_contained(0) || sequence <= previous){
+			std::cout << "[ERROR] Message <" << message << "> read after sequence " << previous << "." << std::endl;
+			errors++;
+		}
+		previous = sequence;
+	}
+
+	if(errors == 0 && !is_printing && received + ring.get_lost() != (unsigned long long)count){
+		std::cout << "[ERROR] Read " << received << " and lost " << ring.get_lost() << " of " << count << " messages." << std::endl;
+		errors++;
+	}
+
+	std::cout << "Read " << received << " messages, lost " << ring.get_lost() << "." << std::endl;
+	utils::shm_ring::unlink(name);
+	if(errors == 0){
+		std::cout << "Shared memory ring works." << std::endl;
+	}
+	return errors;
+}
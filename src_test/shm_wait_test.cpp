@@ -0,0 +1,84 @@
+#include "shm_ring.hpp"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <csignal>
+#include <pthread.h>
+
+/**
+ * Does nothing, but interrupts the futex the reader sleeps on.
+ */
+void interrupt(int){
+}
+
+/**
+ * Waits on the ring in another thread while it is interrupted, and checks when and how the wait ended.
+ */
+int check_wait(utils::shm_ring *writer, utils::shm_ring *reader, int timeout_ms, int write_after_ms, bool expected){
+	std::atomic<bool> is_done(false);
+	bool result = !expected;
+	long long waited_ms = 0;
+	std::thread waiting([&](){
+		auto begin = std::chrono::steady_clock::now();
+		result = reader->wait(timeout_ms);
+		waited_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+		is_done = true;
+	});
+
+	auto begin = std::chrono::steady_clock::now();
+	bool is_written = false;
+	while(!is_done){
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		long long elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin).count();
+		if(write_after_ms >= 0 && elapsed_ms >= write_after_ms && !is_written){
+			writer->write("{}", 2, 0);
+			is_written = true;
+		}
+		else if(!is_done){
+			pthread_kill(waiting.native_handle(), SIGUSR1);
+		}
+	}
+	waiting.join();
+
+	int minimum_ms = write_after_ms >= 0 ? write_after_ms : timeout_ms;
+	std::cout << "Wait returned " << result << " after " << waited_ms << " ms." << std::endl;
+	if(result != expected || waited_ms < minimum_ms - 5 || waited_ms > minimum_ms + 500){
+		std::cout << "[ERROR] Expected " << expected << " after " << minimum_ms << " ms." << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+int main(){
+	std::string name = "/cogna_shm_wait_test";
+	utils::shm_ring::unlink(name);
+
+	struct sigaction action = {};
+	action.sa_handler = interrupt;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = 0;
+	sigaction(SIGUSR1, &action, nullptr);
+
+	utils::shm_ring writer, reader;
+	if(writer.open(name, 64, 16) != 0 || reader.open(name) != 0){
+		return 1;
+	}
+
+	int errors = 0;
+	// Interrupted waits go on sleeping until a message arrives or the time is up
+	errors += check_wait(&writer, &reader, 2000, 300, true);
+	std::string message;
+	if(!reader.read(message, nullptr, false) || message != "{}"){
+		std::cout << "[ERROR] The awaited message could not be read." << std::endl;
+		errors++;
+	}
+	errors += check_wait(&writer, &reader, 300, -1, false);
+
+	utils::shm_ring::unlink(name);
+	if(errors == 0){
+		std::cout << "Waiting on the shared memory ring works." << std::endl;
+	}
+	return errors;
+}
@@ -0,0 +1,36 @@
+#include "shm_ring.hpp"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+
+/**
+ * Writes messages into a shared memory ring.
+ *
+ * Usage: shm_writer_test [name] [count] [interval_us] [message]
+ * Without a message, the json {"sequence":<number>} is written, starting with number 0.
+ */
+int main(int argc, char **argv){
+	std::string name = argc > 1 ? argv[1] : "/cogna_shm_test";
+	int count = argc > 2 ? std::stoi(argv[2]) : 1000;
+	int interval_us = argc > 3 ? std::stoi(argv[3]) : 0;
+	std::string message = argc > 4 ? argv[4] : "";
+
+	utils::shm_ring ring;
+	if(ring.open(name) != 0){
+		return 1;
+	}
+
+	std::string payload;
+	for(int i=0; i < count; i++){
+		payload = message.empty() ? "{\"sequence\":" + std::to_string(i) + "}" : message;
+		auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		ring.write(payload.data(), payload.size(), (int64_t)now);
+		if(interval_us > 0){
+			std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+		}
+	}
+
+	std::cout << "Wrote " << count - ring.get_dropped() << " messages into " << name << "." << std::endl;
+	return 0;
+}
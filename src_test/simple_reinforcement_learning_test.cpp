@@ -178,16 +178,16 @@ int main(){
                 printf("Machine 1 was triggered and COGNA was ");
                 if(temp_result == POSITIVE_RESULT) printf("rewarded    :)\n");
                 else printf("punished    :(\n");
-                printf("Weight machine 0 = %.5f\n", machine_connection[0]->short_weight);
-                printf("Weight machine 1 = %.5f\n\n", machine_connection[1]->short_weight);
+                printf("Weight machine 0 = %.5f\n", (float)machine_connection[0]->short_weight);
+                printf("Weight machine 1 = %.5f\n\n", (float)machine_connection[1]->short_weight);
             }
             if(nn->neuron_is_active(15)){
                 temp_result = env.try_machine(1);
                 printf("Machine 2 was triggered and COGNA was ");
                 if(temp_result == POSITIVE_RESULT) printf("rewarded    :)\n");
                 else printf("punished    :(\n");
-                printf("Weight machine 0 = %.5f\n", machine_connection[0]->short_weight);
-                printf("Weight machine 1 = %.5f\n\n", machine_connection[1]->short_weight);
+                printf("Weight machine 0 = %.5f\n", (float)machine_connection[0]->short_weight);
+                printf("Weight machine 1 = %.5f\n\n", (float)machine_connection[1]->short_weight);
             }
 
             switch(temp_result){
@@ -230,8 +230,8 @@ int main(){
         }
     }
     printf("\n");
-    printf("Weight machine 0 = %.5f\n", machine_connection[0]->short_weight);
-    printf("Weight machine 1 = %.5f\n", machine_connection[1]->short_weight);
+    printf("Weight machine 0 = %.5f\n", (float)machine_connection[0]->short_weight);
+    printf("Weight machine 1 = %.5f\n", (float)machine_connection[1]->short_weight);
 
     delete nn;
     delete output_handler;
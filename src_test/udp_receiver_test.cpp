@@ -13,8 +13,8 @@ int main(){
 
 	utils::networking_client *json_worker = new utils::networking_client(ip, port, true);
 	utils::networking_client *hello_worker = new utils::networking_client(ip, 5006, false);
-	std::thread json_udp_thread(&utils::networking_client::receive_message, json_worker);
-	std::thread hello_udp_thread(&utils::networking_client::receive_message, hello_worker);
+	std::thread json_udp_thread(&utils::networking_client::receive_message, json_worker, 0);
+	std::thread hello_udp_thread(&utils::networking_client::receive_message, hello_worker, 0);
 	std::string temp_json;
 	std::string temp_string;
 	nlohmann::json j;
@@ -0,0 +1,262 @@
+#include "WeightStorage.hpp"
+#include "MathUtils.hpp"
+#include "Constants.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+using namespace COGNA;
+
+typedef CompactWeight<float_to_fp16, fp16_to_float> fp16_weight;
+typedef CompactWeight<float_to_bf16, bf16_to_float> bf16_weight;
+
+const int STEP_NUMBER = 20000;
+const float PATTERN[] = {0.0f, 1.0f, 3.0f, 6.0f, 0.7f, 9.0f, 2.5f, 0.0f, 0.0f, 4.0f, 12.0f};
+const int PATTERN_LENGTH = 11;
+
+static float bits_to_float(uint32_t bits){
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Checks the conversion of special values and of every value halfway between two half precision floats.
+ */
+static int check_fp16(){
+    int errors = 0;
+    const float INF = std::numeric_limits<float>::infinity();
+    struct { float value; uint16_t half; } cases[] = {
+        {1.0f, 0x3C00}, {-2.0f, 0xC000}, {-0.0f, 0x8000}, {65504.0f, 0x7BFF},
+        {65519.0f, 0x7BFF},                          // Below the halfway point to 65536
+        {65520.0f, 0x7C00},                          // Halfway, rounds to the even infinity
+        {1e10f, 0x7C00}, {-INF, 0xFC00}, {INF, 0x7C00},
+        {std::ldexp(1.0f, -14), 0x0400},             // Smallest normal
+        {std::ldexp(1023.0f, -24), 0x03FF},          // Largest denormal
+        {std::ldexp(1.0f, -24), 0x0001},             // Smallest denormal
+        {std::ldexp(1.0f, -25), 0x0000},             // Halfway to the smallest denormal, rounds to even zero
+        {std::ldexp(3.0f, -26), 0x0001},
+        {1.0f + std::ldexp(1.0f, -11), 0x3C00},      // Ties round to even
+        {1.0f + std::ldexp(3.0f, -11), 0x3C02}
+    };
+    for(unsigned int i=0; i < sizeof(cases) / sizeof(cases[0]); i++){
+        if(float_to_fp16(cases[i].value) != cases[i].half){
+            std::cout << "[ERROR] " << cases[i].value << " converted to FP16 0x" << std::hex << float_to_fp16(cases[i].value)
+                      << " instead of 0x" << cases[i].half << std::dec << "." << std::endl;
+            errors++;
+        }
+    }
+    uint16_t nan = float_to_fp16(std::numeric_limits<float>::quiet_NaN());
+    if((nan & 0x7C00) != 0x7C00 || (nan & 0x3FF) == 0 || !std::isnan(fp16_to_float(nan)) ||
+       !std::isnan(fp16_to_float(float_to_fp16(bits_to_float(0x7F800001))))){
+        std::cout << "[ERROR] NaN did not stay NaN in FP16." << std::endl;
+        errors++;
+    }
+
+    for(uint32_t half=0; half < 0x7C00; half++){
+        float value = fp16_to_float((uint16_t)half);
+        float negative = fp16_to_float((uint16_t)(half | 0x8000));
+        if(float_to_fp16(value) != half || float_to_fp16(negative) != (half | 0x8000) || negative != -value){
+            std::cout << "[ERROR] FP16 0x" << std::hex << half << std::dec << " does not convert back exactly." << std::endl;
+            return errors + 1;
+        }
+        if(half == 0x7BFF){
+            break;
+        }
+
+        // The midpoint to the next value is exact in float
+        float halfway = (value + fp16_to_float((uint16_t)(half + 1))) / 2.0f;
+        uint16_t even = (half & 1) ? half + 1 : half;
+        if(float_to_fp16(halfway) != even ||
+           float_to_fp16(std::nextafter(halfway, 0.0f)) != half ||
+           float_to_fp16(std::nextafter(halfway, INF)) != half + 1){
+            std::cout << "[ERROR] FP16 rounds wrongly between 0x" << std::hex << half << " and 0x" << half + 1
+                      << std::dec << "." << std::endl;
+            return errors + 1;
+        }
+    }
+    return errors;
+}
+
+/**
+ * @brief Checks the conversion of special values and of every value halfway between two bfloat16.
+ */
+static int check_bf16(){
+    int errors = 0;
+    const float INF = std::numeric_limits<float>::infinity();
+    struct { float value; uint16_t bfloat; } cases[] = {
+        {1.0f, 0x3F80}, {-2.0f, 0xC000}, {-0.0f, 0x8000}, {INF, 0x7F80}, {-INF, 0xFF80},
+        {std::numeric_limits<float>::max(), 0x7F80},  // Above the halfway point to infinity
+        {bits_to_float(0x00010000), 0x0001},          // Smallest denormal
+        {bits_to_float(0x00008000), 0x0000},          // Halfway, rounds to even zero
+        {bits_to_float(0x00018000), 0x0002},
+        {1.0f + std::ldexp(1.0f, -8), 0x3F80},        // Ties round to even
+        {1.0f + std::ldexp(3.0f, -8), 0x3F82}
+    };
+    for(unsigned int i=0; i < sizeof(cases) / sizeof(cases[0]); i++){
+        if(float_to_bf16(cases[i].value) != cases[i].bfloat){
+            std::cout << "[ERROR] " << cases[i].value << " converted to BF16 0x" << std::hex << float_to_bf16(cases[i].value)
+                      << " instead of 0x" << cases[i].bfloat << std::dec << "." << std::endl;
+            errors++;
+        }
+    }
+    // Only the lowest mantissa bit of this NaN is set, which truncating would turn into infinity
+    if(!std::isnan(bf16_to_float(float_to_bf16(bits_to_float(0x7F800001)))) ||
+       !std::isnan(bf16_to_float(float_to_bf16(std::numeric_limits<float>::quiet_NaN())))){
+        std::cout << "[ERROR] NaN did not stay NaN in BF16." << std::endl;
+        errors++;
+    }
+
+    for(uint32_t bfloat=0; bfloat < 0x7F80; bfloat++){
+        float value = bf16_to_float((uint16_t)bfloat);
+        if(float_to_bf16(value) != bfloat || float_to_bf16(-value) != (bfloat | 0x8000)){
+            std::cout << "[ERROR] BF16 0x" << std::hex << bfloat << std::dec << " does not convert back exactly." << std::endl;
+            return errors + 1;
+        }
+
+        float halfway = bits_to_float((bfloat << 16) | 0x8000);
+        uint16_t even = (bfloat & 1) ? bfloat + 1 : bfloat;
+        if(float_to_bf16(halfway) != even ||
+           float_to_bf16(std::nextafter(halfway, 0.0f)) != bfloat ||
+           float_to_bf16(std::nextafter(halfway, INF)) != bfloat + 1){
+            std::cout << "[ERROR] BF16 rounds wrongly between 0x" << std::hex << bfloat << " and 0x" << bfloat + 1
+                      << std::dec << "." << std::endl;
+            return errors + 1;
+        }
+    }
+    return errors;
+}
+
+/**
+ * @brief The weights of a habituating and sensitizing connection, stored in the given type.
+ */
+template<typename weight_type>
+struct LearningWeights{
+    weight_type short_weight;
+    weight_type long_weight;
+    weight_type base_weight;
+    weight_type long_learning_weight;
+};
+
+/**
+ * @brief Applies one learning step like Connection::apply_learning_batch() with LEARNING_HABISENS
+ *        and the parameters of the plasticity test, rounding every stored value like a connection does.
+ */
+template<typename weight_type>
+static void learn(LearningWeights<weight_type> &weights, int64_t steps, float activation){
+    const float MAX_WEIGHT = 10.0f;
+    const float MIN_WEIGHT = 0.0f;
+    const float HABITUATION_THRESHOLD = 2.0f;
+    const float SENSITIZATION_THRESHOLD = 5.0f;
+
+    weights.long_learning_weight = MathUtils::calculate_static_gradient(weights.long_learning_weight, 0.0006f, steps, 1.0f,
+                                                                        ADD, MAX_LONG_LEARNING_WEIGHT,
+                                                                        MIN_LONG_LEARNING_WEIGHT);
+    if(weights.long_weight < weights.base_weight){
+        weights.long_weight = MathUtils::calculate_static_gradient(weights.long_weight, 0.00001f, steps, 1.0f, ADD,
+                                                                   weights.base_weight, MIN_WEIGHT);
+    }
+    if(weights.short_weight < weights.long_weight){
+        weights.short_weight = MathUtils::calculate_static_gradient(weights.short_weight, 0.0005f, steps, 1.0f, ADD,
+                                                                    weights.long_weight, MIN_WEIGHT);
+    }
+    if(weights.long_weight > weights.base_weight){
+        weights.long_weight = MathUtils::calculate_static_gradient(weights.long_weight, 0.00001f, steps, 1.0f, SUBTRACT,
+                                                                   MAX_WEIGHT, weights.base_weight);
+    }
+    if(weights.short_weight > weights.long_weight){
+        weights.short_weight = MathUtils::calculate_static_gradient(weights.short_weight, 0.0005f, steps, 1.0f, SUBTRACT,
+                                                                    MAX_WEIGHT, weights.long_weight);
+    }
+
+    float step = 0.0f;
+    int method = ADD;
+    float short_curvature = 0.65f;
+    float long_curvature = 0.35f;
+    float long_steepness = 0.005f;
+    if(activation < HABITUATION_THRESHOLD){
+        step = HABITUATION_THRESHOLD - activation;
+        method = SUBTRACT;
+    }
+    else if(activation > SENSITIZATION_THRESHOLD){
+        step = activation - SENSITIZATION_THRESHOLD;
+        long_curvature = 1.02f;
+        long_steepness = 0.01f;
+    }
+    else{
+        return;
+    }
+    weights.short_weight = MathUtils::calculate_dynamic_gradient(weights.short_weight, 0.07f, step, short_curvature,
+                                                                 method, MAX_WEIGHT, MIN_WEIGHT);
+    weights.long_weight = MathUtils::calculate_dynamic_gradient(weights.long_weight, long_steepness,
+                                                                step * weights.long_learning_weight, long_curvature,
+                                                                method, MAX_WEIGHT, MIN_WEIGHT);
+    weights.long_learning_weight = MathUtils::calculate_static_gradient(weights.long_learning_weight, 0.05f, 1, 0.5f,
+                                                                        SUBTRACT, MAX_LONG_LEARNING_WEIGHT,
+                                                                        MIN_LONG_LEARNING_WEIGHT);
+}
+
+/**
+ * @brief Runs the same learning with 16 bit weights and with float weights and measures how far they drift apart.
+ *
+ * Short weights drift by a few units in the last place. The decays of long weights are smaller than half a unit
+ * in the last place of 16 bit weights and get lost, so long weights drift much further. The budgets are slightly
+ * above the measured drift, so any change of the rounding shows up.
+ *
+ * @return    The number of weights whose drift exceeds its budget.
+ */
+template<typename weight_type>
+static int check_drift(const char *name, float short_budget, float long_budget){
+    LearningWeights<float> reference = {1.0f, 1.0f, 1.0f, 1.0f};
+    LearningWeights<weight_type> compact;
+    compact.short_weight = 1.0f;
+    compact.long_weight = 1.0f;
+    compact.base_weight = 1.0f;
+    compact.long_learning_weight = 1.0f;
+
+    float short_drift = 0.0f;
+    float long_drift = 0.0f;
+    int64_t last_fired = 0;
+    for(int step=1; step <= STEP_NUMBER; step++){
+        float activation = PATTERN[(step * 7 + step / 13) % PATTERN_LENGTH];
+        if(activation == 0.0f){
+            continue;
+        }
+        learn(reference, step - last_fired, activation);
+        learn(compact, step - last_fired, activation);
+        last_fired = step;
+        short_drift = std::max(short_drift, std::fabs((float)compact.short_weight - reference.short_weight));
+        long_drift = std::max(long_drift, std::fabs((float)compact.long_weight - reference.long_weight));
+    }
+
+    std::cout << name << " short weight drifts at most " << short_drift << " from float, ends at "
+              << (float)compact.short_weight << " instead of " << reference.short_weight << "." << std::endl;
+    std::cout << name << " long weight drifts at most " << long_drift << " from float, ends at "
+              << (float)compact.long_weight << " instead of " << reference.long_weight << "." << std::endl;
+    int errors = 0;
+    if(!(short_drift <= short_budget)){
+        std::cout << "[ERROR] " << name << " short weight drift exceeds " << short_budget << "." << std::endl;
+        errors++;
+    }
+    if(!(long_drift <= long_budget)){
+        std::cout << "[ERROR] " << name << " long weight drift exceeds " << long_budget << "." << std::endl;
+        errors++;
+    }
+    return errors;
+}
+
+int main(){
+    int errors = 0;
+
+    errors += check_fp16();
+    errors += check_bf16();
+    errors += check_drift<fp16_weight>("FP16", 0.04f, 0.25f);
+    errors += check_drift<bf16_weight>("BF16", 0.25f, 0.9f);
+
+    if(errors == 0){
+        std::cout << "Weight storage works." << std::endl;
+    }
+    return errors;
+}